@@ -43,6 +43,9 @@
 #include "linbox/matrix/polynomial-matrix.h"
 
 #include "linbox/util/timer.h"
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
 
 //  #define  __CHECK_RESULT
 //  #define __DEBUG_MAPLE
@@ -56,6 +59,16 @@
 
 //#define _BM_TIMING
 #define DEFAULT_BLOCK_EARLY_TERM_THRESHOLD 10
+// under OpenMP, number of field operations from which the discrepancy and
+// the sigma base update of the iterative M-Basis are shared among threads
+#ifndef BM_PARALLEL_THRESHOLD
+#define BM_PARALLEL_THRESHOLD 65536
+#endif
+// minimal sequence length for which masseyblock_left_rec measures its
+// M-Basis/PM-Basis crossover, when asked to by tuneCrossover()
+#ifndef BM_TUNE_LENGTH
+#define BM_TUNE_LENGTH 512
+#endif
 
 namespace LinBox
 {
@@ -110,6 +123,7 @@ namespace LinBox
 		BlasMatrixDomain<Field>                  _BMD;
 		MatrixDomain<Field>                       _MD;
 		size_t            EARLY_TERM_THRESHOLD;
+		bool                      _tune_crossover;
 
 
 	public:
@@ -191,7 +205,7 @@ namespace LinBox
 
 		BlockMasseyDomain (const BlockMasseyDomain<Field, Sequence> &Mat, size_t ett_default = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
 			_container(Mat._container), _field(Mat._field), _BMD(Mat.field()),
-			_MD(Mat.field()),  EARLY_TERM_THRESHOLD (ett_default)
+			_MD(Mat.field()),  EARLY_TERM_THRESHOLD (ett_default), _tune_crossover(Mat._tune_crossover)
 		{
 #ifdef _BM_TIMING
 			clearTimer();
@@ -200,7 +214,7 @@ namespace LinBox
 		}
 
 		BlockMasseyDomain (Sequence *D, size_t ett_default = DEFAULT_BLOCK_EARLY_TERM_THRESHOLD) :
-			_container(D), _field(&(D->field ())), _BMD(D->field ()), _MD(D->field ()), EARLY_TERM_THRESHOLD (ett_default)
+			_container(D), _field(&(D->field ())), _BMD(D->field ()), _MD(D->field ()), EARLY_TERM_THRESHOLD (ett_default), _tune_crossover(false)
 		{
 #ifdef _BM_TIMING
 			clearTimer();
@@ -243,10 +257,40 @@ namespace LinBox
 		// right minimal generating polynomial of the sequence
 		void right_minpoly (std::vector<Coefficient> &P) { masseyblock_right(P);}
 
+		// let left_minpoly_rec measure the M-Basis/PM-Basis crossover (cached per
+		// field and dimensions) instead of using MBASIS_THRESHOLD
+		void tuneCrossover (bool b = true) { _tune_crossover = b; }
+
 
 	private:
 
+		// op(beg,end) on strips covering [0,total), each at least grain
+		// long, which are shared among the threads when work is large
+		template<class Op>
+		void parallel_strips(size_t total, size_t grain, size_t work, Op& op) const
+		{
+#ifdef __LINBOX_USE_OPENMP
+			size_t nt = std::min((size_t)omp_get_max_threads(), total/std::max(grain,(size_t)1));
+			if (nt > 1 && work >= BM_PARALLEL_THRESHOLD && !omp_in_parallel()) {
+#pragma omp parallel for schedule(static)
+				for (size_t t=0;t<nt;t++)
+					op(t*total/nt,(t+1)*total/nt);
+				return;
+			}
+#endif
+			op(0,total);
+		}
 
+		// the coefficients of a sigma base stored as [ Sigma_0 | Sigma_1 | ... ]
+		std::vector<Coefficient> sigma_coefficients(const Coefficient& Sigma, size_t size, size_t m) const
+		{
+			std::vector<Coefficient> SigmaBase(size, Coefficient(field(),Sigma.rowdim(),m));
+			for (size_t l=0;l<size;l++)
+				for (size_t i=0;i<Sigma.rowdim();i++)
+					for (size_t k=0;k<m;k++)
+						field().assign(SigmaBase[l].refEntry(i,k), Sigma.getEntry(i,l*m+k));
+			return SigmaBase;
+		}
 
 		std::vector<size_t> masseyblock_left (std::vector<Coefficient> &P)
 		{
@@ -263,16 +307,15 @@ namespace LinBox
 			// Initialization of the sequence iterator
 			typename Sequence::const_iterator _iter (_container->begin ());
 
-			// Reservation of memory for the entire sequence
-            const Coefficient Zeromn(field(),m,n);
-			std::vector<Coefficient> S (length,Zeromn);
-
-
-			Coefficient Unit(field(),m+n,m);
-			const Coefficient Zero(field(),m+n,m);
+			// Reservation of memory for the entire sequence, stored in
+			// reverse order in one matrix so that S[NN], S[NN-1], ... are
+			// consecutive row blocks of Serie
+			Coefficient Serie(field(),length*m,n);
+			std::vector<CoeffView> S;
+			S.reserve(length);
+			for (size_t k=0;k<length;k++)
+				S.emplace_back(Serie,(length-1-k)*m,0,m,n);
 
-			for (size_t i=0;i<m;i++)
-				Unit.setEntry(i,i,field().one);
 			size_t min_mn=(m <n)? m :n;
 
 			// initialization of discrepancy
@@ -280,8 +323,13 @@ namespace LinBox
 			for (size_t i=0;i<n;i++)
 				Discrepancy.setEntry(i+m,i,field().one);
 
-			// initialization of sigma base
-			std::vector<Coefficient> SigmaBase(1, Unit);
+			// initialization of sigma base, its coefficients being stored
+			// side by side in Sigma as [ Sigma_0 | Sigma_1 | ... ] so that
+			// the discrepancy is one product and the updates act in place
+			size_t size=1, capacity=std::min(length+1,(size_t)16);
+			Coefficient Sigma(field(),m+n,m*capacity);
+			for (size_t i=0;i<m;i++)
+				Sigma.setEntry(i,i,field().one);
 
 			// initialization of order of sigma base's rows
 			std::vector<long> order(m+n,1);
@@ -305,23 +353,25 @@ namespace LinBox
 			for (NN = 0; (NN < (long)length) && (early_stop < EARLY_TERM_THRESHOLD) ; ++NN, ++_iter) {
 
 				// Get the next coefficient in the sequence
-				S[NN]=*_iter;
+				const Coefficient& Snew= *_iter;
+				for (size_t i=0;i<m;i++)
+					for (size_t j=0;j<n;j++)
+						field().assign(S[NN].refEntry(i,j), Snew.getEntry(i,j));
 
 				/*
 				 * Compute the new discrepancy (just updating the first m rows)
+				 * sum_i SigmaBase[i].S[NN-i] = [ SigmaBase[0] .. SigmaBase[size-1] ].[ S[NN] .. S[NN-size+1] ]^T
+				 * as one product, whose rows are shared among the threads
 				 */
-				// view of m first rows of SigmaBasis[0]
-				CoeffView Sigma(SigmaBase[0],0,0,m,m);
-
 				// view of m first rows of Discrepancy
 				CoeffView Discr(Discrepancy,0,0,m,n);
-
-				_BMD.mul(Discr,Sigma,S[NN]);
-
-				for (size_t i=1;i<SigmaBase.size();i++){
-					CoeffView  Sigmaview(SigmaBase[i],0,0,m,m);
-					_BMD.axpyin(Discr,Sigmaview,S[NN-i]);
-				}
+				CoeffView Window(Serie,(length-1-NN)*m,0,m*size,n);
+				auto discrepancy = [&](size_t beg, size_t end){
+					CoeffView D(Discrepancy,beg,0,end-beg,n);
+					CoeffView SigmaTop(Sigma,beg,0,end-beg,m*size);
+					_BMD.mul(D,SigmaTop,Window);
+				};
+				parallel_strips(m, 8, m*m*n*size, discrepancy);
 
 				typename CoeffView::Iterator _iter_Discr = Discr.Begin();
 				while (_iter_Discr != Discr.End() && (field().isZero(*_iter_Discr)))
@@ -404,12 +454,15 @@ namespace LinBox
 
 #endif
 				// SigmaBase =  BPerm2.Qt. L^(-1) . BPerm1 . SigmaBase
-				for (size_t i=0;i<SigmaBase.size();i++) {
-					_BMD.mulin_right(BPerm1,SigmaBase[i]);
-					_BMD.mulin_right(invL,SigmaBase[i]);
-					_BMD.mulin_right(Qt,SigmaBase[i]);
-					_BMD.mulin_right(BPerm2,SigmaBase[i]);
-				}
+				// in place on all the coefficients at once, by column strips
+				auto update = [&](size_t beg, size_t end){
+					CoeffView SigmaStrip(Sigma,0,beg,m+n,end-beg);
+					_BMD.mulin_right(BPerm1,SigmaStrip);
+					_BMD.mulin_right(invL,SigmaStrip);
+					_BMD.mulin_right(Qt,SigmaStrip);
+					_BMD.mulin_right(BPerm2,SigmaStrip);
+				};
+				parallel_strips(m*size, 32, (m+n)*(m+n)*m*size, update);
 
 				// Apply BPerm2 and Qt to the vector of order and increase by 1 the last n rows
 				Givaro::ZRing<long> UF(0);
@@ -431,28 +484,30 @@ namespace LinBox
 					if (degree[i]>max_degree)
 						max_degree=degree[i];
 				}
-				size_t size=SigmaBase.size();
-				if (SigmaBase.size()<= (size_t)max_degree)
+				if (size<= (size_t)max_degree)
                     {
-                        SigmaBase.resize(size+1,Zero);
-                        //report << size << std::endl;
+                        if (size == capacity) {
+                            // double the room for the coefficients
+                            capacity=std::min(2*capacity,length+1);
+                            Coefficient Larger(field(),m+n,m*capacity);
+                            for (size_t i=0;i<m+n;i++)
+                                std::copy(Sigma.getPointer()+i*Sigma.getStride(),
+                                          Sigma.getPointer()+i*Sigma.getStride()+m*size,
+                                          Larger.getPointer()+i*Larger.getStride());
+                            Sigma=Larger;
+                        }
                         size++;
                     }
-				//report << "size going in" << size << std::endl;
-				for (int i= (int)size-2;i>=0;i--)
-					for (size_t j=0;j<n;j++)
-						for (size_t k=0;k<n;++k){
-							field().assign(SigmaBase[i+1].refEntry(m+j,k), SigmaBase[i].getEntry(m+j,k));
-
-						}
-
-				for (size_t j=0;j<n;j++)
-					for (size_t k=0;k<n;++k)
-						field().assign(SigmaBase[0].refEntry(m+j,k),field().zero);
+				// each of the last n rows is shifted by one coefficient
+				for (size_t j=m;j<m+n;j++){
+					typename Field::Element_ptr row=Sigma.getPointer()+j*Sigma.getStride();
+					std::copy_backward(row, row+m*(size-1), row+m*size);
+					std::fill(row, row+m, field().zero);
+				}
 
 #ifdef __DEBUG_MAPLE
 				report<<"\n\nSigmaBase"<<NN<<":= ";
-				write_maple(field(),SigmaBase);
+				write_maple(field(),sigma_coefficients(Sigma,size,m));
 
 				report<<"order"<<NN<<":=<";
 				for (size_t i=0;i<m+n;++i){
@@ -470,6 +525,7 @@ namespace LinBox
 #endif
 
 #ifdef __CHECK_LOOP
+				std::vector<Coefficient> SigmaBase(sigma_coefficients(Sigma,size,m));
 				report<<"\nCheck validity of current SigmaBase\n";
 				report<<"SigmaBase size: "<<SigmaBase.size()<<std::endl;
 				report<<"Sequence size:  "<<NN+1<<std::endl;
@@ -503,6 +559,7 @@ namespace LinBox
 
 
 #ifdef __CHECK_SIGMA_RESULT
+			std::vector<Coefficient> SigmaBase(sigma_coefficients(Sigma,size,m));
 			report<<"Check SigmaBase application\n";
 			for (size_t i=SigmaBase.size()-1 ;i< length ;++i){
 				Coefficient res(field(),m+n,n);
@@ -522,7 +579,7 @@ namespace LinBox
 			for (size_t i=0;i<m;i++)
 				for (long j=0;j<=degree[i];j++)
 					for (size_t k=0;k<m;k++)
-						field().assign(P[degree[i]-j].refEntry(i,k), SigmaBase[j].getEntry(i,k));
+						field().assign(P[degree[i]-j].refEntry(i,k), Sigma.getEntry(i,j*m+k));
 #ifdef __CHECK_RESULT
 			report<<"Check minimal polynomial application\n";
 			bool valid=true;
@@ -602,6 +659,8 @@ namespace LinBox
 
 			// Compute OrderBasis up to the order length 
             OrderBasis<Field> SB(field());
+            if (_tune_crossover && length >= BM_TUNE_LENGTH)
+                SB.tuneThreshold(mn, n, length>>3);
             SB.PM_Basis(SigmaBase, PowerSerie, length, shift);
 
 
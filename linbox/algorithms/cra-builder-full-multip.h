@@ -37,6 +37,7 @@
 #include "linbox/vector/blas-vector.h"
 #include <utility>
 
+#include "linbox/solutions/constants.h"
 #include "linbox/algorithms/lazy-product.h"
 
 namespace LinBox
@@ -55,6 +56,12 @@ namespace LinBox
      * shelf according to log2(log(modulus)), as computed by the getShelf() helper.
      * When two residues belong on the same shelf, they are combined and re-assigned
      * to another shelf, recursively.
+     *
+     * Residues given modulo a word-size Domain are first buffered, by batches of
+     * \c batchSize() primes. A full batch is reconstructed at once, entry by entry,
+     * along a subproduct tree of its primes (fast CRT), and the resulting
+     * residue is then placed on its shelf as above. The modulus size, hence
+     * terminated(), is updated without waiting for the batch to be complete.
 	 */
 	template<class Domain_Type>
 	struct CRABuilderFullMultip {
@@ -80,6 +87,9 @@ namespace LinBox
         size_t dimension_ = 0; // dimension of the vector being reconstructed
         bool collapsed_ = false;
         bool normalized_ = false;
+        size_t batchSize_; // number of residues reconstructed at once
+        std::vector<Domain> pendingDomains_; // buffered, not yet on a shelf
+        std::vector<std::vector<DomainElement> > pendingResidues_;
         // INVARIANT: shelves_.empty() || shelves_.back().occupied
         // INVARIANT: forall (shelf : shelves_) { shelf.residue.size() == dimension_ }
 
@@ -87,13 +97,29 @@ namespace LinBox
         /** @brief Creates a new vector CRA object.
          * @param bnd  upper bound on the natural logarithm of the result
          * @param dim  dimension of the vector to be reconstructed
+         * @param batch  number of residues buffered before a subproduct
+         * tree reconstruction; 1 folds each residue as soon as it arrives
          */
-		CRABuilderFullMultip(const double bnd=0.0, size_t dim=0) :
-			LOGARITHMIC_UPPER_BOUND(bnd), dimension_(dim)
+		CRABuilderFullMultip(const double bnd=0.0, size_t dim=0,
+                             size_t batch=LINBOX_DEFAULT_CRA_BATCH_SIZE) :
+			LOGARITHMIC_UPPER_BOUND(bnd), dimension_(dim), batchSize_(std::max(batch,(size_t)1))
 		{}
 
+        size_t batchSize() const
+        { return batchSize_; }
+
+        /** @brief Changes the number of residues reconstructed at once.
+         * Residues already buffered are reconstructed first.
+         */
+        void setBatchSize(size_t batch)
+        {
+            flushPending();
+            batchSize_ = std::max(batch,(size_t)1);
+        }
+
 		Integer& getModulus(Integer& m) const
 		{
+            flushPending();
             if (shelves_.empty()) return m = 1;
             collapse();
             return m = shelves_.back().mod();
@@ -115,6 +141,8 @@ namespace LinBox
         inline void initialize_iter (const ModType& D, Iter e_it, size_t e_size)
         {
             shelves_.clear();
+            pendingDomains_.clear();
+            pendingResidues_.clear();
             totalsize_ = 0;
             dimension_ = e_size;
             progress_iter(D, e_it, e_size);
@@ -138,6 +166,40 @@ namespace LinBox
 
         template <typename ModType, class Iter>
         void progress_iter (const ModType& D, Iter e_it, size_t e_size) {
+            if (batchSize_ > 1 && buffer_iter(D, e_it, e_size)) return;
+            fold_iter(D, e_it, e_size);
+        }
+
+	protected:
+        /** @brief Puts the residue aside until a whole batch is available.
+         * @return true iff the residue was buffered.
+         */
+        template <class Iter>
+        bool buffer_iter (const Domain& D, Iter e_it, size_t e_size) {
+            collapsed_ = false;
+            normalized_ = false;
+            totalsize_ += Givaro::logtwo(mod_to_integer(D));
+
+            pendingDomains_.push_back(D);
+            pendingResidues_.emplace_back(e_size);
+            std::copy_n(e_it, e_size, pendingResidues_.back().begin());
+
+            if (pendingDomains_.size() >= batchSize_) flushPending();
+            return true;
+        }
+
+        /** @brief Residues modulo an integer are not buffered,
+         * but pending ones must be folded before them.
+         */
+        template <typename ModType, class Iter>
+        bool buffer_iter (const ModType&, Iter, size_t) {
+            flushPending();
+            return false;
+        }
+
+        /// Folds one residue directly into the shelves.
+        template <typename ModType, class Iter>
+        void fold_iter (const ModType& D, Iter e_it, size_t e_size) {
             // update collapsed_ and normalized_
             collapsed_ = shelves_.empty();
             normalized_ = false;
@@ -176,8 +238,14 @@ namespace LinBox
                 shelves_[cur].count += 1;
             }
 
-            // combine further shelves as necessary
-            decltype(cur) next;
+            settleShelf(cur);
+		}
+
+        /** @brief Moves up the shelf at index cur, combining it
+         * with the occupied shelves it meets, until it is at its place.
+         */
+        void settleShelf (size_t cur) {
+            size_t next;
             while ((next = getShelf(shelves_[cur].logmod)) != cur) {
                 ensureShelf(next, shelves_, dimension_);
                 if (shelves_[next].occupied) {
@@ -191,8 +259,93 @@ namespace LinBox
 
                 cur = next;
             }
-		}
+        }
+
+        /** @brief Reconstructs the buffered residues and puts the result on its shelf.
+         *
+         * For primes p_1..p_k of product M, with weights
+         * c_i = (M/p_i)^{-1} mod p_i, each entry is the sum of
+         * (u_i c_i mod p_i) M/p_i, evaluated bottom-up along the subproduct
+         * tree of the primes: a node holds V_L M_R + V_R M_L.
+         * The weights cost O(k^2) word operations, shared by the whole vector.
+         */
+        void flushPending() const {
+            if (pendingDomains_.empty()) return;
+            auto& self = const_cast<Self_t&>(*this);
+            const size_t k = pendingDomains_.size();
+
+            // subproduct tree of the primes, tree.back()[0] is their product
+            std::vector<std::vector<Integer> > tree(1, std::vector<Integer>(k));
+            double logM = 0.;
+            for (size_t i=0; i < k; ++i) {
+                pendingDomains_[i].characteristic(tree[0][i]);
+                logM += Givaro::naturallog(tree[0][i]);
+            }
+            while (tree.back().size() > 1) {
+                size_t len = tree.back().size();
+                std::vector<Integer> above((len+1)/2);
+                for (size_t l=0; l+1 < len; l+=2)
+                    Integer::mul(above[l/2], tree.back()[l], tree.back()[l+1]);
+                if (len & 1) above.back() = tree.back().back();
+                tree.push_back(std::move(above));
+            }
+
+            // CRT weights
+            std::vector<DomainElement> weights(k);
+            for (size_t i=0; i < k; ++i) {
+                const Domain& Di = pendingDomains_[i];
+                DomainElement pj;
+                Di.assign(weights[i], Di.one);
+                for (size_t j=0; j < k; ++j)
+                    if (j != i) Di.mulin(weights[i], Di.init(pj, tree[0][j]));
+                Di.invin(weights[i]);
+            }
+
+            Shelf batch(dimension_);
+            std::vector<Integer> values(k);
+            Integer tmp;
+            DomainElement x;
+            for (size_t e=0; e < dimension_; ++e) {
+                for (size_t i=0; i < k; ++i) {
+                    const Domain& Di = pendingDomains_[i];
+                    // a shorter residue has zeros as its missing values
+                    if (e < pendingResidues_[i].size())
+                        Di.mul(x, pendingResidues_[i][e], weights[i]);
+                    else
+                        Di.assign(x, Di.zero);
+                    Di.convert(values[i], x);
+                }
+                for (size_t h=0; h+1 < tree.size(); ++h) {
+                    size_t len = tree[h].size();
+                    for (size_t l=0; l+1 < len; l+=2) {
+                        Integer::mul(tmp, values[l], tree[h][l+1]);
+                        Integer::axpyin(tmp, values[l+1], tree[h][l]);
+                        values[l/2] = tmp;
+                    }
+                    if (len & 1) values[len/2] = values[len-1];
+                }
+                Integer::modin(values[0], tree.back()[0]);
+                std::swap(batch.residue[e], values[0]);
+            }
+            batch.mod.initialize(tree.back()[0]);
+            batch.logmod = logM;
+            batch.count = (int)k;
+            batch.occupied = true;
+
+            self.pendingDomains_.clear();
+            self.pendingResidues_.clear();
+
+            // put the batch on its shelf, as a single residue would be
+            auto cur = getShelf(logM);
+            ensureShelf(cur, self.shelves_, dimension_);
+            if (! shelves_[cur].occupied)
+                std::swap(self.shelves_[cur], batch);
+            else
+                combineShelves(self.shelves_[cur], batch);
+            self.settleShelf(cur);
+        }
 
+	public:
 		//! result
 		inline const std::vector<Integer>& result (bool normalized=true) const
 		{
@@ -210,6 +363,7 @@ namespace LinBox
 
         template <class Iter>
         void result_iter (Iter r_it, bool normalized=true) const {
+            flushPending();
             if (shelves_.empty()) {
                 for (size_t i=0; i < dimension_; ++i)
                     *r_it = 0;
@@ -243,6 +397,10 @@ namespace LinBox
             for (auto& shelf : shelves_) {
                 if (shelf.occupied && shelf.mod.noncoprime(i)) return true;
             }
+            Integer g;
+            for (auto& D : pendingDomains_) {
+                if (gcd(g, i, mod_to_integer(D)) > 1) return true;
+            }
             return false;
 		}
 
@@ -251,6 +409,7 @@ namespace LinBox
 
         // XXX iterator invalidated by many other method calls
         decltype(shelves_.crbegin()) shelves_begin() const {
+            flushPending();
             return shelves_.rbegin();
         }
 
@@ -316,6 +475,7 @@ namespace LinBox
          */
         void collapse() const {
             if (collapsed_) return;
+            flushPending();
             auto& ncshelves = const_cast<std::vector<Shelf>&>(shelves_);
             if (ncshelves.empty()) {
                 ncshelves.emplace_back(dimension_);
@@ -432,6 +432,20 @@ namespace LinBox
 				occurency_ ++;
 		}
 
+		/** @brief As progress, \p D being the product of \p count primes.
+		 *
+		 * The reconstruction is unchanged modulo \p D iff it is modulo
+		 * each of the primes, so that they all count towards termination.
+		 */
+		template <typename ResType>
+		void progress (const Integer& D, const ResType& e, size_t count)
+		{
+			if (Base::progress_check(D,e))
+				occurency_ = 1;
+			else
+				occurency_ += (unsigned int)count;
+		}
+
 		/** @brief Checks whether the CRA is (heuristically) finished.
 		 *
 		 * @return true iff the early termination condition has been reached.
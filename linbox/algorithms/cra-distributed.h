@@ -26,11 +26,21 @@
 
 #pragma once
 
+#ifdef __LINBOX_USE_OPENMP
+// combined workers run the iterations of a batch in threads and the
+// commentator is not thread safe
+#ifndef DISABLE_COMMENTATOR
+#define DISABLE_COMMENTATOR
+#endif
+#include <omp.h>
+#endif
+
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "linbox/algorithms/cra-domain.h"
+#include "linbox/algorithms/cra-builder-full-multip.h"
 #include "linbox/algorithms/rational-cra.h"
 #include "linbox/algorithms/rational-cra-var-prec.h"
 #include "linbox/integer.h"
@@ -43,29 +53,49 @@
 
 namespace LinBox {
 
+    /** \brief Master/worker distributed \ref CRA.
+     *
+     * The master (rank 0) only combines residues: it draws the primes
+     * and hands them out by batches, keeping each worker one batch ahead
+     * so that no worker waits for new primes. Workers stream each residue
+     * back with a non-blocking send while they compute the next one.
+     * As soon as the builder has terminated, the master tells every worker
+     * to stop, then drains the residues still in flight.
+     *
+     * In combined mode (see ChineseRemainderCombined), a worker rather
+     * computes a whole batch with its OpenMP threads and sends back the
+     * partial reconstruction of the batch, modulo the product of its primes.
+     *
+     * Messages, all between the master and one worker:
+     * - Primes:  master -> worker, a batch of primes (uint64_t),
+     * - Residue: worker -> master, a prime followed by its residue,
+     * - Partial: worker -> master, the number of primes of the batch,
+     *            followed by their product and the partial reconstruction,
+     * - Skip:    worker -> master, a prime the iteration rejected,
+     * - Stop:    master -> worker, no more work needed,
+     * - Done:    worker -> master, last message of the worker.
+     */
     template <class CRABase>
     struct ChineseRemainderDistributed {
         using Domain = typename CRABase::Domain;
 
-        // @note This causes the algorithm to give wrong answer sometimes...
-        // using MaskedPrimeGenerator = MaskedPrimeIterator<IteratorCategories::HeuristicTag>;
-        using MaskedPrimeGenerator = MaskedPrimeIterator<IteratorCategories::DeterministicTag>;
+        enum Tag : int { Primes = 1, Residue, ResidueValue, Partial, PartialModulus, PartialValue, Skip, Stop, Done };
 
     protected:
         CRABase Builder_;
         Communicator* _pCommunicator;
         double _hadamardLogBound;
-        double _workerHadamardLogBound = 0.0; //!< Each worker will compute primes until this is hit.
+        size_t _batchSize; //!< Number of primes handed out at once to a worker.
+        bool _combined;    //!< Whether workers send partial reconstructions of their batches.
 
     public:
-        ChineseRemainderDistributed(double b, Communicator* c)
+        ChineseRemainderDistributed(double b, Communicator* c, size_t batchSize = 4, bool combined = false)
             : Builder_(b)
             , _pCommunicator(c)
             , _hadamardLogBound(b)
+            , _batchSize(batchSize > 0 ? batchSize : 1)
+            , _combined(combined)
         {
-            if (c && c->size() > 1) {
-                _workerHadamardLogBound = _hadamardLogBound / (c->size() - 1);
-            }
         }
 
         /** \brief The CRA loop.
@@ -77,9 +107,11 @@ namespace LinBox {
          * returning the coefficients of the minimal polynomial of a
          * matrix \c mod \p p.
          *
-         * @warning  we won't detect bad primes.
+         * @warning  we won't detect bad primes,
+         * IterationResult::RESTART is handled as IterationResult::CONTINUE.
          *
-         * \param primeGenerator  RandIter object for generating primes.
+         * \param primeGenerator  RandIter object for generating primes,
+         * only used by the master.
          * \param[out] res an integer
          */
         template <class Vect, class Function, class PrimeIterator>
@@ -122,14 +154,16 @@ namespace LinBox {
 
         template <class Any, class Function, class PrimeIterator>
         void para_compute(Any& res, Function& Iteration, PrimeIterator& primeGenerator) {
-            Domain D(*primeGenerator);
             typename Domain::Element r;
+            Integer partial;
 
             if (_pCommunicator->master()) {
-                master_process_task(Iteration, D, r);
+                Domain D(*primeGenerator);
+                D.init(r);
+                master_process_task(primeGenerator, r, partial);
             }
             else {
-                worker_process_task(Iteration, r);
+                worker_process_task(Iteration, r, partial);
             }
         }
 
@@ -138,72 +172,309 @@ namespace LinBox {
         {
             Domain D(*primeGenerator);
             BlasVector<Domain> r(D);
+            Givaro::ZRing<Integer> ZZ;
+            BlasVector<Givaro::ZRing<Integer>> partial(ZZ);
 
             if (_pCommunicator->master()) {
-                master_process_task(Iteration, D, r);
+                master_process_task(primeGenerator, r, partial);
             }
             else {
-                worker_process_task(Iteration, r);
+                worker_process_task(Iteration, r, partial);
             }
         }
 
-        template <class Any, class PrimeIterator, class Function>
-        void worker_compute(PrimeIterator& gen, Function& Iteration, Any& r)
+        /** \brief Computes the residues for the primes handed out by the master,
+         * until told to stop.
+         */
+        template <class Any, class Partial, class Function>
+        void worker_process_task(Function& Iteration, Any& r, Partial& partial)
         {
-            // Process mutual independent prime number generation
-            ++gen;
-            while (Builder_.noncoprime(*gen)) {
-                ++gen;
+            Communicator::Request primeRequest, residueRequest;
+            std::vector<uint64_t> batch;
+            bool stopped = false;
+
+            // Probing any tag keeps the order in which the master sent the messages,
+            // so that every batch is received before the stop message.
+            while (true) {
+                uint64_t length = _pCommunicator->probe(0, MPI_ANY_TAG);
+                if (_pCommunicator->status().MPI_TAG == Tag::Stop) {
+                    break;
+                }
+                batch.resize(length / sizeof(uint64_t));
+                _pCommunicator->recv(batch.data(), batch.data() + batch.size(), 0, Tag::Primes);
+                if (stopped) {
+                    // Not started, discarded
+                    continue;
+                }
+
+                if (_combined) {
+                    if (_pCommunicator->iprobe(0, Tag::Stop)) {
+                        stopped = true;
+                        continue;
+                    }
+                    uint64_t count = batch.size();
+                    Integer modulus;
+                    worker_compute_batch(modulus, partial, batch, Iteration, r);
+                    _pCommunicator->send(count, 0, Tag::Partial);
+                    _pCommunicator->send(modulus, 0, Tag::PartialModulus);
+                    _pCommunicator->send(partial, 0, Tag::PartialValue);
+                    continue;
+                }
+
+                for (auto p : batch) {
+                    if (_pCommunicator->iprobe(0, Tag::Stop)) {
+                        stopped = true;
+                        break;
+                    }
+
+                    Domain D(p);
+                    if (isSkipped(Iteration(r, D))) {
+                        _pCommunicator->isend(p, 0, primeRequest, Tag::Skip);
+                        continue;
+                    }
+
+                    // Sent while the next residue is computed
+                    _pCommunicator->isend(p, 0, primeRequest, Tag::Residue);
+                    _pCommunicator->isend(r, 0, residueRequest, Tag::ResidueValue);
+                }
             }
 
-            Domain D(*gen);
-            Iteration(r, D);
+            uint64_t poisonPill = 0;
+            _pCommunicator->recv(poisonPill, 0, Tag::Stop);
+
+            _pCommunicator->wait(primeRequest);
+            _pCommunicator->wait(residueRequest);
+            _pCommunicator->send(poisonPill, 0, Tag::Done);
         }
 
-        template <class Any, class Function>
-        void worker_process_task(Function& Iteration, Any& r)
+        /** \brief Computes the residues of a batch with all threads,
+         * and combines them into a partial reconstruction.
+         *
+         * Skipped primes are left out of the modulus;
+         * if all of them are skipped, the modulus is 1.
+         */
+        template <class Partial, class Function, class Any>
+        void worker_compute_batch(Integer& modulus, Partial& partial, const std::vector<uint64_t>& batch,
+                                  Function& Iteration, const Any& r)
         {
-            MaskedPrimeGenerator gen(_pCommunicator->rank() - 1, _pCommunicator->size() - 1);
+            std::vector<Domain> domains;
+            std::vector<Any> residues;
+            domains.reserve(batch.size());
+            residues.reserve(batch.size());
+            for (auto p : batch) {
+                domains.emplace_back(p);
+                residues.push_back(createResidue(domains.back(), r));
+            }
 
-            // Each worker will work until _workerHadamardLogBound is hit
-            double primesLogSum = 0.0;
-            while (primesLogSum < _workerHadamardLogBound) {
-                worker_compute(gen, Iteration, r);
+            std::vector<char> skipped(batch.size());
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+            for (size_t i = 0; i < batch.size(); ++i) {
+                skipped[i] = isSkipped(Iteration(residues[i], domains[i]));
+            }
 
-                uint64_t p = *gen;
-                primesLogSum += Givaro::logtwo(p);
-                _pCommunicator->send(p, 0);
-                _pCommunicator->send(r, 0);
+            CRABuilderFullMultip<Domain> local(0.0);
+            bool initialized = false;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (skipped[i]) continue;
+                if (initialized) {
+                    local.progress(domains[i], wrapResidue(residues[i]));
+                }
+                else {
+                    local.initialize(domains[i], wrapResidue(residues[i]));
+                    initialized = true;
+                }
             }
 
-            uint64_t poisonPill = 0;
-            _pCommunicator->send(poisonPill, 0);
+            local.getModulus(modulus);
+            unwrapResult(partial, local);
+        }
+
+        // Iterations of the integer CRA return an IterationResult,
+        // those of the rational CRA (e.g. CRASolveIteration) the residue.
+        static bool isSkipped(IterationResult result) { return result == IterationResult::SKIP; }
+
+        template <class Residue>
+        static bool isSkipped(const Residue&) { return false; }
+
+        static typename Domain::Element createResidue(const Domain& D, const typename Domain::Element&)
+        {
+            typename Domain::Element e;
+            D.init(e);
+            return e;
+        }
+
+        static BlasVector<Domain> createResidue(const Domain& D, const BlasVector<Domain>&)
+        {
+            return BlasVector<Domain>(D);
+        }
+
+        // The local builder only reconstructs vectors
+        static std::vector<typename Domain::Element> wrapResidue(const typename Domain::Element& e)
+        {
+            return std::vector<typename Domain::Element>(1, e);
         }
 
-        template <class Any, class Function>
-        void master_process_task(Function& Iteration, Domain& D, Any& r)
+        static const BlasVector<Domain>& wrapResidue(const BlasVector<Domain>& e) { return e; }
+
+        static void unwrapResult(Integer& partial, const CRABuilderFullMultip<Domain>& local)
+        {
+            std::vector<Integer> v(1);
+            local.result(v);
+            partial = v[0];
+        }
+
+        static void unwrapResult(BlasVector<Givaro::ZRing<Integer>>& partial, const CRABuilderFullMultip<Domain>& local)
+        {
+            local.result(partial);
+        }
+
+        // Early terminated builders count every prime of a partial reconstruction
+        template <class Builder, class Partial>
+        static auto progressPartial(Builder& B, const Integer& modulus, const Partial& partial, uint64_t count, int)
+            -> decltype(B.progress(modulus, partial, (size_t)count), void())
+        {
+            B.progress(modulus, partial, (size_t)count);
+        }
+
+        template <class Builder, class Partial>
+        static void progressPartial(Builder& B, const Integer& modulus, const Partial& partial, uint64_t, long)
         {
-            Iteration(r, D);
-            Builder_.initialize(D, r);
+            B.progress(modulus, partial);
+        }
+
+        /** \brief Hands out primes and combines the residues sent back by the workers.
+         */
+        template <class Any, class Partial, class PrimeIterator>
+        void master_process_task(PrimeIterator& primeGenerator, Any& r, Partial& partial)
+        {
+            int workersCount = _pCommunicator->size() - 1;
+            std::unordered_set<uint64_t> handedOut;
+            std::vector<size_t> pendingCount(workersCount + 1, 0); // primes handed to worker and not yet back
+
+            auto handOutBatch = [&](int worker) {
+                std::vector<uint64_t> batch;
+                while (batch.size() < _batchSize) {
+                    uint64_t p = *primeGenerator;
+                    ++primeGenerator;
+                    if (handedOut.count(p) > 0 || Builder_.noncoprime(p)) continue;
+                    handedOut.insert(p);
+                    batch.push_back(p);
+                }
+                pendingCount[worker] += batch.size();
+                _pCommunicator->send(batch.begin(), batch.end(), worker, Tag::Primes);
+            };
+
+            // Two batches per worker, to keep each one a batch ahead
+            for (int worker = 1; worker <= workersCount; ++worker) {
+                handOutBatch(worker);
+                handOutBatch(worker);
+            }
+
+            bool initialized = false;
+            bool terminated = false;
+            int workersDone = 0;
+            while (workersDone < workersCount) {
+                _pCommunicator->probe(MPI_ANY_SOURCE, MPI_ANY_TAG);
+                int worker = _pCommunicator->status().MPI_SOURCE;
+                int tag = _pCommunicator->status().MPI_TAG;
 
-            uint32_t workersDone = _pCommunicator->size() - 1;
-            while (workersDone > 0) {
-                // Receive the prime
+                if (tag == Tag::Done) {
+                    uint64_t poisonPill;
+                    _pCommunicator->recv(poisonPill, worker, Tag::Done);
+                    workersDone += 1;
+                    continue;
+                }
+
+                // A prime, or the number of primes of a partial reconstruction
                 uint64_t p;
-                _pCommunicator->recv(p, MPI_ANY_SOURCE);
-                if (p == 0) {
-                    workersDone -= 1;
+                uint64_t count = 1;
+                Integer modulus;
+                _pCommunicator->recv(p, worker, tag);
+                if (tag == Tag::Residue) {
+                    _pCommunicator->recv(r, worker, Tag::ResidueValue);
+                }
+                else if (tag == Tag::Partial) {
+                    count = p;
+                    _pCommunicator->recv(modulus, worker, Tag::PartialModulus);
+                    _pCommunicator->recv(partial, worker, Tag::PartialValue);
+                }
+                if (terminated) {
+                    // Still in flight when the workers were stopped
                     continue;
                 }
 
-                // Receive result vector and update builder
-                _pCommunicator->recv(r, _pCommunicator->status().MPI_SOURCE);
+                if (tag == Tag::Residue) {
+                    Domain D(p);
+                    if (initialized) {
+                        Builder_.progress(D, r);
+                    }
+                    else {
+                        Builder_.initialize(D, r);
+                        initialized = true;
+                    }
+                }
+                else if (tag == Tag::Partial && modulus > 1) {
+                    if (initialized) {
+                        progressPartial(Builder_, modulus, partial, count, 0);
+                    }
+                    else {
+                        Builder_.initialize(modulus, partial);
+                        initialized = true;
+                    }
+                }
 
-                Domain D(p);
-                Builder_.progress(D, r);
+                if (initialized && Builder_.terminated()) {
+                    terminated = true;
+                    uint64_t poisonPill = 0;
+                    for (int w = 1; w <= workersCount; ++w) {
+                        _pCommunicator->send(poisonPill, w, Tag::Stop);
+                    }
+                }
+                else if ((pendingCount[worker] -= count) <= _batchSize) {
+                    // This worker started on its last batch
+                    handOutBatch(worker);
+                }
             }
         }
     };
+
+    /** \brief Hybrid MPI+OpenMP \ref CRA.
+     *
+     * Each worker rank computes its batches of primes with all its threads,
+     * and sends back to the master a partial reconstruction per batch
+     * (not per-prime residues). One rank per node is thus enough to use
+     * every core of the node. The threads need \c __LINBOX_USE_OPENMP,
+     * which also disables the commentator; without it, a batch is computed
+     * serially.
+     *
+     * Bad primes are not detected, as for ChineseRemainderDistributed.
+     * Early terminated builders count the primes of a partial
+     * reconstruction one by one, except those of the first batch, which
+     * counts for one. They stop at most a batch after \c EARLY unchanged
+     * primes, as the distributed loop does with its batches in flight.
+     */
+    template <class CRABase>
+    struct ChineseRemainderCombined : public ChineseRemainderDistributed<CRABase> {
+        /** \param b  bound given to the builder
+         * \param c  communicator
+         * \param batchSize  primes per batch, defaults to 2 per thread
+         */
+        ChineseRemainderCombined(double b, Communicator* c, size_t batchSize = 0)
+            : ChineseRemainderDistributed<CRABase>(b, c, batchSize > 0 ? batchSize : defaultBatchSize(), true)
+        {
+        }
+
+        static size_t defaultBatchSize()
+        {
+#ifdef __LINBOX_USE_OPENMP
+            return 2 * (size_t)omp_get_max_threads();
+#else
+            return 2;
+#endif
+        }
+    };
 }
 
 #endif
@@ -1,9 +1,10 @@
 /* linbox/algorithms/cra-domain-omp.h
  * Copyright (C) 1999-2010 The LinBox group
  *
- * Naive parallel chinese remaindering
- * Launch NN iterations in parallel, where NN=omp_get_max_threads()
- * Then synchronization and termintation test.
+ * Parallel chinese remaindering
+ * Pipeline of OpenMP tasks, each on a fresh coprime, with at most
+ * 2*NN of them in flight, where NN=omp_get_max_threads().
+ * Residues are combined and termination tested as soon as they arrive.
  * Time-stamp: <13 Mar 12 13:49:58 Jean-Guillaume.Dumas@imag.fr>
  *
  * ========LICENCE========
@@ -37,7 +38,12 @@
 #define DISABLE_COMMENTATOR
 #endif
 #include <omp.h>
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <list>
 #include <set>
+#include <vector>
 #include "linbox/algorithms/cra-domain-sequential.h"
 
 namespace LinBox
@@ -58,72 +64,169 @@ namespace LinBox
 			Father_t(b)
 		{}
 
+		/** \brief The \ref CRA loop, as a pipeline of OpenMP tasks.
+		 *
+		 * The master thread keeps up to twice the number of threads
+		 * iterations in flight, each on a fresh coprime. Workers push
+		 * their finished residue in a shared queue, the master folds
+		 * them into \c Builder_ as soon as they arrive and cancels the
+		 * pending iterations once the builder has terminated.
+		 * Residues are thus never waiting for a whole round to finish.
+		 *
+		 * The master is the only one to touch \c Builder_ and the prime
+		 * iterator, so that \p Iteration is the only part required to be
+		 * thread safe.
+		 */
 		template <class ResultType, class Function, class PrimeIterator>
 		ResultType& operator() (ResultType& res, Function& Iteration, PrimeIterator& primeiter)
 		{
 			using ResidueType = typename CRAResidue<ResultType,Function>::template ResidueType<Domain>;
-			size_t NN = omp_get_max_threads();
+			size_t NN = omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads();
 			//std::cerr << "Blocs: " << NN << " iterations." << std::endl;
 			// commentator().start ("Parallel OMP Givaro::Modular iteration", "mmcrait");
 			if (NN == 1) return Father_t::operator()(res,Iteration,primeiter);
 
-			std::vector<Domain> ROUNDdomains; ROUNDdomains.reserve(NN);
-			std::vector<ResidueType> ROUNDresidues; ROUNDresidues.reserve(NN);
-			std::vector<IterationResult> ROUNDresults(NN);
-			std::set<Integer> coprimeset;
-
-			while (! this->Builder_.terminated()) {
-				ROUNDdomains.clear();
-				ROUNDresidues.clear();
-				coprimeset.clear();
-
-				while (coprimeset.size() < NN) {
-					coprimeset.emplace(this->get_coprime(primeiter));
-					++primeiter;
-				}
-
-				for(auto coprimesetiter = coprimeset.cbegin(); coprimesetiter != coprimeset.cend(); ++coprimesetiter) {
-					// std::cerr << "With prime: " << *coprimesetiter << std::endl;
-					ROUNDdomains.emplace_back(*coprimesetiter);
-					ROUNDresidues.emplace_back(CRAResidue<ResultType,Function>::create(ROUNDdomains.back()));
-				}
-
-#pragma omp parallel for
-				for(size_t i=0;i<NN;++i) {
-					ROUNDresults[i] = Iteration(ROUNDresidues[i], ROUNDdomains[i]);
-				}
-#pragma omp barrier
-
-				// if any thread says RESTART, then all CONTINUEs become SKIPs
-				bool anyrestart = false;
-				for (auto res : ROUNDresults) {
-					if (res == IterationResult::RESTART) anyrestart = true;
-				}
-				if (anyrestart) {
-					this->nbad_ += this->ngood_;
-					this->ngood_ = 0;
+			// One in-flight iteration. A std::list is used for the slots
+			// so that tasks keep valid pointers while others are erased.
+			struct Slot {
+				Integer prime;
+				Domain D;
+				ResidueType r;
+				IterationResult result;
+				size_t epoch; // restart count when the iteration was launched
+				bool cancelled;
+
+				Slot(const Integer& p, size_t e) :
+					prime(p), D(p), r(CRAResidue<ResultType,Function>::create(D)),
+					result(IterationResult::SKIP), epoch(e), cancelled(false)
+				{}
+			};
+
+			const size_t maxInFlight = 2*NN;
+			std::list<Slot> inflight;
+			std::deque<Slot*> pending;   // launched, not started; guarded by critical(cra_omp_queue)
+			std::vector<Slot*> finished; // shared queue, guarded by critical(cra_omp_queue)
+			std::vector<Slot*> toFold;
+			std::set<Integer> pendingprimes;
+			size_t epoch = 0;
+			bool stop = false;
+			std::exception_ptr error; // thrown by the master inside the region
+
+			// Runs the oldest pending iteration, if any. Tasks do not own a
+			// slot, they take the next one, so that the master can also run
+			// iterations when no other thread picks them up (a team whose
+			// threads are busy, or an enclosing task).
+			auto runPending = [&]() -> bool {
+				Slot* slot = NULL;
+#pragma omp critical(cra_omp_queue)
+				if (! pending.empty()) {
+					slot = pending.front();
+					pending.pop_front();
 				}
-
-				for (size_t i = 0; i < NN; ++i) {
-					if (ROUNDresults[i] == IterationResult::SKIP) {
-						this->doskip();
-					}
-					else if (anyrestart && ROUNDresults[i] == IterationResult::CONTINUE) {
-						// commentator should indicate that this prime is bad
-						++this->nbad_;
+				if (slot == NULL) return false;
+				bool stopped;
+#pragma omp atomic read
+				stopped = stop;
+				if (stopped)
+					slot->cancelled = true;
+				else
+					slot->result = Iteration(slot->r, slot->D);
+#pragma omp critical(cra_omp_queue)
+				finished.push_back(slot);
+				return true;
+			};
+
+			// The master loop. Called from a parallel region (e.g. a task
+			// of smithValence), its iterations are tasks of the enclosing
+			// team, otherwise of a new one.
+			auto pipeline = [&]() {
+				while (! stop || ! inflight.empty()) {
+					// Keep the pipeline full with fresh coprimes
+					while (! stop && inflight.size() < maxInFlight) {
+						Integer p = this->get_coprime(primeiter);
+						++primeiter;
+						if (! pendingprimes.insert(p).second) continue;
+						inflight.emplace_back(p, epoch);
+						Slot* slot = &(inflight.back());
+#pragma omp critical(cra_omp_queue)
+						pending.push_back(slot);
+#pragma omp task
+						runPending();
 					}
-					else if (this->ngood_ == 0) {
-						this->ngood_ = 1;
-						this->Builder_.initialize(ROUNDdomains[i], ROUNDresidues[i]);
+
+#pragma omp critical(cra_omp_queue)
+					finished.swap(toFold);
+
+					if (toFold.empty()) {
+						// nothing to fold: rather than wait on tasks that
+						// may never be scheduled, run one here. If none is
+						// left, the in-flight ones are running elsewhere.
+						if (! runPending()) {
+#pragma omp taskyield
+						}
+						continue;
 					}
-					else {
-						++this->ngood_;
-						this->Builder_.progress(ROUNDdomains[i], ROUNDresidues[i]);
+
+					for (Slot* slot : toFold) {
+						if (! stop && ! slot->cancelled) try {
+							switch (slot->result) {
+							case IterationResult::SKIP:
+								this->doskip();
+								break;
+							case IterationResult::RESTART:
+								this->nbad_ += this->ngood_;
+								this->ngood_ = 1;
+								++epoch;
+								this->Builder_.initialize(slot->D, slot->r);
+								break;
+							case IterationResult::CONTINUE:
+								if (slot->epoch != epoch) {
+									// launched before a restart: this prime is bad
+									++this->nbad_;
+								}
+								else if (this->ngood_ == 0) {
+									this->ngood_ = 1;
+									this->Builder_.initialize(slot->D, slot->r);
+								}
+								else {
+									++this->ngood_;
+									this->Builder_.progress(slot->D, slot->r);
+								}
+								break;
+							}
+							if (this->ngood_ > 0 && this->Builder_.terminated()) {
+#pragma omp atomic write
+								stop = true;
+							}
+						}
+						catch (...) {
+							// no exception may leave the parallel region
+							error = std::current_exception();
+#pragma omp atomic write
+							stop = true;
+						}
+						pendingprimes.erase(slot->prime);
 					}
+					inflight.remove_if([&toFold](const Slot& s) {
+							return std::find(toFold.begin(), toFold.end(), &s) != toFold.end();
+						});
+					toFold.clear();
 				}
-				//std::cerr << "Computed: " << iterCount() << " primes." << std::endl;
+				// the remaining tasks find no pending slot, but they use
+				// the queues of this frame
+#pragma omp taskwait
+			};
+
+			if (omp_in_parallel())
+				pipeline();
+			else {
+#pragma omp parallel num_threads(NN)
+#pragma omp single
+				pipeline();
 			}
 
+			if (error) std::rethrow_exception(error);
+
 			// commentator().stop ("done", NULL, "mmcrait");
 			//std::cerr << "Used: " << this->iterCount() << " primes." << std::endl;
 			return this->Builder_.result(res);
@@ -70,6 +70,11 @@ namespace LinBox
 		*/
 		const Field &field () const { return *(new GF2()); }
 
+		/** No dense ending over GF2, for the interface of GaussDomain only.
+		*/
+		bool denseSwitch () const { return false; }
+		void setDenseSwitch (bool) {}
+
 		/** @name rank
 		  Callers of the different rank routines
 		  @li  The "in" suffix indicates in place computation
@@ -185,6 +190,29 @@ namespace LinBox
 						     Perm                   &P,
 						     size_t Ni,
 						     size_t Nj) const;
+		/** \brief Structured Gaussian elimination, as in the filtering and
+		 * elimination phases of factoring algorithms.
+		 * - Rows of weight one, columns of weight one and columns of weight
+		 *   two (merging their two rows) are removed first, each giving a
+		 *   pivot without any fill-in.
+		 * - The remaining columns are relabelled by increasing weight and
+		 *   rows are eliminated by leading column, the sparsest row of each
+		 *   column being the pivot. A row is packed in a bit vector once
+		 *   its weight exceeds \c 1/LINBOX_GF2_DENSE_ROW_RATIO of the
+		 *   columns; packed rows are added with SIMD xors, in parallel.
+		 * - Once half of the rows left are packed, they are handed to
+		 *   BitMatrixDomain (M4RI).
+		 *
+		 * Only the rank and the determinant are computed, A is emptied.
+		 * Selected by PivotStrategy::Structured.
+		 */
+		template <class SparseSeqMatrix>
+		size_t& InPlaceStructuredPivoting(size_t &Rank,
+						  Element& determinant,
+						  SparseSeqMatrix        &A,
+						  size_t Ni,
+						  size_t Nj) const;
+
 		template <class SparseSeqMatrix>
 		size_t& NoReordering (size_t & Rank, Element& , SparseSeqMatrix &, size_t , size_t ) const
 		{
@@ -242,6 +270,7 @@ namespace LinBox
 #include "linbox/algorithms/gauss/gauss-rank-gf2.inl"
 #include "linbox/algorithms/gauss/gauss-det-gf2.inl"
 #include "linbox/algorithms/gauss/gauss-solve-gf2.inl"
+#include "linbox/algorithms/gauss/gauss-structured-gf2.inl"
 
 #endif // __LINBOX_gauss_gf2_H
 
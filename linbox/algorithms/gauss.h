@@ -42,6 +42,8 @@
 #ifndef __LINBOX_gauss_H
 #define __LINBOX_gauss_H
 
+#include <type_traits>
+
 #include "linbox/util/debug.h"
 #include "linbox/util/commentator.h"
 #include "linbox/field/archetype.h"
@@ -76,6 +78,7 @@ namespace LinBox
 
 	private:
 		const Field         *_field;
+		bool                 _denseSwitch;
 
 	public:
 
@@ -83,19 +86,25 @@ namespace LinBox
 		 * over which to perform computations
 		 */
 		GaussDomain (const Field &F) :
-			_field (&F)
+			_field (&F), _denseSwitch (true)
 		{}
 
 		//Copy constructor
 		///
 		GaussDomain (const GaussDomain &Mat) :
-			_field (Mat._field)
+			_field (Mat._field), _denseSwitch (Mat._denseSwitch)
 		{}
 
 		/** accessor for the field of computation
 		*/
 		const Field &field () const { return *_field; }
 
+		/** Whether InPlaceLinearPivoting may finish on a dense
+		 * active submatrix (see SwitchToDense), true by default.
+		 */
+		bool denseSwitch () const { return _denseSwitch; }
+		void setDenseSwitch (bool s) { _denseSwitch = s; }
+
 		/** @name rank
 		  Callers of the different rank routines\\
 		  -/ The "in" suffix indicates in place computation\\
@@ -182,7 +191,8 @@ namespace LinBox
 				      _Matrix        &U,
 				      Perm	    &P,
 				      size_t Ni,
-				      size_t Nj) const;
+				      size_t Nj,
+				      PivotStrategy reord = PivotStrategy::Linear) const;
 
 		template <class _Matrix, class Perm>
 		size_t& DenseQLUPin(size_t &rank,
@@ -201,7 +211,8 @@ namespace LinBox
 		template <class _Matrix, class Vector1, class Vector2>
 		Vector1& solveInPlace(Vector1	&x,
 				 _Matrix         &A,
-				 const Vector2	&b)  const;
+				 const Vector2	&b,
+				 PivotStrategy   reord = PivotStrategy::Linear)  const;
 
 		template <class _Matrix, class Vector1, class Vector2, class Random>
 		Vector1& solveInPlace(Vector1	&x,
@@ -216,20 +227,26 @@ namespace LinBox
 				      const Perm& P)  const ;
 
 		template <class _Matrix, class Block>
-		Block& nullspacebasisin(Block& x, _Matrix& A)  const;
+		Block& nullspacebasisin(Block& x, _Matrix& A,
+					PivotStrategy reord = PivotStrategy::Linear)  const;
 
 		template <class _Matrix, class Block>
-		Block& nullspacebasis(Block& x, const _Matrix& A)  const;
+		Block& nullspacebasis(Block& x, const _Matrix& A,
+				      PivotStrategy reord = PivotStrategy::Linear)  const;
 
 
 		// Sparsest method
 		//   erases elements while computing rank/det.
+		//   With PivotStrategy::Markowitz, columns are first relabelled
+		//   by FillReducingOrdering and pivot rows minimize the
+		//   Markowitz cost among the sparsest rows (MarkowitzRow).
 		template <class _Matrix>
 		size_t& InPlaceLinearPivoting(size_t &rank,
 						     Element& determinant,
 						     _Matrix        &A,
 						     size_t Ni,
-						     size_t Nj) const;
+						     size_t Nj,
+						     PivotStrategy reord = PivotStrategy::Linear) const;
 
 		// Same as the latter but keeps trace
 		//   of column permutations
@@ -240,7 +257,78 @@ namespace LinBox
 						     _Matrix        &A,
 						     Perm          &P,
 						     size_t Ni,
-						     size_t Nj) const;
+						     size_t Nj,
+						     PivotStrategy reord = PivotStrategy::Linear) const;
+
+		// Dense ending of InPlaceLinearPivoting :
+		//   rows k..Ni-1, with entries in columns rank..Nj-1 only,
+		//   are gathered in a BlasMatrix and factored by FFPACK::PLUQ.
+		//   Used once the active submatrix is denser than
+		//   __LINBOX_SpD_DENSITY__ (finite fields only).
+		template <class _Matrix>
+		size_t& DenseLinearPivoting(size_t &rank,
+					    Element& determinant,
+					    _Matrix        &A,
+					    size_t k,
+					    size_t Ni,
+					    size_t Nj,
+					    std::true_type) const;
+
+		template <class _Matrix>
+		size_t& DenseLinearPivoting(size_t &rank,
+					    Element& determinant,
+					    _Matrix        &A,
+					    size_t k,
+					    size_t Ni,
+					    size_t Nj,
+					    std::false_type) const
+		{ return rank; }
+
+		// Same as the latter but stores U in rows k..k+R-1
+		//   and keeps trace of the column permutations
+		template <class _Matrix, class Perm>
+		size_t& DenseLinearPivoting(size_t &rank,
+					    Element& determinant,
+					    _Matrix        &A,
+					    Perm          &P,
+					    size_t k,
+					    size_t Ni,
+					    size_t Nj,
+					    std::true_type) const;
+
+		template <class _Matrix, class Perm>
+		size_t& DenseLinearPivoting(size_t &rank,
+					    Element& determinant,
+					    _Matrix        &A,
+					    Perm          &P,
+					    size_t k,
+					    size_t Ni,
+					    size_t Nj,
+					    std::false_type) const
+		{ return rank; }
+
+		// Whether the active submatrix, rows k..Ni-1 and columns
+		//   rank..Nj-1, of column densities columns, is dense enough,
+		//   and small enough to be stored dense
+		//   (__LINBOX_SpD_MAXMEMORY__ bytes)
+		template <class D>
+		bool SwitchToDense(const D &columns, size_t k, size_t rank, size_t Ni, size_t Nj) const;
+
+
+		/** \brief Sparse in place Gaussian elimination, parallel version.
+		 * Each step selects a set of independent pivots (no pivot row has
+		 * an entry in the column of another pivot), of small Markowitz
+		 * cost, and eliminates them from all the remaining rows at once.
+		 * The remaining rows are updated in parallel (OpenMP).
+		 * Rank and determinant are the same as with InPlaceLinearPivoting.
+		 * Selected by PivotStrategy::Parallel.
+		 */
+		template <class _Matrix>
+		size_t& InPlaceParallelPivoting(size_t &rank,
+						Element& determinant,
+						_Matrix        &A,
+						size_t Ni,
+						size_t Nj) const;
 
 
 		/** \brief Sparse Gaussian elimination without reordering.
@@ -299,6 +387,17 @@ Using : FindPivot and LU
 				const long &indpermut,
 				D                   &columns) const;
 
+		//-----------------------------------------
+		// Sparse elimination using a pivot row :
+		// lc <-- lc + headcoeff * lp, column indcol removed
+		// Columns are not permuted, no density update
+		//-----------------------------------------
+		template <class Vector>
+		void eliminateIndependent (Vector              &lignecourante,
+					   const Vector        &lignepivot,
+					   const Element       &headcoeff,
+					   const size_t         indcol) const;
+
 		template <class Vector>
 		void permute (Vector              &lignecourante,
 			      const size_t &indcol,
@@ -371,6 +470,27 @@ Using : FindPivot and LU
 				      size_t Nj) const;
 
 
+		//------------------------------------------
+		// Fill reducing column ordering (COLAMD like)
+		// perm[j] is the new label of column j
+		//------------------------------------------
+		template <class _Matrix>
+		void FillReducingOrdering (std::vector<size_t> &perm, const _Matrix &A, size_t Ni, size_t Nj) const;
+
+		//------------------------------------------
+		// Column j of A becomes column perm[j]
+		// Returns true if perm is odd
+		//------------------------------------------
+		template <class _Matrix>
+		bool RelabelColumns (_Matrix &A, const std::vector<size_t> &perm, size_t Ni) const;
+
+		//------------------------------------------
+		// Row of index >= k, among the sparsest ones,
+		// with smallest Markowitz cost (r-1)(c-1)
+		//------------------------------------------
+		template <class _Matrix, class D>
+		long MarkowitzRow (const _Matrix &A, long k, size_t Ni, const D &columns) const;
+
 		template <class _Matrix, class Perm, bool hasFFLAS>
         struct Continuation {
             size_t& operator()(
@@ -391,6 +511,8 @@ Using : FindPivot and LU
 #include "linbox/algorithms/gauss/gauss.inl"
 #include "linbox/algorithms/gauss/gauss-pivot.inl"
 #include "linbox/algorithms/gauss/gauss-elim.inl"
+#include "linbox/algorithms/gauss/gauss-parallel.inl"
+#include "linbox/algorithms/gauss/gauss-ordering.inl"
 #include "linbox/algorithms/gauss/gauss-solve.inl"
 #include "linbox/algorithms/gauss/gauss-nullspace.inl"
 #include "linbox/algorithms/gauss/gauss-rank.inl"
@@ -40,6 +40,8 @@ namespace LinBox
 		size_t Rank;
 		if (reord == PivotStrategy::None)
 			NoReordering(Rank, determinant, A, Ni, Nj);
+		else if (reord == PivotStrategy::Structured)
+			InPlaceStructuredPivoting(Rank, determinant, A, Ni, Nj);
 		else {
                         Permutation<GF2> P(A.field(),(int)A.coldim());
 			InPlaceLinearPivoting(Rank, determinant, A, P, Ni, Nj);
@@ -41,8 +41,10 @@ namespace LinBox
 		size_t Rank;
 		if (reord == PivotStrategy::None)
 			NoReordering(Rank, determinant, A,  Ni, Nj);
+		else if (reord == PivotStrategy::Parallel)
+			InPlaceParallelPivoting(Rank, determinant, A, Ni, Nj);
 		else
-			InPlaceLinearPivoting(Rank, determinant, A, Ni, Nj);
+			InPlaceLinearPivoting(Rank, determinant, A, Ni, Nj, reord);
 		return determinant;
 	}
 
@@ -96,7 +96,7 @@ namespace LinBox
 	// _Matrix A is upper triangularized
 	template <class _Field>
 	template <class _Matrix, class Block> inline Block&
-	GaussDomain<_Field>::nullspacebasisin(Block& x, _Matrix& A)  const
+	GaussDomain<_Field>::nullspacebasisin(Block& x, _Matrix& A, PivotStrategy reord)  const
 	{
 		typename Field::Element Det;
 		size_t Rank;
@@ -105,7 +105,7 @@ namespace LinBox
 		Permutation<Field> P(field(),(int)Nj);
 
 		// A.write( std::cerr << "A:=", Tag::FileFormat::Maple ) << ';' << std::endl;
-		this->InPlaceLinearPivoting(Rank, Det, A, P, Ni, Nj );
+		this->InPlaceLinearPivoting(Rank, Det, A, P, Ni, Nj, reord );
 
 		// P.write( std::cerr << "P:=", Tag::FileFormat::Maple ) << ';' << std::endl;
 		// A.write( std::cerr << "Ua:=", Tag::FileFormat::Maple ) << ';' << std::endl;
@@ -130,10 +130,10 @@ namespace LinBox
 
 	template <class _Field>
 	template <class _Matrix, class Block> inline Block&
-	GaussDomain<_Field>::nullspacebasis(Block& x, const _Matrix& A)  const
+	GaussDomain<_Field>::nullspacebasis(Block& x, const _Matrix& A, PivotStrategy reord)  const
 	{
 		Matrix A1 (A); // Must copy, then best to copy to preferred
-		return this->nullspacebasisin(x, A1);
+		return this->nullspacebasisin(x, A1, reord);
 	}
 
 
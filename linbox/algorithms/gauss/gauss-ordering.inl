@@ -0,0 +1,231 @@
+/* linbox/algorithms/gauss-ordering.inl
+ * Copyright (C) 2014 The LinBox group
+ *
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ *
+ * SparseElimination fill reducing column ordering and Markowitz pivot rows
+ * (PivotStrategy::Markowitz)
+ */
+#ifndef __LINBOX_gauss_ordering_INL
+#define __LINBOX_gauss_ordering_INL
+
+#include <vector>
+#include <set>
+#include <cmath>
+#include <algorithm>
+
+// Number of sparsest rows whose Markowitz cost is evaluated at each step.
+#ifndef LINBOX_MARKOWITZ_SEARCH
+#define LINBOX_MARKOWITZ_SEARCH 4
+#endif
+
+namespace LinBox
+{
+	template <class _Field>
+	template <class _Matrix> inline void
+	GaussDomain<_Field>::FillReducingOrdering (std::vector<size_t> &perm,
+						   const _Matrix       &LigneA,
+						   size_t Ni,
+						   size_t Nj) const
+	{
+		// Column approximate minimum degree, in the spirit of COLAMD :
+		// eliminating column c merges the rows having an entry in c into
+		// a single row (the structure of the pivot row after elimination).
+		// The score of a column is sum(|r|-1) over its rows, an upper bound
+		// of its degree in the graph of A^T A.
+		// Dense rows and columns are left out, dense columns are ordered last.
+		const size_t denseRow = std::max ((size_t)16, (size_t)(10*std::sqrt ((double)Nj)));
+		const size_t denseCol = std::max ((size_t)16, (size_t)(10*std::sqrt ((double)Ni)));
+
+		std::vector<size_t> count (Nj, 0);
+		for (size_t i = 0; i < Ni; ++i)
+			for (size_t k = 0; k < LigneA[i].size (); ++k)
+				++count[LigneA[i][k].first];
+
+		std::vector<std::vector<size_t> > rows, cols (Nj);
+		std::vector<bool> alive;
+		for (size_t i = 0; i < Ni; ++i) {
+			if (LigneA[i].size () > denseRow)
+				continue;
+			std::vector<size_t> r;
+			for (size_t k = 0; k < LigneA[i].size (); ++k)
+				if (count[LigneA[i][k].first] <= denseCol)
+					r.push_back (LigneA[i][k].first);
+			if (r.empty ())
+				continue;
+			for (size_t k = 0; k < r.size (); ++k)
+				cols[r[k]].push_back (rows.size ());
+			rows.push_back (r);
+			alive.push_back (true);
+		}
+
+		std::vector<size_t> score (Nj, 0);
+		std::set<std::pair<size_t,size_t> > queue;
+		for (size_t c = 0; c < Nj; ++c) {
+			if (cols[c].empty ())
+				continue;
+			for (size_t k = 0; k < cols[c].size (); ++k)
+				score[c] += rows[cols[c][k]].size () - 1;
+			queue.insert (std::pair<size_t,size_t> (score[c], c));
+		}
+
+		const size_t none = Nj;
+		perm.assign (Nj, none);
+		std::vector<size_t> mark (Nj, none);
+		size_t next = 0;
+
+		while (! queue.empty ()) {
+			const size_t c = queue.begin ()->second;
+			queue.erase (queue.begin ());
+			perm[c] = next++;
+
+			// merge the rows of c
+			std::vector<size_t> u;
+			for (size_t k = 0; k < cols[c].size (); ++k) {
+				const size_t r = cols[c][k];
+				if (! alive[r]) continue;
+				alive[r] = false;
+				for (size_t l = 0; l < rows[r].size (); ++l) {
+					const size_t cc = rows[r][l];
+					if ((perm[cc] == none) && (mark[cc] != c)) {
+						mark[cc] = c;
+						u.push_back (cc);
+					}
+				}
+				std::vector<size_t> ().swap (rows[r]);
+			}
+			std::vector<size_t> ().swap (cols[c]);
+			if (u.empty ())
+				continue;
+
+			// a dense merged row no longer discriminates the columns
+			const bool keep = (u.size () <= denseRow);
+			const size_t nr = rows.size ();
+			if (keep) {
+				rows.push_back (u);
+				alive.push_back (true);
+			}
+
+			for (size_t l = 0; l < u.size (); ++l) {
+				const size_t cc = u[l];
+				std::vector<size_t> & cr = cols[cc];
+				size_t m = 0;
+				for (size_t k = 0; k < cr.size (); ++k)
+					if (alive[cr[k]]) cr[m++] = cr[k];
+				cr.resize (m);
+				if (keep) cr.push_back (nr);
+
+				queue.erase (std::pair<size_t,size_t> (score[cc], cc));
+				score[cc] = 0;
+				for (size_t k = 0; k < cr.size (); ++k)
+					score[cc] += rows[cr[k]].size () - 1;
+				queue.insert (std::pair<size_t,size_t> (score[cc], cc));
+			}
+		}
+
+		// empty and dense columns
+		for (size_t c = 0; c < Nj; ++c)
+			if (perm[c] == none)
+				perm[c] = next++;
+	}
+
+	template <class _Field>
+	template <class _Matrix> inline bool
+	GaussDomain<_Field>::RelabelColumns (_Matrix                   &LigneA,
+					     const std::vector<size_t> &perm,
+					     size_t Ni) const
+	{
+		typedef typename _Matrix::Row        Vector;
+		typedef typename Vector::value_type E;
+		typedef typename E::first_type E1;
+
+		for (size_t i = 0; i < Ni; ++i) {
+			Vector & row = LigneA[i];
+			for (size_t k = 0; k < row.size (); ++k)
+				row[k].first = (E1) perm[(size_t)row[k].first];
+			std::sort (row.begin (), row.end (),
+				   [](const E & a, const E & b) { return a.first < b.first; });
+		}
+
+		// parity of the permutation
+		bool odd = false;
+		std::vector<bool> seen (perm.size (), false);
+		for (size_t c = 0; c < perm.size (); ++c) {
+			if (seen[c]) continue;
+			size_t len = 0;
+			for (size_t l = c; ! seen[l]; l = perm[l]) {
+				seen[l] = true;
+				++len;
+			}
+			if (! (len & 1)) odd = ! odd;
+		}
+		return odd;
+	}
+
+	template <class _Field>
+	template <class _Matrix, class D> inline long
+	GaussDomain<_Field>::MarkowitzRow (const _Matrix &LigneA,
+					   long k,
+					   size_t Ni,
+					   const D &columns) const
+	{
+		// the LINBOX_MARKOWITZ_SEARCH sparsest non empty rows, by size
+		std::vector<std::pair<size_t,long> > best;
+		for (long l = k; l < static_cast<long>(Ni); ++l) {
+			const size_t sl = LigneA[(size_t)l].size ();
+			if (! sl) continue;
+			if (best.size () == LINBOX_MARKOWITZ_SEARCH && sl >= best.back ().first)
+				continue;
+			std::pair<size_t,long> cand (sl, l);
+			best.insert (std::upper_bound (best.begin (), best.end (), cand), cand);
+			if (best.size () > LINBOX_MARKOWITZ_SEARCH)
+				best.pop_back ();
+		}
+		if (best.empty ())
+			return k;
+
+		// (r-1)(c-1), with c the sparsest column of the row
+		long p = best[0].second;
+		size_t cost = (size_t)-1;
+		for (size_t t = 0; t < best.size (); ++t) {
+			const auto & row = LigneA[(size_t)best[t].second];
+			size_t cmin = columns[(size_t)row[0].first];
+			for (size_t j = 1; j < row.size (); ++j)
+				cmin = std::min (cmin, (size_t)columns[(size_t)row[j].first]);
+			const size_t ct = (best[t].first - 1) * (cmin ? cmin - 1 : 0);
+			if (ct < cost) {
+				cost = ct;
+				p = best[t].second;
+			}
+		}
+		return p;
+	}
+} // namespace LinBox
+
+#endif // __LINBOX_gauss_ordering_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
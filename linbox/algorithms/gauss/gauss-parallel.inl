@@ -0,0 +1,269 @@
+/* linbox/algorithms/gauss-parallel.inl
+ * Copyright (C) 2014 The LinBox group
+ *
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ *
+ * SparseElimination with sets of independent pivots, eliminated in parallel
+ */
+#ifndef __LINBOX_gauss_parallel_INL
+#define __LINBOX_gauss_parallel_INL
+
+#include <vector>
+#include <algorithm>
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+// A step accepts pivots whose Markowitz cost is at most
+// LINBOX_GAUSS_PARALLEL_RELAX times (1 + the cheapest cost of the step).
+#ifndef LINBOX_GAUSS_PARALLEL_RELAX
+#define LINBOX_GAUSS_PARALLEL_RELAX 4
+#endif
+
+// Rows handed to a thread at once during the elimination of a step.
+#ifndef LINBOX_GAUSS_PARALLEL_GRAIN
+#define LINBOX_GAUSS_PARALLEL_GRAIN 32
+#endif
+
+namespace LinBox
+{
+	template <class _Field>
+	template <class Vector> inline void
+	GaussDomain<_Field>::eliminateIndependent (Vector              &lignecourante,
+						   const Vector        &lignepivot,
+						   const Element       &headcoeff,
+						   const size_t         indcol) const
+	{
+		typedef typename Vector::value_type E;
+		typedef typename E::first_type E1;
+
+		const size_t nj = lignecourante.size ();
+		const size_t npiv = lignepivot.size ();
+		Vector construit (nj + npiv);
+
+		size_t j = 0, m = 0, l = 0;
+		while ((m < nj) || (l < npiv)) {
+			if ((l == npiv) || ((m < nj) && (lignecourante[m].first < lignepivot[l].first))) {
+				if (lignecourante[m].first != indcol)
+					construit[j++] = lignecourante[m];
+				++m;
+			}
+			else if ((m == nj) || (lignepivot[l].first < lignecourante[m].first)) {
+				if (lignepivot[l].first != indcol) {
+					Element tmp;
+					field().mul (tmp, headcoeff, lignepivot[l].second);
+					construit[j++] = E ((E1)lignepivot[l].first, tmp);
+				}
+				++l;
+			}
+			else {
+				if (lignecourante[m].first != indcol) {
+					Element tmp;
+					field().axpy (tmp, headcoeff, lignepivot[l].second,
+						      lignecourante[m].second);
+					if (! field().isZero (tmp))
+						construit[j++] = E (lignecourante[m].first, tmp);
+				}
+				++m; ++l;
+			}
+		}
+		construit.resize (j);
+		lignecourante = construit;
+	}
+
+	template <class _Field>
+	template <class _Matrix> inline size_t&
+	GaussDomain<_Field>::InPlaceParallelPivoting (size_t &Rank,
+						      Element        &determinant,
+						      _Matrix         &LigneA,
+						      size_t   Ni,
+						      size_t   Nj) const
+	{
+		typedef typename _Matrix::Row        Vector;
+
+		// Requirements : LigneA is an array of sparse rows
+		// In place (LigneA is modified, pivot rows are erased)
+		//
+		// Each step chooses, in the sparsest column of every remaining row,
+		// a candidate pivot of Markowitz cost (r-1)(c-1). Going through the
+		// candidates by increasing cost, a pivot (i,j) is kept when row i has
+		// no entry in the columns of the kept pivots and none of the kept
+		// rows has an entry in column j : the pivots of a step form a
+		// diagonal block. Hence eliminating them from a remaining row
+		// creates no fill in the other pivot columns, every remaining row
+		// is updated independently of the others, and the rank and the
+		// determinant are those of the sequential elimination.
+		commentator().start ("IPPR Gaussian elimination with independent pivots",
+				     "IPPR", Ni);
+		field().write( commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+			       << "Parallel Gaussian elimination on " << Ni << " x " << Nj << " matrix, over: ") << std::endl;
+
+		field().assign(determinant,field().one);
+		Rank = 0;
+
+		std::vector<size_t> col_density (Nj);
+		std::vector<size_t> pivotRow (Nj, Ni);      // row of the pivot in column j
+		std::vector<size_t> pivotCol (Ni, Nj);      // column of the pivot in row i
+		std::vector<Element> headinv (Nj);          // inverse of the pivot in column j
+		std::vector<size_t> pivotMark (Nj, 0), touchMark (Nj, 0);
+		size_t stamp = 0;
+
+		std::vector<size_t> active;
+		for (size_t i = 0; i < Ni; ++i)
+			if (! LigneA[i].empty ())
+				active.push_back(i);
+
+		// candidate : (cost, row, column)
+		typedef std::pair<size_t, std::pair<size_t,size_t> > Candidate;
+		std::vector<Candidate> candidates;
+		std::vector<size_t> selected, remaining;
+
+		while (! active.empty ()) {
+			++stamp;
+			commentator().progress ((long)Rank);
+
+			std::fill (col_density.begin (), col_density.end (), 0);
+			for (size_t t = 0; t < active.size (); ++t) {
+				const Vector & row = LigneA[active[t]];
+				for (size_t k = 0; k < row.size (); ++k)
+					++col_density[row[k].first];
+			}
+
+			candidates.resize (active.size ());
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+			for (long t = 0; t < (long)active.size (); ++t) {
+				const Vector & row = LigneA[active[(size_t)t]];
+				size_t c = row[0].first;
+				for (size_t k = 1; k < row.size (); ++k)
+					if (col_density[row[k].first] < col_density[c])
+						c = row[k].first;
+				candidates[(size_t)t] = Candidate ((row.size () - 1) * (col_density[c] - 1),
+								   std::pair<size_t,size_t> (active[(size_t)t], c));
+			}
+			std::sort (candidates.begin (), candidates.end ());
+
+			// greedy choice of independent pivots
+			const size_t bound = (candidates[0].first + 1) * LINBOX_GAUSS_PARALLEL_RELAX;
+			selected.clear ();
+			for (size_t t = 0; t < candidates.size () && candidates[t].first <= bound; ++t) {
+				const size_t i = candidates[t].second.first;
+				const size_t j = candidates[t].second.second;
+				if (touchMark[j] == stamp)
+					continue;
+				const Vector & row = LigneA[i];
+				bool independent = true;
+				for (size_t k = 0; k < row.size (); ++k)
+					if (pivotMark[row[k].first] == stamp) {
+						independent = false;
+						break;
+					}
+				if (! independent)
+					continue;
+				pivotMark[j] = stamp;
+				for (size_t k = 0; k < row.size (); ++k)
+					touchMark[row[k].first] = stamp;
+				selected.push_back (i);
+
+				pivotRow[j] = i;
+				pivotCol[i] = j;
+				size_t k = 0;
+				while (row[k].first != j) ++k;
+				field().mulin (determinant, row[k].second);
+				field().inv (headinv[j], row[k].second);
+				++Rank;
+			}
+
+			remaining.clear ();
+			for (size_t t = 0; t < active.size (); ++t)
+				if (pivotCol[active[t]] == Nj)
+					remaining.push_back (active[t]);
+
+			// every remaining row is updated by all the pivots it meets
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, LINBOX_GAUSS_PARALLEL_GRAIN)
+#endif
+			for (long t = 0; t < (long)remaining.size (); ++t) {
+				Vector & row = LigneA[remaining[(size_t)t]];
+				std::vector<std::pair<size_t,Element> > hits;
+				for (size_t k = 0; k < row.size (); ++k)
+					if (pivotMark[row[k].first] == stamp)
+						hits.push_back (std::pair<size_t,Element> (row[k].first, row[k].second));
+				for (size_t h = 0; h < hits.size (); ++h) {
+					// the other pivot rows of the step are zero in this column
+					Element headcoeff;
+					field().mul (headcoeff, hits[h].second, headinv[hits[h].first]);
+					field().negin (headcoeff);
+					eliminateIndependent (row, LigneA[pivotRow[hits[h].first]], headcoeff, hits[h].first);
+				}
+			}
+
+			for (size_t t = 0; t < selected.size (); ++t)
+				LigneA[selected[t]] = Vector (0);
+
+			active.clear ();
+			for (size_t t = 0; t < remaining.size (); ++t)
+				if (! LigneA[remaining[t]].empty ())
+					active.push_back (remaining[t]);
+		}
+
+		if ((Rank < Ni) || (Rank < Nj) || (Ni == 0) || (Nj == 0))
+			field().assign(determinant,field().zero);
+		else {
+			// sign of the permutation i -> pivotCol[i]
+			std::vector<bool> seen (Ni, false);
+			for (size_t i = 0; i < Ni; ++i) {
+				if (seen[i]) continue;
+				size_t len = 0;
+				for (size_t l = i; ! seen[l]; l = pivotCol[l]) {
+					seen[l] = true;
+					++len;
+				}
+				if (! (len & 1))
+					field().negin (determinant);
+			}
+		}
+
+		integer card;
+
+		field().write(commentator().report (Commentator::LEVEL_NORMAL, PARTIAL_RESULT)
+			      << "Determinant : ", determinant)
+		<< " over GF (" << field().cardinality (card) << ")" << std::endl;
+
+		commentator().report (Commentator::LEVEL_NORMAL, PARTIAL_RESULT)
+		<< "Rank : " << Rank
+		<< " over GF (" << card << ") in " << stamp << " steps" << std::endl;
+		commentator().stop ("done", 0, "IPPR");
+		return Rank;
+	}
+} // namespace LinBox
+
+#endif // __LINBOX_gauss_parallel_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -46,6 +46,8 @@ namespace LinBox
 
 		if (reord == PivotStrategy::None)
 			return NoReordering(Rank, determinant, A,  Ni, Nj);
+		else if (reord == PivotStrategy::Structured)
+			return InPlaceStructuredPivoting(Rank, determinant, A, Ni, Nj);
 		else
 			return InPlaceLinearPivoting(Rank, determinant, A, P, Ni, Nj);
 	}
@@ -41,8 +41,10 @@ namespace LinBox
 		Element determinant;
 		if (reord == PivotStrategy::None)
 			return NoReordering(Rank, determinant, A,  Ni, Nj);
+		else if (reord == PivotStrategy::Parallel)
+			return InPlaceParallelPivoting(Rank, determinant, A, Ni, Nj);
 		else
-			return InPlaceLinearPivoting(Rank, determinant, A, Ni, Nj);
+			return InPlaceLinearPivoting(Rank, determinant, A, Ni, Nj, reord);
 	}
 
 
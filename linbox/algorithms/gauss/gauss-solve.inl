@@ -58,7 +58,7 @@ namespace LinBox
 
 	template <class _Field>
 	template <class _Matrix, class Vector1, class Vector2> inline Vector1&
-	GaussDomain<_Field>::solveInPlace(Vector1& x, _Matrix& A, const Vector2& b)  const
+	GaussDomain<_Field>::solveInPlace(Vector1& x, _Matrix& A, const Vector2& b, PivotStrategy reord)  const
 	{
 
 		typename Field::Element Det;
@@ -67,7 +67,7 @@ namespace LinBox
 		Permutation<Field> Q(field(),(int)A.rowdim());
 		Permutation<Field> P(field(),(int)A.coldim());
 
-		this->QLUPin(Rank, Det, Q, L, A, P, A.rowdim(), A.coldim() );
+		this->QLUPin(Rank, Det, Q, L, A, P, A.rowdim(), A.coldim(), reord );
 
             // Sets solution values to 0 for coldim()-Rank columns
             // Therefore, prune unnecessary elements
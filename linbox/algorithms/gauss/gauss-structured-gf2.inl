@@ -0,0 +1,373 @@
+/* linbox/algorithms/gauss/gauss-structured-gf2.inl
+ * Copyright (C) 2014 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ *
+ * Structured Gaussian elimination over GF2 (PivotStrategy::Structured) :
+ * singleton and doubleton removal, then elimination on rows that are
+ * packed in bit vectors once they fill in.
+ */
+
+#ifndef __LINBOX_gauss_structured_gf2_INL
+#define __LINBOX_gauss_structured_gf2_INL
+
+#include <vector>
+#include <algorithm>
+
+#include "linbox/matrix/densematrix/bit-matrix.h"
+#include "linbox/matrix/matrixdomain/bit-matrix-domain.h"
+
+// a sparse row of weight w among n active columns is packed once w*ratio > n
+#ifndef LINBOX_GF2_DENSE_ROW_RATIO
+#define LINBOX_GF2_DENSE_ROW_RATIO 64
+#endif
+
+// the active rows go to M4RI once half of them are packed and they are that many
+#ifndef LINBOX_GF2_DENSE_TAIL
+#define LINBOX_GF2_DENSE_TAIL 64
+#endif
+
+namespace LinBox
+{
+	namespace Protected {
+
+		/* A row of the active matrix of the structured elimination :
+		 * sorted column indices, or the single row of a BitMatrix once
+		 * it is dense enough.
+		 */
+		struct GF2ActiveRow {
+			std::vector<size_t> sparse;
+			BitMatrix           bits;
+
+			bool dense () const { return bits.rowdim () != 0; }
+
+			void pack (size_t n)
+			{
+				bits.resize (1, n);
+				BitMatrix::Word *w = bits.rowBegin (0);
+				for (std::vector<size_t>::const_iterator it = sparse.begin (); it != sparse.end (); ++it)
+					w[*it/BitMatrix::WordBits] ^= (BitMatrix::Word)1 << (*it%BitMatrix::WordBits);
+				std::vector<size_t> ().swap (sparse);
+			}
+
+			void release ()
+			{
+				std::vector<size_t> ().swap (sparse);
+				bits = BitMatrix ();
+			}
+
+			// first non zero column, from c on, n if none
+			size_t lead (size_t c, size_t n) const
+			{
+				if (!dense ())
+					return sparse.empty () ? n : sparse.front ();
+				const BitMatrix::Word *w = bits.rowBegin (0);
+				for (size_t k = c/BitMatrix::WordBits ; k < bits.rowWords () ; ++k)
+					if (w[k])
+						return k*BitMatrix::WordBits + lowestBit ((size_t)w[k]);
+				return n;
+			}
+
+			/* row += p, both with leading column c.
+			 * Sparse rows are merged, anything else is xored packed.
+			 */
+			void addin (const GF2ActiveRow &p, size_t c, size_t n, size_t packWeight)
+			{
+				if (!dense () && !p.dense ()) {
+					std::vector<size_t> s;
+					s.reserve (sparse.size () + p.sparse.size ());
+					std::set_symmetric_difference (sparse.begin (), sparse.end (),
+								       p.sparse.begin (), p.sparse.end (),
+								       std::back_inserter (s));
+					sparse.swap (s);
+					if (sparse.size () > packWeight)
+						pack (n);
+					return;
+				}
+				if (!dense ())
+					pack (n);
+				BitMatrix::Word *w = bits.rowBegin (0);
+				if (p.dense ()) {
+					const size_t w0 = (c/BitMatrix::WordBits)/BitMatrix::RowAlign*BitMatrix::RowAlign;
+					bitRowAddin (w+w0, p.bits.rowBegin (0)+w0, bits.stride ()-w0);
+				}
+				else
+					for (std::vector<size_t>::const_iterator it = p.sparse.begin (); it != p.sparse.end (); ++it)
+						w[*it/BitMatrix::WordBits] ^= (BitMatrix::Word)1 << (*it%BitMatrix::WordBits);
+			}
+		};
+
+		/* Removes, while there are any,
+		 * - the rows of weight one e_j, deleting j from the other rows ;
+		 * - the columns of weight one, with their row ;
+		 * - the columns of weight two, adding the lighter of their rows
+		 *   to the other one, then dropping it.
+		 * Each removal is one pivot. Rows left are the alive ones.
+		 * @return the number of pivots.
+		 */
+		inline size_t gf2StructuredFilter (std::vector<std::vector<size_t> > &R,
+						    std::vector<size_t> &count,
+						    std::vector<std::vector<size_t> > &colRows,
+						    std::vector<char> &alive)
+		{
+			const size_t Ni = R.size (), Nj = count.size ();
+			std::vector<size_t> colWork, rowWork;
+			for (size_t j = 0 ; j < Nj ; ++j)
+				if (count[j] == 1 || count[j] == 2)
+					colWork.push_back (j);
+			for (size_t i = 0 ; i < Ni ; ++i)
+				if (R[i].size () == 1)
+					rowWork.push_back (i);
+
+			size_t rank = 0;
+			std::vector<size_t> held (2), r1;
+			while (!colWork.empty () || !rowWork.empty ()) {
+				if (!rowWork.empty ()) {
+					const size_t i = rowWork.back ();
+					rowWork.pop_back ();
+					if (!alive[i] || R[i].size () != 1)
+						continue;
+					const size_t j = R[i][0];
+					for (std::vector<size_t>::const_iterator it = colRows[j].begin (); it != colRows[j].end (); ++it) {
+						if (*it == i || !alive[*it])
+							continue;
+						std::vector<size_t> &x = R[*it];
+						std::vector<size_t>::iterator e = std::lower_bound (x.begin (), x.end (), j);
+						if (e == x.end () || *e != j)
+							continue;
+						x.erase (e);
+						if (x.size () == 1)
+							rowWork.push_back (*it);
+					}
+					count[j] = 0;
+					std::vector<size_t> ().swap (colRows[j]);
+					alive[i] = 0;
+					R[i].clear ();
+					++rank;
+					continue;
+				}
+
+				const size_t j = colWork.back ();
+				colWork.pop_back ();
+				if (count[j] != 1 && count[j] != 2)
+					continue;
+
+				// the count[j] alive rows holding j
+				size_t h = 0;
+				for (std::vector<size_t>::const_iterator it = colRows[j].begin (); h < count[j] && it != colRows[j].end (); ++it)
+					if (alive[*it] && std::binary_search (R[*it].begin (), R[*it].end (), j)
+					    && (h == 0 || held[0] != *it))
+						held[h++] = *it;
+
+				size_t i1 = held[0];
+				if (count[j] == 2) {
+					// the lighter row is the pivot, added to the other one
+					size_t i2 = held[1];
+					if (R[i2].size () < R[i1].size ())
+						std::swap (i1, i2);
+					std::vector<size_t> &x = R[i2];
+					std::vector<size_t> s;
+					s.reserve (x.size () + R[i1].size ());
+					std::set_symmetric_difference (x.begin (), x.end (), R[i1].begin (), R[i1].end (),
+								       std::back_inserter (s));
+					for (std::vector<size_t>::const_iterator it = R[i1].begin (); it != R[i1].end (); ++it) {
+						const size_t k = *it;
+						if (std::binary_search (x.begin (), x.end (), k))
+							--count[k];
+						else {
+							++count[k];
+							colRows[k].push_back (i2);
+						}
+					}
+					x.swap (s);
+					if (x.size () == 1)
+						rowWork.push_back (i2);
+				}
+
+				// drops row i1, its columns lose one entry
+				for (std::vector<size_t>::const_iterator it = R[i1].begin (); it != R[i1].end (); ++it) {
+					const size_t k = *it;
+					--count[k];
+					if (count[k] == 1 || count[k] == 2)
+						colWork.push_back (k);
+				}
+				alive[i1] = 0;
+				std::vector<size_t> ().swap (R[i1]);
+				++rank;
+			}
+			return rank;
+		}
+
+	} // Protected
+
+	template <class SparseSeqMatrix>
+	inline size_t&
+	GaussDomain<GF2>::InPlaceStructuredPivoting (size_t &Rank,
+						     bool          &determinant,
+						     SparseSeqMatrix        &LigneA,
+						     size_t Ni,
+						     size_t Nj) const
+	{
+		commentator().start ("Structured Gaussian elimination over GF2",
+				     "ISPGF2", Ni);
+
+		// index lists, sorted, and the rows of each column
+		std::vector<std::vector<size_t> > R (Ni);
+		std::vector<size_t> count (Nj, 0);
+		std::vector<std::vector<size_t> > colRows (Nj);
+		for (size_t i = 0 ; i < Ni ; ++i) {
+			R[i].assign (LigneA[i].begin (), LigneA[i].end ());
+			LigneA[i].clear ();
+			std::sort (R[i].begin (), R[i].end ());
+			R[i].erase (std::unique (R[i].begin (), R[i].end ()), R[i].end ());
+			for (std::vector<size_t>::const_iterator it = R[i].begin (); it != R[i].end (); ++it) {
+				++count[*it];
+				colRows[*it].push_back (i);
+			}
+		}
+
+		std::vector<char> alive (Ni, 1);
+		Rank = Protected::gf2StructuredFilter (R, count, colRows, alive);
+		std::vector<std::vector<size_t> > ().swap (colRows);
+
+		// remaining columns, sparsest first
+		std::vector<size_t> cols;
+		for (size_t j = 0 ; j < Nj ; ++j)
+			if (count[j])
+				cols.push_back (j);
+		std::stable_sort (cols.begin (), cols.end (),
+				  [&count] (size_t a, size_t b) { return count[a] < count[b]; });
+		const size_t nc = cols.size ();
+		std::vector<size_t> label (Nj);
+		for (size_t t = 0 ; t < nc ; ++t)
+			label[cols[t]] = t;
+
+		commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+		<< Rank << " pivots by singletons and doubletons, "
+		<< nc << " columns left" << std::endl;
+
+		// active rows, bucketed by leading column
+		const size_t packWeight = nc/LINBOX_GF2_DENSE_ROW_RATIO;
+		std::vector<Protected::GF2ActiveRow> rows;
+		std::vector<std::vector<size_t> > bucket (nc);
+		for (size_t i = 0 ; i < Ni ; ++i) {
+			if (!alive[i] || R[i].empty ())
+				continue;
+			rows.push_back (Protected::GF2ActiveRow ());
+			Protected::GF2ActiveRow &x = rows.back ();
+			x.sparse.swap (R[i]);
+			for (std::vector<size_t>::iterator it = x.sparse.begin (); it != x.sparse.end (); ++it)
+				*it = label[*it];
+			std::sort (x.sparse.begin (), x.sparse.end ());
+			if (x.sparse.size () > packWeight)
+				x.pack (nc);
+			bucket[x.lead (0, nc)].push_back (rows.size ()-1);
+		}
+		std::vector<std::vector<size_t> > ().swap (R);
+
+		size_t liveRows = rows.size (), denseRows = 0;
+		for (size_t t = 0 ; t < rows.size () ; ++t)
+			denseRows += rows[t].dense ();
+
+		std::vector<size_t> lead;
+		std::vector<char> wasDense;
+		for (size_t c = 0 ; c < nc ; ++c) {
+			// mostly dense tail : M4RI on the rows left
+			if (liveRows >= LINBOX_GF2_DENSE_TAIL && 2*denseRows >= liveRows) {
+				BitMatrix B (GF2 (), liveRows, nc);
+				for (size_t b = c, t = 0 ; b < nc ; ++b)
+					for (std::vector<size_t>::const_iterator it = bucket[b].begin (); it != bucket[b].end (); ++it, ++t) {
+						Protected::GF2ActiveRow &x = rows[*it];
+						if (!x.dense ())
+							x.pack (nc);
+						std::copy (x.bits.rowBegin (0), x.bits.rowBegin (0)+x.bits.stride (), B.rowBegin (t));
+						x.release ();
+					}
+				commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+				<< "Dense ending on " << liveRows << " x " << nc-c << std::endl;
+				Rank += BitMatrixDomain ().rankInPlace (B);
+				break;
+			}
+
+			std::vector<size_t> &Bc = bucket[c];
+			if (Bc.empty ())
+				continue;
+
+			// pivot : the sparsest row
+			size_t best = 0;
+			for (size_t t = 1 ; t < Bc.size () ; ++t) {
+				const Protected::GF2ActiveRow &x = rows[Bc[t]], &y = rows[Bc[best]];
+				if (!x.dense () && (y.dense () || x.sparse.size () < y.sparse.size ()))
+					best = t;
+			}
+			std::swap (Bc[0], Bc[best]);
+			const Protected::GF2ActiveRow &P = rows[Bc[0]];
+			++Rank;
+
+			const size_t nb = Bc.size ();
+			lead.assign (nb, nc);
+			wasDense.resize (nb);
+			for (size_t t = 1 ; t < nb ; ++t)
+				wasDense[t] = rows[Bc[t]].dense ();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic) if(nb >= 64)
+#endif
+			for (size_t t = 1 ; t < nb ; ++t) {
+				Protected::GF2ActiveRow &x = rows[Bc[t]];
+				x.addin (P, c, nc, packWeight);
+				lead[t] = x.lead (c+1, nc);
+			}
+
+			for (size_t t = 1 ; t < nb ; ++t) {
+				Protected::GF2ActiveRow &x = rows[Bc[t]];
+				denseRows += (size_t)x.dense () - (size_t)wasDense[t];
+				if (lead[t] < nc)
+					bucket[lead[t]].push_back (Bc[t]);
+				else {
+					--liveRows;
+					denseRows -= x.dense ();
+					x.release ();
+				}
+			}
+			--liveRows;
+			denseRows -= rows[Bc[0]].dense ();
+			rows[Bc[0]].release ();
+			std::vector<size_t> ().swap (Bc);
+		}
+
+		determinant = (Rank == Ni) && (Rank == Nj) && Ni;
+
+		commentator().report (Commentator::LEVEL_IMPORTANT, PARTIAL_RESULT)
+		<< "Rank : " << Rank << " over GF (2)" << std::endl;
+		commentator().stop ("done", 0, "ISPGF2");
+		return Rank;
+	}
+
+} // namespace LinBox
+
+#endif // __LINBOX_gauss_structured_gf2_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
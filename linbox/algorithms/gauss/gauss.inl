@@ -45,9 +45,24 @@
 #define __LINBOX_FILLIN__
 #endif
 
-#ifdef __LINBOX_SpD_SWITCH__
 #include <linbox/matrix/dense-matrix.h>
 #include <numeric>
+
+// InPlaceLinearPivoting: active submatrix more than 5% dense --> switch to dense
+// (define it to 1 to stay sparse)
+#ifndef __LINBOX_SpD_DENSITY__
+#define __LINBOX_SpD_DENSITY__ 0.05
+#endif
+// Smaller active submatrices are finished sparse
+#ifndef __LINBOX_SpD_MINDIM__
+#define __LINBOX_SpD_MINDIM__ 64
+#endif
+// So are those whose dense copy would take more bytes than this
+#ifndef __LINBOX_SpD_MAXMEMORY__
+#define __LINBOX_SpD_MAXMEMORY__ (1UL<<30)
+#endif
+
+#ifdef __LINBOX_SpD_SWITCH__
 #  ifndef __LINBOX_SpD_MAXSPARSITY__
 // Sparsity less than 1% --> switch to dense
 #  define __LINBOX_SpD_MAXSPARSITY__ 0.01
@@ -65,7 +80,8 @@ namespace LinBox
                      _Matrix        &LigneA,
                      Perm          &P,
                      size_t Ni,
-                     size_t Nj) const
+                     size_t Nj,
+                     PivotStrategy reord) const
     {
         linbox_check( Q.coldim() == Q.rowdim() );
         linbox_check( P.coldim() == P.rowdim() );
@@ -76,6 +92,8 @@ namespace LinBox
 
         typedef typename _Matrix::Row        Vector;
         typedef typename Vector::value_type E;
+        if (reord == PivotStrategy::Structured)
+            throw LinboxError("LinBox ERROR: PivotStrategy::Structured is only for sparse elimination over GF2");
 
         // Requirements : LigneA is an array of sparse rows
         // In place (LigneA is modified)
@@ -91,6 +109,15 @@ namespace LinBox
 #endif
 
         field().assign(determinant,field().one);
+
+        // fill reducing relabelling of the columns, undone in P at the end
+        std::vector<size_t> colperm;
+        bool oddperm = false;
+        if (reord == PivotStrategy::Markowitz) {
+            FillReducingOrdering (colperm, LigneA, Ni, Nj);
+            oddperm = RelabelColumns (LigneA, colperm, Ni);
+        }
+
         // allocation of the column density
         std::vector<size_t> col_density (Nj);
 
@@ -165,12 +192,18 @@ namespace LinBox
             }
 
             if (s) {
-                // Row permutation for the sparsest row
-                for (; l < static_cast<long>(Ni); ++l) {
-                    long sl;
-                    if (((sl =(long) LigneA[(size_t)l].size ()) < s) && (sl)) {
-                        s = sl;
-                        p = l;
+                if (reord == PivotStrategy::Markowitz) {
+                    // Row permutation for the cheapest Markowitz row
+                    p = MarkowitzRow (LigneA, k, Ni, col_density);
+                }
+                else {
+                    // Row permutation for the sparsest row
+                    for (; l < static_cast<long>(Ni); ++l) {
+                        long sl;
+                        if (((sl =(long) LigneA[(size_t)l].size ()) < s) && (sl)) {
+                            s = sl;
+                            p = l;
+                        }
                     }
                 }
 
@@ -263,6 +296,15 @@ namespace LinBox
         for(std::deque<std::pair<size_t,size_t> >::const_iterator it = invQ.begin(); it!=invQ.end();++it)
             Q.permute( it->first, it->second );
 
+        if (reord == PivotStrategy::Markowitz) {
+            // A = A' Pi, with (Pi x)[perm[c]] = x[c]
+            std::vector<size_t> invperm (Nj);
+            for (size_t j = 0; j < Nj; ++j) invperm[colperm[j]] = j;
+            for (size_t j = 0; j < Nj; ++j)
+                P.getStorage()[j] = (long)invperm[(size_t)P.getStorage()[j]];
+            if (oddperm) field().negin(determinant);
+        }
+
 
         std::ostream& rep = commentator().report (Commentator::LEVEL_IMPORTANT, PARTIAL_RESULT);
         Q.write(rep << "Q:= ", Tag::FileFormat::Maple) << ':' << std::endl;
@@ -484,6 +526,113 @@ namespace LinBox
         return Rank+=R2;
     }
 
+    template <class _Field>
+    template <class D> inline bool
+    GaussDomain<_Field>::SwitchToDense (const D &columns,
+                                        size_t k,
+                                        size_t Rank,
+                                        size_t Ni,
+                                        size_t Nj) const
+    {
+        if (! _denseSwitch)
+            return false;
+        const size_t sNi = Ni-k, sNj = Nj-Rank;
+        if ((sNi < __LINBOX_SpD_MINDIM__) || (sNj < __LINBOX_SpD_MINDIM__))
+            return false;
+        if ((double)sNi * (double)sNj * (double)sizeof(Element) > (double)__LINBOX_SpD_MAXMEMORY__)
+            return false;
+        // columns[j] counts the entries of column j in rows k..Ni-1
+        const size_t nbelem = std::accumulate(columns.begin()+(long)Rank, columns.end(), (size_t)0);
+        return (double)nbelem > __LINBOX_SpD_DENSITY__ * (double)sNi * (double)sNj;
+    }
+
+    template <class _Field>
+    template <class _Matrix> inline size_t&
+    GaussDomain<_Field>::DenseLinearPivoting (size_t &Rank,
+                                              Element        &determinant,
+                                              _Matrix         &LigneA,
+                                              size_t k,
+                                              size_t Ni,
+                                              size_t Nj,
+                                              std::true_type) const
+    {
+        const size_t sNi=Ni-k, sNj=Nj-Rank;
+        commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+        << "Dense switch: " << sNi << 'x' << sNj << " at rank " << Rank << std::endl;
+
+        BlasMatrix<_Field> A(this->field(), sNi, sNj);
+        for(size_t di=k;di<Ni;++di) {
+            for(size_t dj=0;dj<LigneA[di].size();++dj)
+                A.setEntry(di-k,LigneA[di][dj].first-Rank, LigneA[di][dj].second);
+            LigneA[di].resize(0);
+        }
+
+        std::vector<size_t> P2(sNi,0), Q2(sNj,0);
+        size_t R2 = FFPACK::PLUQ(this->field(), FFLAS::FflasNonUnit, sNi, sNj, A.getPointer(), sNj, &P2[0], &Q2[0]);
+
+            // det(A) = det(P2) det(U2) det(Q2)
+        for(size_t i=0; i<sNi; ++i)
+            if (i != P2[i]) this->field().negin(determinant);
+        for(size_t j=0; j<sNj; ++j)
+            if (j != Q2[j]) this->field().negin(determinant);
+        for(size_t i=0; i<R2; ++i)
+            this->field().mulin(determinant,A.getEntry(i,i));
+
+        return Rank+=R2;
+    }
+
+    template <class _Field>
+    template <class _Matrix, class Perm> inline size_t&
+    GaussDomain<_Field>::DenseLinearPivoting (size_t &Rank,
+                                              Element        &determinant,
+                                              _Matrix         &LigneA,
+                                              Perm           &P,
+                                              size_t k,
+                                              size_t Ni,
+                                              size_t Nj,
+                                              std::true_type) const
+    {
+        typedef typename _Matrix::Row        Vector;
+        typedef typename Vector::value_type E;
+        typedef typename E::first_type E1;
+
+        const size_t sNi=Ni-k, sNj=Nj-Rank;
+        commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+        << "Dense switch: " << sNi << 'x' << sNj << " at rank " << Rank << std::endl;
+
+        BlasMatrix<_Field> A(this->field(), sNi, sNj);
+        for(size_t di=k;di<Ni;++di) {
+            for(size_t dj=0;dj<LigneA[di].size();++dj)
+                A.setEntry(di-k,LigneA[di][dj].first-Rank, LigneA[di][dj].second);
+            LigneA[di].resize(0);
+        }
+
+        std::vector<size_t> P2(sNi,0), Q2(sNj,0);
+        size_t R2 = FFPACK::PLUQ(this->field(), FFLAS::FflasNonUnit, sNi, sNj, A.getPointer(), sNj, &P2[0], &Q2[0]);
+
+        for(size_t i=0; i<sNi; ++i)
+            if (i != P2[i]) this->field().negin(determinant);
+
+            // Put U2 in rows k..k+R2-1, its columns are those of A Q2^T
+        for(size_t i=0; i<R2; ++i) {
+            this->field().mulin(determinant,A.getEntry(i,i));
+            for(size_t j=i; j<sNj; ++j)
+                if (!this->field().isZero(A.getEntry(i,j)))
+                    LigneA[k+i].push_back(E((E1)(Rank+j),A.getEntry(i,j)));
+        }
+
+            // Right-Trans: previous rows and P follow Q2^T
+        for (size_t j=0;j<sNj;++j)
+            if(j != Q2[j]) {
+                this->field().negin(determinant);
+                P.permute(Rank+j,Rank+Q2[j]);
+                for (size_t l=0; l<k; ++l)
+                    permute( LigneA[l], Rank+j+1, (long)(Rank+Q2[j]));
+            }
+
+        return Rank+=R2;
+    }
+
 
     template <class _Field>
     template <class _Matrix> inline size_t&
@@ -491,8 +640,11 @@ namespace LinBox
                             Element        &determinant,
                             _Matrix         &LigneA,
                             size_t   Ni,
-                            size_t   Nj) const
+                            size_t   Nj,
+                            PivotStrategy reord) const
     {
+        if (reord == PivotStrategy::Structured)
+            throw LinboxError("LinBox ERROR: PivotStrategy::Structured is only for sparse elimination over GF2");
         typedef typename _Matrix::Row        Vector;
 
         // Requirements : LigneA is an array of sparse rows
@@ -511,6 +663,13 @@ namespace LinBox
         field().assign(determinant,field().one);
         Vector Vzer(0) ;
 
+        bool oddperm = false;
+        if (reord == PivotStrategy::Markowitz) {
+            std::vector<size_t> colperm;
+            FillReducingOrdering (colperm, LigneA, Ni, Nj);
+            oddperm = RelabelColumns (LigneA, colperm, Ni);
+        }
+
         // allocation of the column density
         std::vector<size_t> col_density (Nj);
 
@@ -523,6 +682,9 @@ namespace LinBox
         long c;
         Rank = 0;
 
+        typedef typename std::is_base_of<Givaro::FiniteRingInterface<Element>,_Field>::type DenseSwitch;
+        long densek = -1;
+
 #ifdef __LINBOX_OFTEN__
         long sstep = last/40;
         if (sstep > __LINBOX_OFTEN__) sstep = __LINBOX_OFTEN__;
@@ -531,6 +693,11 @@ namespace LinBox
 #endif
         // Elimination steps with reordering
         for (long k = 0; k < last; ++k) {
+            if (DenseSwitch::value && SwitchToDense (col_density, (size_t)k, Rank, Ni, Nj)) {
+                densek = k;
+                break;
+            }
+
             long p = k, s = (long)LigneA[(size_t)k].size ();
 
 #ifdef __LINBOX_FILLIN__
@@ -556,12 +723,18 @@ namespace LinBox
 
             if (s) {
                 size_t l;
-                // Row permutation for the sparsest row
-                for (l = (size_t)k + 1; l < (size_t)Ni; ++l) {
-                long sl;
-                    if (((sl = (long)LigneA[(size_t)l].size ()) < s) && (sl)) {
-                        s = sl;
-                        p = (long)l;
+                if (reord == PivotStrategy::Markowitz) {
+                    // Row permutation for the cheapest Markowitz row
+                    p = MarkowitzRow (LigneA, k, Ni, col_density);
+                }
+                else {
+                    // Row permutation for the sparsest row
+                    for (l = (size_t)k + 1; l < (size_t)Ni; ++l) {
+                        long sl;
+                        if (((sl = (long)LigneA[(size_t)l].size ()) < s) && (sl)) {
+                            s = sl;
+                            p = (long)l;
+                        }
                     }
                 }
 
@@ -590,7 +763,10 @@ namespace LinBox
 
         }//for k
 
-        SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
+        if (densek >= 0)
+            DenseLinearPivoting (Rank, determinant, LigneA, (size_t)densek, Ni, Nj, DenseSwitch());
+        else
+            SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
 
 #ifdef __LINBOX_COUNT__
         nbelem += LigneA[(size_t)last].size ();
@@ -610,6 +786,8 @@ namespace LinBox
 
         integer card;
 
+        if (oddperm) field().negin(determinant);
+
         if ((Rank < Ni) || (Rank < Nj) || (Ni == 0) || (Nj == 0))
             field().assign(determinant,field().zero);
 
@@ -633,8 +811,11 @@ namespace LinBox
                             _Matrix         &LigneA,
                             Perm           &P,
                             size_t   Ni,
-                            size_t   Nj) const
+                            size_t   Nj,
+                            PivotStrategy reord) const
     {
+        if (reord == PivotStrategy::Structured)
+            throw LinboxError("LinBox ERROR: PivotStrategy::Structured is only for sparse elimination over GF2");
         typedef typename _Matrix::Row        Vector;
 
         // Requirements : LigneA is an array of sparse rows
@@ -651,6 +832,14 @@ namespace LinBox
 #endif
 
         field().assign(determinant,field().one);
+
+        std::vector<size_t> colperm;
+        bool oddperm = false;
+        if (reord == PivotStrategy::Markowitz) {
+            FillReducingOrdering (colperm, LigneA, Ni, Nj);
+            oddperm = RelabelColumns (LigneA, colperm, Ni);
+        }
+
         // allocation of the column density
         std::vector<size_t> col_density (Nj);
 
@@ -663,6 +852,9 @@ namespace LinBox
         long c;
         Rank = 0;
 
+        typedef typename std::is_base_of<Givaro::FiniteRingInterface<Element>,_Field>::type DenseSwitch;
+        long densek = -1;
+
 #ifdef __LINBOX_OFTEN__
         long sstep = last/40;
         if (sstep > __LINBOX_OFTEN__) sstep = __LINBOX_OFTEN__;
@@ -671,6 +863,11 @@ namespace LinBox
 #endif
         // Elimination steps with reordering
         for (long k = 0; k < last; ++k) {
+            if (DenseSwitch::value && SwitchToDense (col_density, (size_t)k, Rank, Ni, Nj)) {
+                densek = k;
+                break;
+            }
+
             long p = k, s =(long) LigneA[(size_t)k].size ();
 
 #ifdef __LINBOX_FILLIN__
@@ -700,14 +897,20 @@ namespace LinBox
 
             if (s) {
                 size_t l;
-                // Row permutation for the sparsest row
-                for (l = (size_t)k + 1; l < (size_t)Ni; ++l) {
-                long sl;
-                    if (((sl =(long) LigneA[(size_t)l].size ()) < s) && (sl)) {
-                        s = sl;
-                        p = (long)l;
-                    }
+                if (reord == PivotStrategy::Markowitz) {
+                    // Row permutation for the cheapest Markowitz row
+                    p = MarkowitzRow (LigneA, k, Ni, col_density);
+                }
+                else {
+                    // Row permutation for the sparsest row
+                    for (l = (size_t)k + 1; l < (size_t)Ni; ++l) {
+                        long sl;
+                        if (((sl = (long)LigneA[(size_t)l].size ()) < s) && (sl)) {
+                            s = sl;
+                            p = (long)l;
+                        }
                     }
+                }
 
                 if (p != k) {
                     field().negin(determinant);
@@ -738,11 +941,15 @@ namespace LinBox
 
         }//for k
 
-        SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
-        if ( (c != -1) && (c != (static_cast<long>(Rank)-1) ) ) {
-            P.permute(Rank-1,(size_t)c);
-            for (long ll=0; ll < last ; ++ll)
-                permute( LigneA[(size_t)ll], Rank, c);
+        if (densek >= 0)
+            DenseLinearPivoting (Rank, determinant, LigneA, P, (size_t)densek, Ni, Nj, DenseSwitch());
+        else {
+            SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
+            if ( (c != -1) && (c != (static_cast<long>(Rank)-1) ) ) {
+                P.permute(Rank-1,(size_t)c);
+                for (long ll=0; ll < last ; ++ll)
+                    permute( LigneA[(size_t)ll], Rank, c);
+            }
         }
 
 
@@ -764,6 +971,15 @@ namespace LinBox
 
         integer card;
 
+        if (reord == PivotStrategy::Markowitz) {
+            // A = A' Pi, with (Pi x)[perm[c]] = x[c]
+            std::vector<size_t> invperm (Nj);
+            for (size_t j = 0; j < Nj; ++j) invperm[colperm[j]] = j;
+            for (size_t j = 0; j < Nj; ++j)
+                P.getStorage()[j] = (long)invperm[(size_t)P.getStorage()[j]];
+            if (oddperm) field().negin(determinant);
+        }
+
         if ((Rank < Ni) || (Rank < Nj) || (Ni == 0) || (Nj == 0))
             field().assign(determinant,field().zero);
 
@@ -130,6 +130,16 @@ namespace LinBox {
                 simd_vect_t P = Simd::set1 (fld->characteristic());
                 simd_vect_t U = Simd::set1 (1.0/fld->characteristic());
 
+                /* two steps at a time while both are wide enough */
+                for ( ; w >= (Simd::vect_size << 1); pow += w + (w >> 1),
+                                                        f <<= 2, w >>= 2) {
+                    const size_t h = w >> 1;
+                    for (size_t i = 0; i < f; i++)
+                        for (size_t j = 0; j < h; j += Simd::vect_size)
+                            Butterfly_DIF4 (coeffs+(i<<1)*w+j, h, pow+j,
+                                                    pow+h+j, pow+w+j, P, U);
+                }
+
                 for ( ; w >= Simd::vect_size; pow += w, f <<= 1, w >>= 1) {
                     Element *Aptr = coeffs;
                     Element *Bptr = coeffs + w;
@@ -208,6 +218,15 @@ namespace LinBox {
 
                 DIT_core_firststeps (coeffs, w, f, pow, P, U, h);
 
+                /* two steps at a time while both remain */
+                for ( ; (w << 2) <= n; pow -= 6*w, w <<= 2, f >>= 2) {
+                    const Element *pow2 = pow - (w << 1);
+                    for (size_t i = 0; i < f; i += 2)
+                        for (size_t j = 0; j < w; j += Simd::vect_size)
+                            Butterfly_DIT4 (coeffs+(i<<1)*w+j, w, pow+j,
+                                                    pow2+j, pow2+w+j, P, U);
+                }
+
                 for ( ; w < n; w <<= 1, f >>= 1, pow -= w) {
                     Element *Aptr = coeffs;
                     Element *Bptr = coeffs + w;
@@ -448,6 +467,63 @@ namespace LinBox {
 #endif
             }
 
+            /* Radix-4 butterflies: two consecutive steps on the four vectors
+             * X[0], X[s], X[2s], X[3s], loaded and stored only once.
+             * DIF: steps of width 2s (alpha1 on X[0],X[2s], alpha2 on
+             *      X[s],X[3s]) then s (alpha3 on both pairs).
+             * DIT: steps of width s (alpha1 on both pairs) then 2s (alpha2
+             *      on X[0],X[2s], alpha3 on X[s],X[3s]).
+             */
+            void
+            Butterfly_DIF4 (Element *X, size_t s, const Element *alpha1,
+                            const Element *alpha2, const Element *alpha3,
+                            const simd_vect_t& P, const simd_vect_t& U) const {
+                simd_vect_t X0, X1, X2, X3, W;
+                X0 = Simd::load (X);
+                X1 = Simd::load (X + s);
+                X2 = Simd::load (X + 2*s);
+                X3 = Simd::load (X + 3*s);
+
+                W = Simd::load (alpha1);
+                Butterfly_DIF (X0, X2, W, P, U);
+                W = Simd::load (alpha2);
+                Butterfly_DIF (X1, X3, W, P, U);
+
+                W = Simd::load (alpha3);
+                Butterfly_DIF (X0, X1, W, P, U);
+                Butterfly_DIF (X2, X3, W, P, U);
+
+                Simd::store (X, X0);
+                Simd::store (X + s, X1);
+                Simd::store (X + 2*s, X2);
+                Simd::store (X + 3*s, X3);
+            }
+
+            void
+            Butterfly_DIT4 (Element *X, size_t s, const Element *alpha1,
+                            const Element *alpha2, const Element *alpha3,
+                            const simd_vect_t& P, const simd_vect_t& U) const {
+                simd_vect_t X0, X1, X2, X3, W;
+                X0 = Simd::load (X);
+                X1 = Simd::load (X + s);
+                X2 = Simd::load (X + 2*s);
+                X3 = Simd::load (X + 3*s);
+
+                W = Simd::load (alpha1);
+                Butterfly_DIT (X0, X1, W, P, U);
+                Butterfly_DIT (X2, X3, W, P, U);
+
+                W = Simd::load (alpha2);
+                Butterfly_DIT (X0, X2, W, P, U);
+                W = Simd::load (alpha3);
+                Butterfly_DIT (X1, X3, W, P, U);
+
+                Simd::store (X, X0);
+                Simd::store (X + s, X1);
+                Simd::store (X + 2*s, X2);
+                Simd::store (X + 3*s, X3);
+            }
+
             /******************************************************************/
             /* Laststeps for DIF and DIT reversed *****************************/
             /******************************************************************/
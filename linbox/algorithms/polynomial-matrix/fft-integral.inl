@@ -89,10 +89,26 @@ namespace LinBox {
                                               p(F.characteristic()), p2(p << 1),
                                               pow_w(n-1), pow_w_br(n-1),
                                               pow_wp(n-1), pow_wp_br(n-1) {
-                // TODO check size of p for integral
+                if (p > max_modulus ())
+                    throw LinBoxError ("FFT: the modulus is too large for the "
+                                       "lazy butterflies of this field type");
                 init_powers (w);
             }
 
+            /* The butterflies keep values in [0, 4p) and the Shoup quotient
+             * of x*alpha is computed from alphap = floor(alpha*2^b/p) with x
+             * in [0, 4p), which needs 4p <= 2^b: b is the bitsize of Element
+             * when Compute_t is twice as large (e.g. 62-bit primes with
+             * Modular<uint64_t, uint128_t>), half of it otherwise.
+             */
+            static Residu_t
+            max_modulus () {
+                using Compute_t = typename Field::Compute_t;
+                constexpr size_t b = sizeof (Element) == sizeof (Compute_t)
+                                        ? 4*sizeof (Element) : 8*sizeof (Element);
+                return (Residu_t (1) << (b-2)) - 1;
+            }
+
         public:
             void
             DIF (Element *coeffs) const {
@@ -205,6 +221,17 @@ namespace LinBox {
                 simd_vect_t P = Simd::set1 (fld->characteristic());
                 simd_vect_t P2 = Simd::set1 (fld->characteristic() << 1);
 
+                /* two steps at a time while both are wide enough */
+                for ( ; w >= (Simd::vect_size << 1); pow += w + (w >> 1),
+                                    powp += w + (w >> 1), f <<= 2, w >>= 2) {
+                    const size_t h = w >> 1;
+                    for (size_t i = 0; i < f; i++)
+                        for (size_t j = 0; j < h; j += Simd::vect_size)
+                            Butterfly_DIF4 (coeffs+(i<<1)*w+j, h, pow+j,
+                                            powp+j, pow+h+j, powp+h+j,
+                                            pow+w+j, powp+w+j, P, P2);
+                }
+
                 for ( ; w >= Simd::vect_size; pow += w, powp += w, f <<= 1,
                                                                    w >>= 1) {
                     Element *Aptr = coeffs;
@@ -287,6 +314,18 @@ namespace LinBox {
 
                 DIT_core_firststeps (coeffs, w, f, pow, powp, P, P2, h);
 
+                /* two steps at a time while both remain */
+                for ( ; (w << 2) <= n; pow -= 6*w, powp -= 6*w, w <<= 2,
+                                                                f >>= 2) {
+                    const Element *pow2 = pow - (w << 1);
+                    const Element *powp2 = powp - (w << 1);
+                    for (size_t i = 0; i < f; i += 2)
+                        for (size_t j = 0; j < w; j += Simd::vect_size)
+                            Butterfly_DIT4 (coeffs+(i<<1)*w+j, w, pow+j,
+                                            powp+j, pow2+j, powp2+j,
+                                            pow2+w+j, powp2+w+j, P, P2);
+                }
+
                 for ( ; w < n; w <<= 1, f >>= 1, pow -= w, powp -= w) {
                     Element *Aptr = coeffs;
                     Element *Bptr = coeffs + w;
@@ -554,6 +593,74 @@ namespace LinBox {
 #endif
             }
 
+            /* Radix-4 butterflies: two consecutive steps on the four vectors
+             * X[0], X[s], X[2s], X[3s], loaded and stored only once.
+             * DIF: steps of width 2s (alpha1 on X[0],X[2s], alpha2 on
+             *      X[s],X[3s]) then s (alpha3 on both pairs).
+             * DIT: steps of width s (alpha1 on both pairs) then 2s (alpha2
+             *      on X[0],X[2s], alpha3 on X[s],X[3s]).
+             * Input and output ranges are those of the radix-2 butterflies.
+             */
+            void
+            Butterfly_DIF4 (Element *X, size_t s,
+                            const Element *alpha1, const Element *alpha1p,
+                            const Element *alpha2, const Element *alpha2p,
+                            const Element *alpha3, const Element *alpha3p,
+                            const simd_vect_t& P, const simd_vect_t& P2) const {
+                simd_vect_t X0, X1, X2, X3, W, Wp;
+                X0 = Simd::load (X);
+                X1 = Simd::load (X + s);
+                X2 = Simd::load (X + 2*s);
+                X3 = Simd::load (X + 3*s);
+
+                W = Simd::load (alpha1);
+                Wp = Simd::load (alpha1p);
+                Butterfly_DIF (X0, X2, W, Wp, P, P2);
+                W = Simd::load (alpha2);
+                Wp = Simd::load (alpha2p);
+                Butterfly_DIF (X1, X3, W, Wp, P, P2);
+
+                W = Simd::load (alpha3);
+                Wp = Simd::load (alpha3p);
+                Butterfly_DIF (X0, X1, W, Wp, P, P2);
+                Butterfly_DIF (X2, X3, W, Wp, P, P2);
+
+                Simd::store (X, X0);
+                Simd::store (X + s, X1);
+                Simd::store (X + 2*s, X2);
+                Simd::store (X + 3*s, X3);
+            }
+
+            void
+            Butterfly_DIT4 (Element *X, size_t s,
+                            const Element *alpha1, const Element *alpha1p,
+                            const Element *alpha2, const Element *alpha2p,
+                            const Element *alpha3, const Element *alpha3p,
+                            const simd_vect_t& P, const simd_vect_t& P2) const {
+                simd_vect_t X0, X1, X2, X3, W, Wp;
+                X0 = Simd::load (X);
+                X1 = Simd::load (X + s);
+                X2 = Simd::load (X + 2*s);
+                X3 = Simd::load (X + 3*s);
+
+                W = Simd::load (alpha1);
+                Wp = Simd::load (alpha1p);
+                Butterfly_DIT (X0, X1, W, Wp, P, P2);
+                Butterfly_DIT (X2, X3, W, Wp, P, P2);
+
+                W = Simd::load (alpha2);
+                Wp = Simd::load (alpha2p);
+                Butterfly_DIT (X0, X2, W, Wp, P, P2);
+                W = Simd::load (alpha3);
+                Wp = Simd::load (alpha3p);
+                Butterfly_DIT (X1, X3, W, Wp, P, P2);
+
+                Simd::store (X, X0);
+                Simd::store (X + s, X1);
+                Simd::store (X + 2*s, X2);
+                Simd::store (X + 3*s, X3);
+            }
+
             /******************************************************************/
             /* Laststeps for DIF and DIT reversed *****************************/
             /******************************************************************/
@@ -91,6 +91,124 @@ namespace LinBox {
             return reduce(c, p);
         }
 
+        /**********************************************************************/
+        /* mulhi, mullo *******************************************************/
+        /**********************************************************************/
+        /* High and low halves of the lanewise product, with Simd's own
+         * instructions unless the elements are 64-bit integers: neither SSE
+         * nor AVX have a 64x64->128 multiplication, so the 64-bit halves are
+         * built from the 32x32->64 products of mul_epu32.
+         */
+        template <class T=vect_t,
+                  enable_if_t<!std::is_same<Element, uint64_t>::value, T>* = nullptr>
+        static inline T
+        mulhi (const vect_t& a, const vect_t& b) {
+            return Simd::mulhi (a, b);
+        }
+
+        template <class T=vect_t,
+                  enable_if_t<!std::is_same<Element, uint64_t>::value, T>* = nullptr>
+        static inline T
+        mullo (const vect_t& a, const vect_t& b) {
+            return Simd::mullo (a, b);
+        }
+
+        /* With a = ah*2^32+al and b = bh*2^32+bl, the middle sums
+         *  t = ah*bl + (al*bl >> 32) and u = al*bh + (t mod 2^32)
+         * are < 2^64, and hi = ah*bh + (t >> 32) + (u >> 32) is exact.
+         */
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+        /* Simd128<uint64_t> */
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m128i>::value, T>* = nullptr>
+        static inline T
+        mulhi (const vect_t& a, const vect_t& b) {
+            vect_t ah = _mm_srli_epi64 (a, 32);
+            vect_t bh = _mm_srli_epi64 (b, 32);
+            vect_t ll = _mm_mul_epu32 (a, b);
+            vect_t t = _mm_add_epi64 (_mm_mul_epu32 (ah, b),
+                                      _mm_srli_epi64 (ll, 32));
+            vect_t u = _mm_and_si128 (t, _mm_set1_epi64x (0xffffffff));
+            u = _mm_add_epi64 (_mm_mul_epu32 (a, bh), u);
+            vect_t h = _mm_add_epi64 (_mm_mul_epu32 (ah, bh),
+                                      _mm_srli_epi64 (t, 32));
+            return _mm_add_epi64 (h, _mm_srli_epi64 (u, 32));
+        }
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m128i>::value, T>* = nullptr>
+        static inline T
+        mullo (const vect_t& a, const vect_t& b) {
+            vect_t ah = _mm_srli_epi64 (a, 32);
+            vect_t bh = _mm_srli_epi64 (b, 32);
+            vect_t c = _mm_add_epi64 (_mm_mul_epu32 (ah, b),
+                                      _mm_mul_epu32 (a, bh));
+            c = _mm_slli_epi64 (c, 32);
+            return _mm_add_epi64 (_mm_mul_epu32 (a, b), c);
+        }
+#endif /* __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS */
+#ifdef __FFLASFFPACK_HAVE_AVX2_INSTRUCTIONS
+        /* Simd256<uint64_t> */
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m256i>::value, T>* = nullptr>
+        static inline T
+        mulhi (const vect_t& a, const vect_t& b) {
+            vect_t ah = _mm256_srli_epi64 (a, 32);
+            vect_t bh = _mm256_srli_epi64 (b, 32);
+            vect_t ll = _mm256_mul_epu32 (a, b);
+            vect_t t = _mm256_add_epi64 (_mm256_mul_epu32 (ah, b),
+                                         _mm256_srli_epi64 (ll, 32));
+            vect_t u = _mm256_and_si256 (t, _mm256_set1_epi64x (0xffffffff));
+            u = _mm256_add_epi64 (_mm256_mul_epu32 (a, bh), u);
+            vect_t h = _mm256_add_epi64 (_mm256_mul_epu32 (ah, bh),
+                                         _mm256_srli_epi64 (t, 32));
+            return _mm256_add_epi64 (h, _mm256_srli_epi64 (u, 32));
+        }
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m256i>::value, T>* = nullptr>
+        static inline T
+        mullo (const vect_t& a, const vect_t& b) {
+            vect_t ah = _mm256_srli_epi64 (a, 32);
+            vect_t bh = _mm256_srli_epi64 (b, 32);
+            vect_t c = _mm256_add_epi64 (_mm256_mul_epu32 (ah, b),
+                                         _mm256_mul_epu32 (a, bh));
+            c = _mm256_slli_epi64 (c, 32);
+            return _mm256_add_epi64 (_mm256_mul_epu32 (a, b), c);
+        }
+#endif /* __FFLASFFPACK_HAVE_AVX2_INSTRUCTIONS */
+#ifdef __FFLASFFPACK_HAVE_AVX512F_INSTRUCTIONS
+        /* Simd512<uint64_t> */
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m512i>::value, T>* = nullptr>
+        static inline T
+        mulhi (const vect_t& a, const vect_t& b) {
+            vect_t ah = _mm512_srli_epi64 (a, 32);
+            vect_t bh = _mm512_srli_epi64 (b, 32);
+            vect_t ll = _mm512_mul_epu32 (a, b);
+            vect_t t = _mm512_add_epi64 (_mm512_mul_epu32 (ah, b),
+                                         _mm512_srli_epi64 (ll, 32));
+            vect_t u = _mm512_and_si512 (t, _mm512_set1_epi64 (0xffffffff));
+            u = _mm512_add_epi64 (_mm512_mul_epu32 (a, bh), u);
+            vect_t h = _mm512_add_epi64 (_mm512_mul_epu32 (ah, bh),
+                                         _mm512_srli_epi64 (t, 32));
+            return _mm512_add_epi64 (h, _mm512_srli_epi64 (u, 32));
+        }
+        template <class T=vect_t, enable_if_t<std::is_same<Element, uint64_t>::value
+                            && std::is_same<vect_t, __m512i>::value, T>* = nullptr>
+        static inline T
+        mullo (const vect_t& a, const vect_t& b) {
+#ifdef __FFLASFFPACK_HAVE_AVX512DQ_INSTRUCTIONS
+            return _mm512_mullo_epi64 (a, b);
+#else
+            vect_t ah = _mm512_srli_epi64 (a, 32);
+            vect_t bh = _mm512_srli_epi64 (b, 32);
+            vect_t c = _mm512_add_epi64 (_mm512_mul_epu32 (ah, b),
+                                         _mm512_mul_epu32 (a, bh));
+            c = _mm512_slli_epi64 (c, 32);
+            return _mm512_add_epi64 (_mm512_mul_epu32 (a, b), c);
+#endif
+        }
+#endif /* __FFLASFFPACK_HAVE_AVX512F_INSTRUCTIONS */
+
         /**********************************************************************/
         /* mul_mod ************************************************************/
         /**********************************************************************/
@@ -123,9 +241,9 @@ namespace LinBox {
         static inline T
         mul_mod (const vect_t& a, const vect_t& b, const vect_t& p,
                  const vect_t& bp) {
-            vect_t q = Simd::mulhi(a,bp);
-            vect_t c = Simd::mullo(a,b);
-            vect_t t = Simd::mullo(q,p);
+            vect_t q = mulhi(a,bp);
+            vect_t c = mullo(a,b);
+            vect_t t = mullo(q,p);
             return Simd::sub(c,t);
         }
 
@@ -466,6 +584,55 @@ namespace LinBox {
             r2 = _mm256_permute4x64_epi64 (r2, 0xd8);
         }
 #endif /* __FFLASFFPACK_HAVE_AVX2_INSTRUCTIONS */
+
+        /******************************************************************/
+        /* unpacklohi and pack for AVX-512 ********************************/
+        /******************************************************************/
+        /* Only the 8-lane types, the 16-lane ones use the generic laststeps
+         * and firststeps.
+         */
+#ifdef __FFLASFFPACK_HAVE_AVX512F_INSTRUCTIONS
+        /* Simd512<double> */
+        template <typename S = Simd,
+                    enable_if_same_t<S, Simd512<double>>* = nullptr>
+        static inline void
+        unpacklohi (vect_t& r1, vect_t& r2, const vect_t a, const vect_t b) {
+            const __m512i idx1 = _mm512_set_epi64 (11, 3, 10, 2, 9, 1, 8, 0);
+            const __m512i idx2 = _mm512_set_epi64 (15, 7, 14, 6, 13, 5, 12, 4);
+            r1 = _mm512_permutex2var_pd (a, idx1, b);
+            r2 = _mm512_permutex2var_pd (a, idx2, b);
+        }
+        /* Simd512<uint64_t> */
+        template <typename S = Simd,
+                    enable_if_same_t<S, Simd512<uint64_t>>* = nullptr>
+        static inline void
+        unpacklohi (vect_t& r1, vect_t& r2, const vect_t a, const vect_t b) {
+            const __m512i idx1 = _mm512_set_epi64 (11, 3, 10, 2, 9, 1, 8, 0);
+            const __m512i idx2 = _mm512_set_epi64 (15, 7, 14, 6, 13, 5, 12, 4);
+            r1 = _mm512_permutex2var_epi64 (a, idx1, b);
+            r2 = _mm512_permutex2var_epi64 (a, idx2, b);
+        }
+        /* Simd512<double> */
+        template <typename S = Simd,
+                    enable_if_same_t<S, Simd512<double>>* = nullptr>
+        static inline void
+        pack (vect_t& r1, vect_t& r2, const vect_t a, const vect_t b) {
+            const __m512i idx1 = _mm512_set_epi64 (14, 12, 10, 8, 6, 4, 2, 0);
+            const __m512i idx2 = _mm512_set_epi64 (15, 13, 11, 9, 7, 5, 3, 1);
+            r1 = _mm512_permutex2var_pd (a, idx1, b);
+            r2 = _mm512_permutex2var_pd (a, idx2, b);
+        }
+        /* Simd512<uint64_t> */
+        template <typename S = Simd,
+                    enable_if_same_t<S, Simd512<uint64_t>>* = nullptr>
+        static inline void
+        pack (vect_t& r1, vect_t& r2, const vect_t a, const vect_t b) {
+            const __m512i idx1 = _mm512_set_epi64 (14, 12, 10, 8, 6, 4, 2, 0);
+            const __m512i idx2 = _mm512_set_epi64 (15, 13, 11, 9, 7, 5, 3, 1);
+            r1 = _mm512_permutex2var_epi64 (a, idx1, b);
+            r2 = _mm512_permutex2var_epi64 (a, idx2, b);
+        }
+#endif /* __FFLASFFPACK_HAVE_AVX512F_INSTRUCTIONS */
     };
 }
 
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2019 Cyril Bouvier, Pascal Giorgi, Romain Lebreton
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#ifndef __LINBOX_fft_truncated_INL
+#define __LINBOX_fft_truncated_INL
+
+#include <vector>
+#include <algorithm>
+#include <givaro/givpower.h>
+
+/* Number of power of two blocks of a truncated transform: the size is rounded
+ * up to a multiple of 2^(K-FFT_TRUNCATED_LEVELS) for a transform of length
+ * at most 2^K */
+#ifndef FFT_TRUNCATED_LEVELS
+#define FFT_TRUNCATED_LEVELS 4
+#endif
+
+namespace LinBox {
+
+    /* Truncated Fourier transform of length L <= 2^K, in the spirit of van der
+     * Hoeven's TFT: the evaluation points are the first L roots of unity of
+     * order 2^K in bitreversed order, that is the roots of
+     *      M = (x^d_0 - z_0) (x^d_1 - z_1) ... (x^d_r - z_r)
+     * where d_0 > d_1 > ... > d_r are the binary digits of L and the z_t are
+     * powers of the 2^K-th root w.
+     *
+     * Each block x^d_t - z_t is evaluated by a full FFT of size d_t (with the
+     * simd kernels of fft-integral.inl or fft-floating.inl) after a reduction
+     * modulo x^d_t - z_t and a twist by the powers of a d_t-th root of z_t.
+     * The interpolation recombines the residues by Chinese remaindering, which
+     * only needs a scalar per block since x^d_s is a constant modulo
+     * x^d_t - z_t for s < t.
+     *
+     * The transposed maps are provided as well, they give the middle product
+     * without zero padding to 2^K (see midproduct_fft in
+     * matpoly-mult-fft-wordsize-fast.inl).
+     *
+     * All the arrays are of length size(), and the values are stored block
+     * after block, each block in bitreversed order.
+     */
+    template <typename Field>
+    class TruncatedFFT {
+        private:
+            using Element = typename Field::Element;
+
+            const Field *fld;
+            size_t l2n;  /* log2 of the enclosing power of two */
+            size_t len;  /* number of points */
+            std::vector<size_t> d, S;            /* block sizes and offsets */
+            std::vector<Element> z, kappa, invd; /* x^d_t-z_t, CRT constants, 1/d_t */
+            std::vector<std::vector<Element> > tw, itw; /* powers of theta_t and theta_t^-1 */
+            std::vector<FFT<Field> > fw, fi;     /* FFT of size d_t with roots w_t and w_t^-1 */
+
+        public:
+            /* Return the smallest admissible length >= l and its enclosing
+             * log2 size in lpts */
+            static size_t
+            admissible_size (size_t l, size_t &lpts) {
+                size_t pts = 1;
+                for (lpts = 0; pts < l; pts <<= 1, lpts++) ;
+                if (lpts < FFT_TRUNCATED_LEVELS + 4)
+                    return pts;
+                size_t g = pts >> FFT_TRUNCATED_LEVELS;
+                return ((l + g - 1) / g) * g;
+            }
+
+            /* l must be admissible for k (see admissible_size) */
+            TruncatedFFT (const Field& F, size_t k, size_t l)
+                                            : fld(&F), l2n(k), len(l) {
+                const size_t pts = (size_t)1 << k;
+                if (!k || l > pts || 2*l <= pts)
+                    throw LinBoxError ("TruncatedFFT: bad length");
+                const size_t g = (k < FFT_TRUNCATED_LEVELS + 4) ? pts
+                                            : (pts >> FFT_TRUNCATED_LEVELS);
+                if (l % g)
+                    throw LinBoxError ("TruncatedFFT: length is not admissible");
+
+                Element w = FFT_utils::compute_primitive_root (F, k);
+                Element winv;
+                F.inv (winv, w);
+
+                size_t nb = 0;
+                for (size_t b = pts; b; b >>= 1)
+                    if (l & b) nb++;
+                d.reserve (nb); S.reserve (nb); z.reserve (nb);
+                kappa.reserve (nb); invd.reserve (nb);
+                tw.reserve (nb); itw.reserve (nb);
+                fw.reserve (nb); fi.reserve (nb);
+
+                size_t s = 0;
+                for (size_t j = k + 1; j-- > 0; ) {
+                    const size_t b = (size_t)1 << j;
+                    if (!(l & b))
+                        continue;
+                    /* points w^(e+(2^k/b)u) for e = bitreverse(s) */
+                    Element wt, wti, theta, thetai, zt, tmp;
+                    Givaro::dom_power (wt, w, pts / b, F);
+                    Givaro::dom_power (wti, winv, pts / b, F);
+                    const size_t e = FFT_utils::bitreverse (s, k);
+                    Givaro::dom_power (theta, w, e, F);
+                    Givaro::dom_power (thetai, winv, e, F);
+                    Givaro::dom_power (zt, theta, b, F);
+
+                    /* kappa = 1 / prod_{s<t} (x^d_s - z_s) mod x^b - zt */
+                    Element kt = F.one;
+                    for (size_t t = 0; t < d.size(); t++) {
+                        Givaro::dom_power (tmp, zt, d[t] / b, F);
+                        F.subin (tmp, z[t]);
+                        F.mulin (kt, tmp);
+                    }
+                    F.invin (kt);
+
+                    std::vector<Element> p(b), pi(b);
+                    p[0] = F.one; pi[0] = F.one;
+                    for (size_t i = 1; i < b; i++) {
+                        F.mul (p[i], p[i-1], theta);
+                        F.mul (pi[i], pi[i-1], thetai);
+                    }
+
+                    F.init (tmp, (uint64_t) b);
+                    F.invin (tmp);
+
+                    d.push_back (b); S.push_back (s); z.push_back (zt);
+                    kappa.push_back (kt); invd.push_back (tmp);
+                    tw.push_back (p); itw.push_back (pi);
+                    fw.emplace_back (F, j, wt);
+                    fi.emplace_back (F, j, wti);
+                    s += b;
+                }
+            }
+
+            const Field &
+            field () const {
+                return *fld;
+            }
+
+            /* number of points */
+            size_t
+            size () const {
+                return len;
+            }
+
+            /* log2 of the enclosing power of two */
+            size_t
+            log2_size () const {
+                return l2n;
+            }
+
+            /* Evaluation: coefficients (of degree < size()) to values */
+            void
+            direct (Element *v) const {
+                if (d.size () == 1) {
+                    fw[0].FFT_direct (v);
+                    return;
+                }
+                std::vector<Element> u (v, v + len);
+                for (size_t t = 0; t < d.size (); t++) {
+                    Element *o = v + S[t];
+                    fold (o, u.data (), len, t);
+                    twist (o, tw[t]);
+                    fw[t].FFT_direct (o);
+                }
+            }
+
+            /* Interpolation: values to coefficients, inverse of direct */
+            void
+            inverse (Element *v) const {
+                for (size_t t = 0; t < d.size (); t++) {
+                    Element *o = v + S[t];
+                    fi[t].FFT_inverse (o);
+                    twist (o, itw[t], invd[t]);
+                }
+                if (d.size () == 1)
+                    return;
+
+                /* c = R_0 + P_0 h_1 + P_0 P_1 h_2 + ... where the residue R_t
+                 * modulo x^d_t - z_t is stored at v+S[t] */
+                std::vector<Element> h (len);
+                for (size_t t = 1; t < d.size (); t++) {
+                    const size_t D = S[t], b = d[t];
+                    Element *R = v + D;
+                    /* h = kappa (R - c mod x^b - z) */
+                    fold (h.data (), v, D, t);
+                    for (size_t i = 0; i < b; i++) {
+                        fld->sub (h[i], R[i], h[i]);
+                        fld->mulin (h[i], kappa[t]);
+                    }
+                    /* c += P_{t-1} h */
+                    size_t l = b;
+                    for (size_t s = 0; s < t; s++)
+                        l = mul_binomial (h.data (), l, s);
+                    for (size_t i = 0; i < D; i++)
+                        fld->addin (v[i], h[i]);
+                    for (size_t i = 0; i < b; i++)
+                        R[i] = h[D+i];
+                }
+            }
+
+            /* Transpose of direct */
+            void
+            direct_transposed (Element *v) const {
+                if (d.size () == 1) {
+                    fw[0].FFT_inverse (v);
+                    return;
+                }
+                std::vector<Element> r (len, fld->zero);
+                for (size_t t = 0; t < d.size (); t++) {
+                    Element *o = v + S[t];
+                    fw[t].FFT_inverse (o);
+                    twist (o, tw[t]);
+                    unfold_add (r.data (), len, o, t, fld->one);
+                }
+                std::copy (r.begin (), r.end (), v);
+            }
+
+            /* Transpose of inverse */
+            void
+            inverse_transposed (Element *v) const {
+                if (d.size () > 1) {
+                    std::vector<Element> h (len);
+                    for (size_t t = d.size (); --t > 0; ) {
+                        const size_t D = S[t], b = d[t];
+                        /* u = kappa P_{t-1}^T y */
+                        std::copy (v, v + D + b, h.begin ());
+                        size_t l = D + b;
+                        for (size_t s = t; s-- > 0; )
+                            l = mul_binomial_transposed (h.data (), l, s);
+                        for (size_t i = 0; i < b; i++)
+                            fld->mulin (h[i], kappa[t]);
+                        /* y[0..D) -= unfold (u), and y[D..D+b) = u */
+                        Element mone;
+                        fld->neg (mone, fld->one);
+                        unfold_add (v, D, h.data (), t, mone);
+                        std::copy (h.begin (), h.begin () + b, v + D);
+                    }
+                }
+                for (size_t t = 0; t < d.size (); t++) {
+                    Element *o = v + S[t];
+                    twist (o, itw[t], invd[t]);
+                    fi[t].FFT_direct (o);
+                }
+            }
+
+        private:
+            /* o = u mod x^d_t - z_t, u of length l */
+            void
+            fold (Element *o, const Element *u, size_t l, size_t t) const {
+                const size_t b = d[t];
+                std::fill (o, o + b, fld->zero);
+                for (size_t q = (l + b - 1) / b; q-- > 0; ) {
+                    const Element *uq = u + q*b;
+                    const size_t e = std::min (b, l - q*b);
+                    for (size_t i = 0; i < e; i++)
+                        fld->axpy (o[i], o[i], z[t], uq[i]);
+                    for (size_t i = e; i < b; i++)
+                        fld->mulin (o[i], z[t]);
+                }
+            }
+
+            /* r[i+q d_t] += alpha z_t^q o[i] for i+q d_t < l */
+            void
+            unfold_add (Element *r, size_t l, const Element *o, size_t t,
+                                                    const Element &alpha) const {
+                const size_t b = d[t];
+                Element c = alpha, tmp;
+                for (size_t q = 0; q*b < l; q++) {
+                    const size_t e = std::min (b, l - q*b);
+                    for (size_t i = 0; i < e; i++) {
+                        fld->mul (tmp, c, o[i]);
+                        fld->addin (r[q*b+i], tmp);
+                    }
+                    fld->mulin (c, z[t]);
+                }
+            }
+
+            /* o[i] *= p[i] (*s) */
+            void
+            twist (Element *o, const std::vector<Element> &p) const {
+                for (size_t i = 1; i < p.size (); i++)
+                    fld->mulin (o[i], p[i]);
+            }
+
+            void
+            twist (Element *o, const std::vector<Element> &p,
+                                                const Element &s) const {
+                Element c;
+                for (size_t i = 0; i < p.size (); i++) {
+                    fld->mul (c, p[i], s);
+                    fld->mulin (o[i], c);
+                }
+            }
+
+            /* h <- (x^d_s - z_s) h in place, h of length l, return the new
+             * length */
+            size_t
+            mul_binomial (Element *h, size_t l, size_t s) const {
+                const size_t b = d[s], nl = l + b;
+                Element tmp;
+                for (size_t i = nl; i-- > 0; ) {
+                    tmp = (i >= b) ? h[i-b] : fld->zero;
+                    if (i < l)
+                        fld->maxpyin (tmp, z[s], h[i]);
+                    h[i] = tmp;
+                }
+                return nl;
+            }
+
+            /* transpose of mul_binomial: h[i] <- h[i+d_s] - z_s h[i] */
+            size_t
+            mul_binomial_transposed (Element *h, size_t l, size_t s) const {
+                const size_t b = d[s], nl = l - b;
+                Element tmp;
+                for (size_t i = 0; i < nl; i++) {
+                    tmp = h[i+b];
+                    fld->maxpyin (tmp, z[s], h[i]);
+                    h[i] = tmp;
+                }
+                return nl;
+            }
+    };
+}
+#endif // __LINBOX_fft_truncated_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -142,6 +142,10 @@ namespace LinBox {
 
     };
 }
+
+/* Truncated transforms (and their transposes) built on top of FFT */
+#include "fft-truncated.inl"
+
 #endif // __LINBOX_fft_H
 
 // Local Variables:
@@ -200,6 +200,10 @@ namespace LinBox{
 
       std::vector<MatrixP_F*> c_i (num_primes);
       
+      // the prime channels are independent
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(fftConcurrentChannels(num_primes))
+#endif
       for (size_t l=0;l<num_primes;l++)
 	{
 	  //FFT_PROFILE_START;
@@ -252,6 +256,9 @@ namespace LinBox{
 	ADD_MEM(8*n_tc*num_primes);
 	double *t_c_mod = new double[n_tc*num_primes];
 	//std::cout<<"MUL FFT RNS: output RNS -> allocating "<<MB((n_tc)*num_primes*8)<<"Mo"<<std::endl;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
 	for (size_t l=0;l<num_primes;l++){
 	  for (size_t i=0;i<m*n;i++)
 	    for (size_t j=0;j<s;j++)
@@ -339,6 +346,9 @@ namespace LinBox{
 	smallRNS.init(1, n_tb, t_b_mod, n_tb, b.getPointer(), n_tb, maxB);
 	FFT_PROFILING(2,"reduction mod pi of input matrices");
 
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(fftConcurrentChannels(rns_chunk))
+#endif
 	for (size_t l=0;l<rns_chunk;l++)
 	  {	    
 	    //FFT_PROFILE_START;
@@ -382,6 +392,9 @@ namespace LinBox{
 	//std::cout<<"MUL FFT RNS: RNS -> allocating "<<MB(n_tc*num_primes*8)<<"Mo"<<std::endl;
 	ADD_MEM(8*(n_tc)*num_primes);
 	double *t_c_mod = new double[n_tc*num_primes];
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
 	for (size_t l=0;l<num_primes;l++){
 	  for (size_t i=0;i<m*n;i++)
 	    for (size_t j=0;j<s;j++)
@@ -496,6 +509,10 @@ namespace LinBox{
 
       std::vector<MatrixP_F*> c_i (num_primes);
 
+      // the prime channels are independent (the timings are per channel)
+#if defined(__LINBOX_USE_OPENMP) && !defined(FFT_PROFILER)
+#pragma omp parallel for schedule(dynamic,1) if(fftConcurrentChannels(num_primes))
+#endif
       for (size_t l=0;l<num_primes;l++){
 	FFT_PROFILE_START(2);
 	ModField f(RNS._basis[l]);
@@ -544,6 +561,9 @@ namespace LinBox{
 	ADD_MEM(8*(n_tc)*num_primes);
 	t_c_mod = new double[n_tc*num_primes];
 	//std::cout<<"MIDP FFT RNS: output RNS -> allocating "<<MB((n_tc)*num_primes*8)<<"Mo"<<std::endl;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
 	for (size_t l=0;l<num_primes;l++){
 	  for (size_t i=0;i<m*n;i++)
 	    for (size_t j=0;j<c.size();j++)
@@ -62,8 +62,9 @@ namespace LinBox {
 		void mul (Matrix1 &c, const Matrix2 &a, const Matrix3 &b, size_t max_rowdeg=0) const {
 			linbox_check(a.coldim()==b.rowdim());
 			size_t deg  = (max_rowdeg?max_rowdeg:a.size()+b.size()-2); //size_t deg  = a.size()+b.size()-1;
+			// deg+1 points, rounded up to a truncated transform length
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg+1, lpts);
 			// padd the input a and b to 2^lpts (convert to MatrixP representation)
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
@@ -77,8 +78,9 @@ namespace LinBox {
 		void mul (MatrixP &c, const MatrixP &a, const MatrixP &b, size_t max_rowdeg=0) const {
 			linbox_check(a.coldim()==b.rowdim());
 			size_t deg  = (max_rowdeg?max_rowdeg:a.size()+b.size()-2); //size_t deg  = a.size()+b.size()-1;
+			// deg+1 points, rounded up to a truncated transform length
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg+1, lpts);
 			
 			// padd the input a and b to 2^lpts
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
@@ -91,8 +93,8 @@ namespace LinBox {
 			c.resize(deg+1);
 		}
 
-		// a,b and c must have size: 2^lpts
-		// -> use TFT to circumvent the padding issue
+		// a,b and c must have size: 2^lpts, or an admissible length of a
+		// truncated transform of size at most 2^lpts (see TruncatedFFT)
 		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b) const {
 			FFT_PROFILE_START(1);
 			size_t m = a.rowdim();
@@ -114,12 +116,16 @@ namespace LinBox {
 			if (FFT_PROF_LEVEL==1) std::cout<<"FFT: points "<<pts<<"\n";
 #endif
 
-			if ((_p-1) % pts != 0) {
+			if ((_p-1) % ((uint64_t)1<<lpts) != 0) {
 				std::cout<<"Error the prime is not a FFTPrime or it has too small power of 2\n";
 				std::cout<<"prime="<<_p<<std::endl;
 				std::cout<<"nbr points="<<pts<<std::endl;
 				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
 			}
+			if (pts != ((size_t)1<<lpts)) {
+				mul_tfft (lpts, c, a, b);
+				return;
+			}
             FFT<Field> FFTer(field(), lpts);
             FFT<Field> FFTinv (field(), lpts, FFTer.invroot());
             
@@ -131,11 +137,25 @@ namespace LinBox {
 			// std::cout<<a<<std::endl;
 			// std::cout<<b<<std::endl;
 			
-			// FFT transformation on the input matrices
+			// FFT transformation on the input matrices, the entries are independent
+			// and FFT_direct only reads the precomputed powers of the root
+#ifdef __LINBOX_USE_OPENMP
+			const bool par = ((m+n)*k*pts >= FFT_PARALLEL_THRESHOLD);
+#pragma omp parallel if(par)
+			{
+#pragma omp for schedule(static) nowait
+				for (size_t i = 0; i < m * k; i++)
+					FFTer.FFT_direct(&(a.ref(i,0)));
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < k * n; i++)
+					FFTer.FFT_direct(&(b.ref(i,0)));
+			}
+#else
 			for (size_t i = 0; i < m * k; i++)
 				FFTer.FFT_direct(&(a.ref(i,0)));
 			for (size_t i = 0; i < k * n; i++)
 				FFTer.FFT_direct(&(b.ref(i,0)));
+#endif
 			FFT_PROFILING(1,"direct FFT_DIF");
 			
 			// std::cout<<"DIF:  w="<<FFTer._w<<std::endl;
@@ -166,9 +186,8 @@ namespace LinBox {
 			vm_b.copy(b);
 			FFT_PROFILING(1,"Polfirst to Matfirst");
 
-			// Pointwise multiplication
-			for (size_t i = 0; i < pts; ++i)
-				_BMD.mul(vm_c[i], vm_a[i], vm_b[i]);
+			// Pointwise multiplication, one sequential fgemm per evaluation point
+			pointwise_mul(vm_c, vm_a, vm_b);
 			FFT_PROFILING(1,"Pointwise mult");
 #endif			
 			// Transformation into matrix of polynomials (with int32_t coefficient)
@@ -179,6 +198,9 @@ namespace LinBox {
 			//std::cout<<c<<std::endl;			
 			
 			// Inverse FFT on the output matrix
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m*n*pts >= FFT_PARALLEL_THRESHOLD)
+#endif
 			for (size_t i = 0; i < m * n; i++)
 				FFTinv.FFT_inverse(&(c.ref(i,0)));
 			FFT_PROFILING(1,"inverse FFT_DIT");
@@ -226,13 +248,14 @@ namespace LinBox {
 				linbox_check(a.size()<hdeg+deg);
 
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts < deg) { pts= pts<<1; ++lpts; }
-			// padd the input a and b to 2^lpts (use MatrixP representation)
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg, lpts);
+			// padd the input a and b to pts (use MatrixP representation),
+			// the coefficients of index >= deg do not contribute
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
 			MatrixP c2(field(),c.rowdim(),c.coldim(),pts);
-			a2.copy(a,0,a.size()-1);
-			b2.copy(b,0,b.size()-1);
+			a2.copy(a,0,std::min(a.size(),pts)-1);
+			b2.copy(b,0,std::min(b.size(),pts)-1);
 
 			// reverse the element of the smallest polynomial according to h(x^-1)*x^(hdeg)
 			if (smallLeft)
@@ -248,7 +271,7 @@ namespace LinBox {
 			c.copy(c2,0,c.size()-1);
 		}
 
-		// a,b and c must have size: 2^lpts
+		// a,b and c must have size: 2^lpts, or an admissible truncated length
 		// -> a must have been already reversed according to the midproduct algorithm
 		void midproduct_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b,
 				     bool smallLeft=true) const {
@@ -261,29 +284,40 @@ namespace LinBox {
 #ifdef FFT_PROFILER
 			if (FFT_PROF_LEVEL==1) std::cout<<"FFT: points "<<pts<<"\n";
 #endif
-			if ((_p-1) % pts != 0) {
+			if ((_p-1) % ((uint64_t)1<<lpts) != 0) {
 				std::cout<<"Error the prime is not a FFTPrime or it has too small power of 2\n";
 				std::cout<<"prime="<<_p<<std::endl;
 				std::cout<<"nbr points="<<pts<<std::endl;
 				throw LinboxError("LinBox ERROR: bad FFT Prime\n");
 			}
+			if (pts != ((size_t)1<<lpts)) {
+				midproduct_tfft (lpts, c, a, b, smallLeft);
+				return;
+			}
 			FFT<Field> FFTer (field(), lpts);
 			FFT<Field> FFTinv(field(), lpts, FFTer.invroot());
 			FFT_PROFILING(1,"init");
 
 			// FFT transformation on the input matrices
-			if (smallLeft){
-				for (size_t i = 0; i < m * k; i++)
-					FFTer.FFT_direct(&(a(i)[0]));
-				for (size_t i = 0; i < k * n; i++)
-					FFTinv.FFT_direct(&(b(i)[0]));
-			}
-			else {
+			const FFT<Field> &FFTa = (smallLeft ? FFTer : FFTinv);
+			const FFT<Field> &FFTb = (smallLeft ? FFTinv : FFTer);
+#ifdef __LINBOX_USE_OPENMP
+			const bool par = ((m+n)*k*pts >= FFT_PARALLEL_THRESHOLD);
+#pragma omp parallel if(par)
+			{
+#pragma omp for schedule(static) nowait
 				for (size_t i = 0; i < m * k; i++)
-					FFTinv.FFT_direct(&(a(i)[0]));
+					FFTa.FFT_direct(&(a(i)[0]));
+#pragma omp for schedule(static)
 				for (size_t i = 0; i < k * n; i++)
-					FFTer.FFT_direct(&(b(i)[0]));
+					FFTb.FFT_direct(&(b(i)[0]));
 			}
+#else
+			for (size_t i = 0; i < m * k; i++)
+				FFTa.FFT_direct(&(a(i)[0]));
+			for (size_t i = 0; i < k * n; i++)
+				FFTb.FFT_direct(&(b(i)[0]));
+#endif
 			FFT_PROFILING(1,"direct FFT_DIF");
 
 			// convert the matrix representation to matfirst (with double coefficient)
@@ -296,8 +330,7 @@ namespace LinBox {
 			FFT_PROFILING(1,"Polfirst to Matfirst");
 
 			// Pointwise multiplication
-			for (size_t i = 0; i < pts; ++i)
-				_BMD.mul(vm_c[i], vm_a[i], vm_b[i]);
+			pointwise_mul(vm_c, vm_a, vm_b);
 			FFT_PROFILING(1,"pointwise mult");
 
 			// Transformation into matrix of polynomials (with int32_t coefficient)
@@ -305,6 +338,9 @@ namespace LinBox {
 			FFT_PROFILING(1,"Matfirst to Polfirst");
 
 			// Inverse FFT on the output matrix
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m*n*pts >= FFT_PARALLEL_THRESHOLD)
+#endif
 			for (size_t i = 0; i < m * n; i++)
 				FFTer.FFT_inverse(&(c(i)[0]));
 			FFT_PROFILING(1,"inverse FFT_DIT");
@@ -319,6 +355,136 @@ namespace LinBox {
 			FFLAS::fscalin(field(),c.rowdim()*c.coldim()*c.size(), inv_pts,  c.getPointer(),1);
 			FFT_PROFILING(1,"scaling the result");
 		}
+
+	private:
+		// mul_fft on pts=c.size() < 2^lpts points: the truncated transform
+		// only evaluates at pts points, so that there are pts pointwise products
+		void mul_tfft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b) const {
+			size_t m = a.rowdim();
+			size_t k = a.coldim();
+			size_t n = b.coldim();
+			size_t pts=c.size();
+			TruncatedFFT<Field> TFFT (field(), lpts, pts);
+			FFT_PROFILING(1,"init");
+
+#ifdef __LINBOX_USE_OPENMP
+			const bool par = ((m+n)*k*pts >= FFT_PARALLEL_THRESHOLD);
+#pragma omp parallel if(par)
+			{
+#pragma omp for schedule(static) nowait
+				for (size_t i = 0; i < m * k; i++)
+					TFFT.direct(&(a.ref(i,0)));
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < k * n; i++)
+					TFFT.direct(&(b.ref(i,0)));
+			}
+#else
+			for (size_t i = 0; i < m * k; i++)
+				TFFT.direct(&(a.ref(i,0)));
+			for (size_t i = 0; i < k * n; i++)
+				TFFT.direct(&(b.ref(i,0)));
+#endif
+			FFT_PROFILING(1,"direct TFT");
+
+			PMatrix vm_c (field(), m, n, pts);
+			PMatrix vm_a (field(), m, k, pts);
+			PMatrix vm_b (field(), k, n, pts);
+			vm_a.copy(a);
+			vm_b.copy(b);
+			FFT_PROFILING(1,"Polfirst to Matfirst");
+
+			pointwise_mul(vm_c, vm_a, vm_b);
+			FFT_PROFILING(1,"Pointwise mult");
+
+			c.copy(vm_c);
+			FFT_PROFILING(1,"Matfirst to Polfirst");
+
+			// the inverse transform is normalized
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m*n*pts >= FFT_PARALLEL_THRESHOLD)
+#endif
+			for (size_t i = 0; i < m * n; i++)
+				TFFT.inverse(&(c.ref(i,0)));
+			FFT_PROFILING(1,"inverse TFT");
+		}
+
+		// midproduct_fft on pts=c.size() < 2^lpts points, by transposition of
+		// the truncated product: the short operand is evaluated, the long one
+		// goes through the transposed interpolation and the result through
+		// the transposed evaluation
+		void midproduct_tfft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b,
+				      bool smallLeft) const {
+			size_t m = a.rowdim();
+			size_t k = a.coldim();
+			size_t n = b.coldim();
+			size_t pts=c.size();
+			TruncatedFFT<Field> TFFT (field(), lpts, pts);
+			FFT_PROFILING(1,"init");
+
+#ifdef __LINBOX_USE_OPENMP
+			const bool par = ((m+n)*k*pts >= FFT_PARALLEL_THRESHOLD);
+#pragma omp parallel if(par)
+			{
+#pragma omp for schedule(static) nowait
+				for (size_t i = 0; i < m * k; i++)
+					if (smallLeft)
+						TFFT.direct(&(a.ref(i,0)));
+					else
+						TFFT.inverse_transposed(&(a.ref(i,0)));
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < k * n; i++)
+					if (smallLeft)
+						TFFT.inverse_transposed(&(b.ref(i,0)));
+					else
+						TFFT.direct(&(b.ref(i,0)));
+			}
+#else
+			for (size_t i = 0; i < m * k; i++)
+				if (smallLeft)
+					TFFT.direct(&(a.ref(i,0)));
+				else
+					TFFT.inverse_transposed(&(a.ref(i,0)));
+			for (size_t i = 0; i < k * n; i++)
+				if (smallLeft)
+					TFFT.inverse_transposed(&(b.ref(i,0)));
+				else
+					TFFT.direct(&(b.ref(i,0)));
+#endif
+			FFT_PROFILING(1,"direct TFT");
+
+			PMatrix vm_c (field(), m, n, pts);
+			PMatrix vm_a (field(), m, k, pts);
+			PMatrix vm_b (field(), k, n, pts);
+			vm_a.copy(a);
+			vm_b.copy(b);
+			FFT_PROFILING(1,"Polfirst to Matfirst");
+
+			pointwise_mul(vm_c, vm_a, vm_b);
+			FFT_PROFILING(1,"pointwise mult");
+
+			c.copy(vm_c);
+			FFT_PROFILING(1,"Matfirst to Polfirst");
+
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m*n*pts >= FFT_PARALLEL_THRESHOLD)
+#endif
+			for (size_t i = 0; i < m * n; i++)
+				TFFT.direct_transposed(&(c.ref(i,0)));
+			FFT_PROFILING(1,"transposed TFT");
+		}
+
+		// c[i] = a[i]*b[i] for all the evaluation points i, the products are
+		// small (m x k by k x n) and many, so they are distributed among the
+		// threads as a batch of sequential fgemm rather than parallelized one by one
+		void pointwise_mul (PMatrix &c, const PMatrix &a, const PMatrix &b) const {
+			const size_t pts = c.size();
+#ifdef __LINBOX_USE_OPENMP
+			const size_t work = (a.rowdim()+b.coldim())*a.coldim()*pts;
+#pragma omp parallel for schedule(static) if(work >= FFT_PARALLEL_THRESHOLD)
+#endif
+			for (size_t i = 0; i < pts; ++i)
+				_BMD.mul(c[i], a[i], b[i]);
+		}
 	}; // end of class special FFT mul domain
 
 
@@ -70,8 +70,8 @@ namespace LinBox {
 			size_t deg  = (max_rowdeg?max_rowdeg:a.size()+b.size()-2); //size_t deg  = a.size()+b.size()-1;
 			c.resize(deg+1);
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
-			// padd the input a and b to 2^lpts (convert to MatrixP representation)
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg+1, lpts);
+			// padd the input a and b to pts (convert to MatrixP representation)
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
 			a2.copy(a,0,a.degree());
@@ -88,13 +88,13 @@ namespace LinBox {
 			// deg is the max rowdegree of the product
 			size_t deg  = (max_rowdeg?max_rowdeg:a.size()+b.size()-2); //size_t deg  = a.size()+b.size()-1;
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts <= deg) { pts= pts<<1; ++lpts; }
-			// padd the input a and b to 2^lpts
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg+1, lpts);
+			// padd the input a and b to pts
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
 			a2.copy(a,0,a.degree());
 			b2.copy(b,0,b.degree());
-			// resize c to 2^lpts
+			// resize c to pts
 			c.resize(pts);
 			integer bound=integer(_p-1)*integer(_p-1)
 				*integer((uint64_t)a.coldim())*integer((uint64_t)std::min(a.size(),b.size()));
@@ -103,10 +103,10 @@ namespace LinBox {
 			c.resize(deg+1);
 		}
 		
-		// a,b and c must have size: 2^lpts
+		// a,b and c must have size: 2^lpts, or an admissible truncated length (see TruncatedFFT)
 		void mul_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b, const integer& bound) const {
 			size_t pts=c.size();			
-			if ((_p-1) % pts == 0){
+			if ((_p-1) % ((uint64_t)1<<lpts) == 0){
 				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field());
 				fftprime_domain.mul_fft(lpts,c,a,b);
                 		return;
@@ -117,6 +117,10 @@ namespace LinBox {
 			size_t m = a.rowdim();
 			size_t k = a.coldim();
 			size_t n = b.coldim();
+			// The channels stay Modular<double> primes of at most 27 bits: their
+			// pointwise products are BLAS matrix products. The 62-bit
+			// SimdFFT of Modular<uint64_t,uint128_t> (fft-integral.inl)
+			// would need fewer primes but no BLAS, it is not used here.
 			uint64_t prime_max=maxFFTPrimeValue(k,pts); // CAREFUL: only for Modular<double>;
 			std::vector<integer> bas;
 			if (!RandomFFTPrime::generatePrimes (bas, prime_max, bound, lpts)){
@@ -134,6 +138,10 @@ namespace LinBox {
 			for (size_t l=0;l<num_primes;l++)
 				f[l]=ModField(basis[l]);
 	    
+			// the prime channels are independent
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(fftConcurrentChannels(num_primes))
+#endif
 			for (size_t l=0;l<num_primes;l++){
 				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l]);
 				MatrixP ai(f[l],m,k,pts);
@@ -157,26 +165,7 @@ namespace LinBox {
 			}
 
 			// reconstruct the result with MRS
-			typename Field::Element alpha,tmp;
-			typename Field::Element beta=field().one;
-			FFLAS::freduce(field(),m*n*pts,c_i[0]->getPointer(),1,c.getPointer(),1);
-			//for(size_t k=0;k<m*n*pts;k++) field().reduce(c.getPointer()[k],c_i[0]->getPointer()[k]);
-
-			for (size_t i=1;i<num_primes;i++){
-				for(size_t j=0;j<i;j++){
-					f[i].init(alpha,basis[j]);
-					f[i].invin(alpha);
-					FFLAS::fsubin (f[i],m*n*pts,c_i[j]->getPointer(),1,c_i[i]->getPointer(),1);
-					//for(size_t k=0;k<m*n*pts;k++) {f[i].init(tmp,c_i[j]->getPointer()[k]); f[i].subin(c_i[i]->getPointer()[k], tmp); }
-					FFLAS::fscalin(f[i],m*n*pts,alpha,c_i[i]->getPointer(),1);
-					//for(size_t k=0;k<m*n*pts;k++) f[i].mulin(c_i[i]->getPointer()[k], alpha);					
-				}
-				field().init(tmp,basis[i-1]);
-				field().mulin(beta,tmp);
-				//field().mulin(beta,basis[i-1]);
-				FFLAS::faxpy(field(),m*n*pts,beta,c_i[i]->getPointer(),1,c.getPointer(),1);
-				//for(size_t k=0;k<m*n*pts;k++) field().axpyin(c.getPointer()[k], c_i[i]->getPointer()[k],beta);
-			}
+			mrs_reconstruct(c, c_i, f, basis);
 			
 			//std::cout<<"c:="<<c<<std::endl;
 			//#ifdef CHECK_MATPOL_MUL
@@ -206,13 +195,13 @@ namespace LinBox {
 				linbox_check(a.size()<hdeg+deg);
 
 			size_t lpts = 0;
-			size_t pts  = 1; while (pts < deg) { pts= pts<<1; ++lpts; }
-			// padd the input a and b to 2^lpts (use MatrixP representation)
+			size_t pts  = TruncatedFFT<Field>::admissible_size(deg, lpts);
+			// padd the input a and b to pts (use MatrixP representation)
 			MatrixP a2(field(),a.rowdim(),a.coldim(),pts);
 			MatrixP b2(field(),b.rowdim(),b.coldim(),pts);
 			MatrixP c2(field(),c.rowdim(),c.coldim(),pts);
-			a2.copy(a,0,a.size()-1);
-			b2.copy(b,0,b.size()-1);
+			a2.copy(a,0,std::min(a.size(),pts)-1);
+			b2.copy(b,0,std::min(b.size(),pts)-1);
 
 			// reverse the element of the smallest polynomial according to h(x^-1)*x^(hdeg)
 			if (smallLeft)
@@ -231,12 +220,12 @@ namespace LinBox {
 		}
 
 		
-		// a,b and c must have size: 2^lpts
+		// a,b and c must have size: 2^lpts, or an admissible truncated length
 		// -> a must have been already reversed according to the midproduct algorithm
 		void midproduct_fft (size_t lpts, MatrixP &c, MatrixP &a, MatrixP &b,
 				     const integer& bound, bool smallLeft=true) const {
 			size_t pts=c.size();			
-			if ((_p-1) % pts == 0){
+			if ((_p-1) % ((uint64_t)1<<lpts) == 0){
 				//std::cerr<<"3-prime FFT midp switching to FFTPrime  "<<std::endl;
 				PolynomialMatrixFFTPrimeMulDomain<ModField> fftprime_domain (field());
 				fftprime_domain.midproduct_fft(lpts,c,a,b,smallLeft);
@@ -271,6 +260,10 @@ namespace LinBox {
 			for (size_t l=0;l<num_primes;l++)
 				f[l]=ModField(basis[l]);
 	    
+			// the prime channels are independent
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(fftConcurrentChannels(num_primes))
+#endif
 			for (size_t l=0;l<num_primes;l++){
 				//std::cerr<<"3-prime FFT midp over "; f[l].write(std::cerr)<<std::endl;
 				PolynomialMatrixFFTPrimeMulDomain<ModField> fftdomain (f[l]);
@@ -295,21 +288,7 @@ namespace LinBox {
 			}
 	    
 			// reconstruct the result with MRS
-			typename Field::Element alpha,tmp;
-			typename Field::Element beta=field().one;
-			FFLAS::freduce(field(),m*n*pts,c_i[0]->getPointer(),1,c.getPointer(),1);
-			for (size_t i=1;i<num_primes;i++){
-				for(size_t j=0;j<i;j++){
-					f[i].init(alpha,basis[j]);
-					f[i].invin(alpha);
-					FFLAS::fsubin (f[i],m*n*pts,c_i[j]->getPointer(),1,c_i[i]->getPointer(),1);
-					FFLAS::fscalin(f[i],m*n*pts,alpha,c_i[i]->getPointer(),1);
-				}
- 				field().init(tmp,basis[i-1]);
-				field().mulin(beta,tmp);
-				//field().mulin(beta,basis[i-1]);
-				FFLAS::faxpy(field(),m*n*pts,beta,c_i[i]->getPointer(),1,c.getPointer(),1);
-			}
+			mrs_reconstruct(c, c_i, f, basis);
 
 			//std::cout<<"c:="<<c<<std::endl;
 			
@@ -317,7 +296,37 @@ namespace LinBox {
 				delete c_i[i];
 		
 		}
-		
+
+	private:
+		// Mixed radix reconstruction of c from its images c_i modulo the primes basis,
+		// the coefficients are independent so the slices of c are done in parallel
+		void mrs_reconstruct (MatrixP &c, std::vector<MatrixP*> &c_i,
+				      const std::vector<ModField> &f, const std::vector<double> &basis) const {
+			const size_t num_primes = c_i.size();
+			const size_t len   = c.rowdim()*c.coldim()*c.size();
+			const size_t slice = 1<<14;
+			const size_t nslices = (len+slice-1)/slice;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(len*num_primes >= FFT_PARALLEL_THRESHOLD)
+#endif
+			for (size_t s=0;s<nslices;s++){
+				const size_t start=s*slice, l=std::min(slice,len-start);
+				typename Field::Element alpha,tmp;
+				typename Field::Element beta=field().one;
+				FFLAS::freduce(field(),l,c_i[0]->getPointer()+start,1,c.getPointer()+start,1);
+				for (size_t i=1;i<num_primes;i++){
+					for(size_t j=0;j<i;j++){
+						f[i].init(alpha,basis[j]);
+						f[i].invin(alpha);
+						FFLAS::fsubin (f[i],l,c_i[j]->getPointer()+start,1,c_i[i]->getPointer()+start,1);
+						FFLAS::fscalin(f[i],l,alpha,c_i[i]->getPointer()+start,1);
+					}
+					field().init(tmp,basis[i-1]);
+					field().mulin(beta,tmp);
+					FFLAS::faxpy(field(),l,beta,c_i[i]->getPointer()+start,1,c.getPointer()+start,1);
+				}
+			}
+		}
 	};
 } // end of namespace LinBox
 
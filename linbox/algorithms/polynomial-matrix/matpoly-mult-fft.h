@@ -39,6 +39,9 @@
 #include "givaro/givtimer.h"
 #include <sstream>
 #include <iostream>
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
 
 #ifdef FFT_PROFILER
 #ifndef FFT_PROF_LEVEL
@@ -81,8 +84,27 @@ Givaro::Timer mychrono[3];
 #define FFT_DEG_THRESHOLD   4
 #endif
 
+// under OpenMP, number of polynomial coefficients (entries times points)
+// from which the transforms and the pointwise products are shared among threads
+#ifndef FFT_PARALLEL_THRESHOLD
+#define FFT_PARALLEL_THRESHOLD 16384
+#endif
+
 namespace LinBox
 {
+  /* The images of a multimodular product are computed concurrently when
+   * each channel gets its own thread, or when the transforms inside a
+   * channel can still use the remaining threads (nested parallelism);
+   * otherwise the channels run one after the other, each one parallel. */
+  inline bool fftConcurrentChannels (size_t num_primes) {
+#ifdef __LINBOX_USE_OPENMP
+    return (num_primes > 1)
+      && (num_primes >= (size_t)omp_get_max_threads() || omp_get_max_active_levels() > 1);
+#else
+    return false;
+#endif
+  }
+
   template<typename Field>
     bool check_mul (const PolynomialMatrix<PMType::matfirst,PMStorage::plain,Field> &c,
 		    const PolynomialMatrix<PMType::matfirst,PMStorage::plain,Field> &a,
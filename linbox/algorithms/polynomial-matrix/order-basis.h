@@ -43,9 +43,18 @@
 #include <algorithm>
 #include <fstream>
 #include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeinfo>
 #include "fflas-ffpack/fflas-ffpack.h"
 #define MBASIS_THRESHOLD_LOG 5
 #define MBASIS_THRESHOLD (1<<MBASIS_THRESHOLD_LOG)
+// number of timed runs (the best one is kept) of each side of the crossover race
+#ifndef MBASIS_TUNE_TRIALS
+#define MBASIS_TUNE_TRIALS 3
+#endif
 
 
 
@@ -149,6 +158,44 @@ namespace LinBox {
 #endif
 
         
+        namespace Protected {
+                // crossovers measured by OrderBasis::tuneThreshold, per field
+                // type, characteristic size and serie dimensions
+                class MBasisTuningCache {
+                public:
+                        typedef std::tuple<std::string,size_t,size_t,size_t> Key;
+
+                        static bool find(const Key& key, size_t& t)
+                        {
+                                std::lock_guard<std::mutex> lock(mutex());
+                                std::map<Key,size_t>::const_iterator it = table().find(key);
+                                if (it == table().end())
+                                        return false;
+                                t = it->second;
+                                return true;
+                        }
+
+                        static void insert(const Key& key, size_t t)
+                        {
+                                std::lock_guard<std::mutex> lock(mutex());
+                                table()[key] = t;
+                        }
+
+                private:
+                        static std::map<Key,size_t>& table()
+                        {
+                                static std::map<Key,size_t> t;
+                                return t;
+                        }
+
+                        static std::mutex& mutex()
+                        {
+                                static std::mutex m;
+                                return m;
+                        }
+                };
+        }
+
         template< size_t K>
         struct EarlyTerm {
                 size_t _count;
@@ -186,6 +233,7 @@ namespace LinBox {
                 PolynomialMatrixMulDomain<Field>   _PMD;
                 BlasMatrixDomain<Field>            _BMD;
                 ET                           _EarlyStop;
+                size_t               _mbasis_threshold; // PM_Basis calls M_Basis up to this order
         public:
 #if  defined(PROFILE_PMBASIS) or defined(__CHECK_MBASIS) or defined(__CHECK_PMBASIS)
                 size_t _idx=0;
@@ -194,11 +242,72 @@ namespace LinBox {
                 std::chrono::time_point<std::chrono::system_clock> _start, _end;
                 bool _started=false;
 #endif
-                OrderBasis(const Field& f) : _field(&f), _PMD(f), _BMD(f) {                 
+                OrderBasis(const Field& f) : _field(&f), _PMD(f), _BMD(f), _mbasis_threshold(MBASIS_THRESHOLD) {                 
                 }
 
                 inline const Field& field() const {return *_field;}
 
+                size_t getThreshold() const {return _mbasis_threshold;}
+                void   setThreshold(size_t t) {_mbasis_threshold=std::max(t,(size_t)1);}
+
+                // set the M-Basis/PM-Basis crossover from measured costs: on a random
+                // m x k serie, M_Basis at order 2t is timed against one PM_Basis level
+                // splitting it in two M_Basis of order t, for t = 16, 32, ... until the
+                // split is faster or 2t exceeds max_order. Each side keeps the best of
+                // MBASIS_TUNE_TRIALS runs, and the result is cached per field type,
+                // characteristic size and dimensions, so that only the first call pays.
+                // Returns the new threshold.
+                size_t tuneThreshold(size_t m, size_t k, size_t max_order)
+                {
+                        integer p;
+                        field().characteristic(p);
+                        const Protected::MBasisTuningCache::Key key(typeid(Field).name(), p.bitsize(), m, k);
+                        size_t t=MBASIS_THRESHOLD>>1;
+                        if (Protected::MBasisTuningCache::find(key,t)) {
+                                _mbasis_threshold=t;
+                                return t;
+                        }
+                        if (2*t > max_order) return _mbasis_threshold;
+
+                        typename Field::RandIter G(field());
+                        for (; 2*t <= max_order; t<<=1){
+                                MatrixP serie(field(),m,k,2*t);
+                                for (size_t i=0;i<m*k;i++)
+                                        for (size_t l=0;l<2*t;l++)
+                                                G.random(serie.ref(i,l));
+                                double tm=timeBasis(serie,2*t,2*t+1);
+                                double tpm=timeBasis(serie,2*t,t);
+                                if (tpm < tm)
+                                        break;
+                        }
+                        _EarlyStop.reset();
+                        _mbasis_threshold=t;
+                        Protected::MBasisTuningCache::insert(key,t);
+                        return t;
+                }
+
+        private:
+                // best time of PM_Basis on serie up to order with crossover threshold
+                // (M_Basis alone when threshold >= order)
+                double timeBasis(const MatrixP& serie, size_t order, size_t threshold)
+                {
+                        typedef std::chrono::steady_clock Clock;
+                        const size_t m=serie.rowdim();
+                        double best=-1.;
+                        for (size_t r=0;r<MBASIS_TUNE_TRIALS;r++){
+                                MatrixP sigma(field(),m,m,order+1);
+                                std::vector<size_t> shift(m,0);
+                                _mbasis_threshold=threshold;
+                                Clock::time_point start=Clock::now();
+                                PM_Basis(sigma, serie, order, shift);
+                                std::chrono::duration<double> elapsed=Clock::now()-start;
+                                if (best < 0 || elapsed.count() < best)
+                                        best=elapsed.count();
+                        }
+                        return best;
+                }
+
+        public:
                 // serie must have exactly order elements (i.e. its degree = order-1)
                 // sigma can have at most order+1 elements (i.e. its degree = order)
                 template<typename PMatrix1, typename PMatrix2>
@@ -229,7 +338,7 @@ namespace LinBox {
                         std::chrono::time_point<std::chrono::system_clock> _chrono_start=std::chrono::system_clock::now();
 #endif
                         
-                        if (order <= MBASIS_THRESHOLD) {
+                        if (order <= _mbasis_threshold) {
 #if defined (PROFILE_PMBASIS) or defined(__CHECK_PMBASIS)
                                 _idx+=order;
 #endif
@@ -755,7 +864,7 @@ namespace LinBox {
                         std::chrono::time_point<std::chrono::system_clock> _chrono_start=std::chrono::system_clock::now();
 #endif
                         
-                        if (order <= MBASIS_THRESHOLD) {
+                        if (order <= _mbasis_threshold) {
 #if defined (PROFILE_PMBASIS) or defined(__CHECK_PMBASIS)
                                 _idx+=order;
 #endif
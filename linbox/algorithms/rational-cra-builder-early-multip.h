@@ -100,6 +100,20 @@ namespace LinBox
 			RationalCRABuilderFullMultip<Domain>::initialize(D, e);
 		}
 
+		/// Init with a residue modulo an integer, e.g. a partial reconstruction
+		void initialize (const Integer& D, const BlasVector<Givaro::ZRing<Integer> >& e)
+		{
+			srand48(BaseTimer::seed());
+			randv. resize ( e.size() );
+			for ( std::vector<size_t>::iterator int_p = randv. begin();
+			      int_p != randv. end(); ++ int_p)
+				*int_p = ((size_t)lrand48()) % 20000;
+
+			Integer z;
+			RationalCRABuilderEarlySingle<Domain>::initialize(D, dot(z, D, e, randv) );
+			RationalCRABuilderFullMultip<Domain>::initialize(D, e);
+		}
+
 		//!progress
 		template<template<class,class> class Vect, template <class> class Alloc>
 		void progress (const Domain& D, const Vect<DomainElement, Alloc<DomainElement> >& e)
@@ -124,6 +138,20 @@ namespace LinBox
 			RationalCRABuilderFullMultip<Domain>::progress(D, e);
 		}
 
+		/// Progress with a residue modulo an integer, e.g. a partial reconstruction
+		void progress (const Integer& D, const BlasVector<Givaro::ZRing<Integer> >& e)
+		{
+			progress(D, e, 1);
+		}
+
+		/// As above, \p D being the product of \p count primes which all count towards termination
+		void progress (const Integer& D, const BlasVector<Givaro::ZRing<Integer> >& e, size_t count)
+		{
+			Integer z;
+			RationalCRABuilderEarlySingle<Domain>::progress(D, dot(z, D, e, randv), count);
+			RationalCRABuilderFullMultip<Domain>::progress(D, e);
+		}
+
 		//!result
 		template<template<class, class> class Vect, template <class> class Alloc>
 		Vect<Integer, Alloc<Integer> >& result(Vect<Integer, Alloc<Integer> >& num, Integer& den)
@@ -149,6 +177,20 @@ namespace LinBox
 
 	protected:
 
+		template <class Vect2>
+		Integer& dot (Integer& z, const Integer& D,
+			      const BlasVector<Givaro::ZRing<Integer> >& v1, const Vect2& v2)
+		{
+			z = 0;
+			typename BlasVector<Givaro::ZRing<Integer> >::const_iterator v1_p;
+			typename Vect2::const_iterator v2_p;
+			for (v1_p  = v1. begin(), v2_p = v2. begin();
+			     v1_p != v1. end();
+			     ++ v1_p, ++ v2_p)
+				z = (z + (*v1_p)*(*v2_p)) % D;
+			return z;
+		}
+
 		template <template<class, class> class Vect1, template <class> class Alloc, class Vect2>
 		DomainElement& dot (DomainElement& z, const Domain& D,
 				    const Vect1<DomainElement, Alloc<DomainElement> >& v1, const Vect2& v2)
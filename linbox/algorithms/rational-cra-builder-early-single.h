@@ -67,16 +67,23 @@ namespace LinBox
 		}
 
 		void progress (const Integer & D, const Integer & e)
+		{
+			progress(D, e, 1);
+		}
+
+		//! As progress, \p D being the product of \p count primes which all count towards termination
+		void progress (const Integer & D, const Integer & e, size_t count)
 		{
 			Integer u0 = this->residue_   %D;
 			Integer	m0 = this->primeProd_ %D;
 
 			fieldreconstruct(this->residue_, D, e, u0, m0, Integer(this->residue_), this->primeProd_);
+			this->nextM_ = D;
 			this->primeProd_ *= this->nextM_;
 			Integer a, b;
 			_ZZ.RationalReconstruction(a, b, this->residue_, this->primeProd_);
 			if ((a == Numer0) && (b == Denom0))
-				++this->occurency_;
+				this->occurency_ += (unsigned int)count;
 			else {
 				this->occurency_ = 1;
 				Numer0 = a;
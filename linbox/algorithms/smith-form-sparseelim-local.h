@@ -27,6 +27,8 @@
 #define __LINBOX_pp_gauss_H
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <givaro/givconfig.h> // for Signed_Trait
 #include "linbox/solutions/smith-form.h"
 #include "linbox/algorithms/gauss.h"
@@ -52,6 +54,21 @@
 #  endif
 #endif
 
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+// PARALLEL_PIVOTING : a step accepts pivots whose Markowitz cost is at most
+// LINBOX_pp_gauss_RELAX times (1 + the cheapest cost of the step).
+#ifndef LINBOX_pp_gauss_RELAX
+#define LINBOX_pp_gauss_RELAX 4
+#endif
+
+// PARALLEL_PIVOTING : rows handed to a thread at once.
+#ifndef LINBOX_pp_gauss_GRAIN
+#define LINBOX_pp_gauss_GRAIN 32
+#endif
+
 
 namespace LinBox
 {
@@ -68,7 +85,10 @@ namespace LinBox
             // Combine these in binary for use in StaticParameters
         PRIVILEGIATE_NO_COLUMN_PIVOTING	= 1,
         PRIVILEGIATE_REDUCING_FILLIN	= 2,
-        PRESERVE_UPPER_MATRIX		= 4
+        PRESERVE_UPPER_MATRIX		= 4,
+            // Sets of independent invertible pivots, eliminated in parallel;
+            // overrides the others, the upper matrix is not preserved
+        PARALLEL_PIVOTING		= 8
     };
 
         /** \brief Repository of functions for rank modulo 
@@ -411,6 +431,54 @@ namespace LinBox
 			}
 		}
 
+            // lignecourante <-- lignecourante + headcoeff * lignepivot,
+            // dropping column indcol. lignepivot has no entry in the
+            // other pivot columns of the step (see gauss_rankin_parallel)
+		template<class Modulo, class Vecteur>
+		void FaireEliminationIndependante( Modulo MOD,
+                                           Vecteur& lignecourante,
+                                           const Vecteur& lignepivot,
+                                           const typename Field::Element& headcoeff,
+                                           const size_t indcol) const {
+			typedef typename Field::Element F;
+			typedef typename Vecteur::value_type E;
+			typedef typename Signed_Trait<Modulo>::unsigned_type UModulo;
+
+			const size_t nj = lignecourante.size();
+			const size_t npiv = lignepivot.size();
+			Vecteur construit(nj + npiv);
+
+			size_t j=0, m=0, l=0;
+			while ((m<nj) || (l<npiv)) {
+				if ((l==npiv) || ((m<nj) && (lignecourante[m].first < lignepivot[l].first))) {
+					if (lignecourante[m].first != indcol)
+						construit[j++] = lignecourante[m];
+					++m;
+				} else if ((m==nj) || (lignepivot[l].first < lignecourante[m].first)) {
+					if (lignepivot[l].first != indcol) {
+						F tmp(headcoeff);
+						tmp *= lignepivot[l].second;
+						tmp %= (UModulo)MOD;
+						if (isNZero(tmp))
+							construit[j++] = E(lignepivot[l].first, tmp);
+					}
+					++l;
+				} else {
+					if (lignecourante[m].first != indcol) {
+						F tmp(headcoeff);
+						tmp *= lignepivot[l].second;
+						tmp += lignecourante[m].second;
+						tmp %= (UModulo)MOD;
+						if (isNZero(tmp))
+							construit[j++] = E(lignecourante[m].first, tmp);
+					}
+					++m; ++l;
+				}
+			}
+			construit.resize(j);
+			lignecourante = construit;
+		}
+
             // ------------------------------------------------------
             // Rank calculators, defining row strategy
             // ------------------------------------------------------
@@ -588,10 +656,218 @@ namespace LinBox
 
             }
 
+            // Each step chooses, in every remaining row, the invertible
+            // entry of sparsest column, of Markowitz cost (r-1)(c-1).
+            // Going through them by increasing cost, a pivot (i,j) is kept
+            // when row i has no entry in the columns of the kept pivots and
+            // none of the kept rows has an entry in column j : the pivots of
+            // a step form an invertible diagonal block, and every remaining
+            // row is updated by them independently of the others.
+            // When no remaining entry is invertible, the rows are divided
+            // by PRIME, as in gauss_rankin. The Schur complements, hence the
+            // ranks, are those of the sequential elimination.
+            // Q receives the pivot columns, in the order of elimination.
+		template<class Modulo, class BB, class Container, class Perm>
+		void gauss_rankin_parallel(Modulo FMOD, Modulo PRIME, Container& ranks, BB& LigneA, Perm& Q, const size_t Ni, const size_t Nj)
+            {
+                linbox_check( Q.coldim() == Q.rowdim() );
+                linbox_check( Q.coldim() == Nj );
+
+                commentator().start ("Parallel Gaussian elimination modulo a prime power",
+                                     "PPRGE", Ni);
+
+                ranks.resize(0);
+
+                typedef typename BB::Row Vecteur;
+                typedef typename Field::Element F;
+                typedef typename Signed_Trait<Modulo>::unsigned_type UModulo;
+
+                Modulo MOD = FMOD;
+                uint64_t exponent(1);
+                Modulo tq(FMOD);
+                while(tq > PRIME) {
+                    tq /= PRIME;
+                    ++exponent;
+                }
+#ifdef LINBOX_PRANK_OUT
+                std::cerr << "Parallel elimination mod " << MOD << " (=" << PRIME << '^' << exponent << ')' << std::endl;
+#endif
+
+                    // assignment of LigneA with the domain object
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                for(long jj=0; jj<(long)Ni; ++jj) {
+                    Vecteur & row = LigneA[(size_t)jj];
+                    size_t rs=0;
+                    for(size_t k=0; k<row.size(); ++k) {
+                        Modulo r = row[k].second;
+                        if ((r <0) || (r >= MOD)) r %= MOD ;
+                        if (r <0) r += MOD ;
+                        if (isNZero(r)) {
+                            row[rs] = row[k];
+                            row[rs].second = ( r );
+                            ++rs;
+                        }
+                    }
+                    row.resize(rs);
+                }
+
+                size_t indcol(0), stamp(0);
+                std::vector<size_t> col_density(Nj);
+                std::vector<size_t> pivotRow(Nj, Ni);   // row of the pivot in column j
+                std::vector<size_t> pivotCol(Ni, Nj);   // column of the pivot in row i
+                std::vector<UModulo> headinv(Nj);       // inverse of the pivot in column j
+                std::vector<size_t> pivotMark(Nj, 0), touchMark(Nj, 0);
+                std::vector<size_t> pivots;             // pivot columns, in order
+
+                std::vector<size_t> active, selected, remaining;
+                for(size_t i=0; i<Ni; ++i)
+                    if (! LigneA[i].empty()) active.push_back(i);
+
+                    // candidate : (cost, row, column)
+                typedef std::pair<size_t, std::pair<size_t,size_t> > Candidate;
+                std::vector<Candidate> candidates;
+
+                while (! active.empty()) {
+                    ++stamp;
+                    commentator().progress ((long)indcol);
+
+                    std::fill(col_density.begin(), col_density.end(), 0);
+                    for(size_t t=0; t<active.size(); ++t) {
+                        const Vecteur & row = LigneA[active[t]];
+                        for(size_t k=0; k<row.size(); ++k)
+                            ++col_density[row[k].first];
+                    }
+
+                    candidates.resize(active.size());
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                    for(long t=0; t<(long)active.size(); ++t) {
+                        const Vecteur & row = LigneA[active[(size_t)t]];
+                        size_t c = Nj;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if ( (! this->MY_divides(PRIME,row[k].second))
+                                 && ((c == Nj) || (col_density[row[k].first] < col_density[c])) )
+                                c = row[k].first;
+                        const size_t cost = (c == Nj ? (size_t)-1 : (row.size()-1)*(col_density[c]-1));
+                        candidates[(size_t)t] = Candidate(cost, std::pair<size_t,size_t>(active[(size_t)t], c));
+                    }
+                    std::sort(candidates.begin(), candidates.end());
+
+                    if (candidates[0].second.second == Nj) {
+                            // No invertible pivot found
+                            // reduce everything by one power of PRIME
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                        for(long t=0; t<(long)active.size(); ++t) {
+                            Vecteur & row = LigneA[active[(size_t)t]];
+                            for(size_t k=0; k<row.size(); ++k)
+                                row[k].second /= PRIME;
+                        }
+                        MOD /= PRIME;
+                        --exponent;
+                        ranks.push_back( indcol );
+#ifdef LINBOX_PRANK_OUT
+                        std::cerr << "Rank mod " << PRIME << "^" << ranks.size() << " : " << indcol << std::endl;
+#endif
+                        continue;
+                    }
+
+                        // greedy choice of independent pivots
+                    const size_t bound = (candidates[0].first + 1) * LINBOX_pp_gauss_RELAX;
+                    selected.clear();
+                    for(size_t t=0; t<candidates.size() && candidates[t].first <= bound; ++t) {
+                        const size_t i = candidates[t].second.first;
+                        const size_t j = candidates[t].second.second;
+                        if (touchMark[j] == stamp) continue;
+                        const Vecteur & row = LigneA[i];
+                        bool independent = true;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if (pivotMark[row[k].first] == stamp) {
+                                independent = false;
+                                break;
+                            }
+                        if (! independent) continue;
+                        pivotMark[j] = stamp;
+                        for(size_t k=0; k<row.size(); ++k)
+                            touchMark[row[k].first] = stamp;
+                        selected.push_back(i);
+
+                        pivotRow[j] = i;
+                        pivotCol[i] = j;
+                        size_t k=0;
+                        while (row[k].first != j) ++k;
+                        MY_Zpz_inv(headinv[j], row[k].second, PRIME, MOD, exponent);
+                        pivots.push_back(j);
+                        ++indcol;
+                    }
+
+                    remaining.clear();
+                    for(size_t t=0; t<active.size(); ++t)
+                        if (pivotCol[active[t]] == Nj)
+                            remaining.push_back(active[t]);
+
+                        // every remaining row is updated by all the pivots it meets
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, LINBOX_pp_gauss_GRAIN)
+#endif
+                    for(long t=0; t<(long)remaining.size(); ++t) {
+                        Vecteur & row = LigneA[remaining[(size_t)t]];
+                        std::vector<std::pair<size_t,F> > hits;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if (pivotMark[row[k].first] == stamp)
+                                hits.push_back(std::pair<size_t,F>(row[k].first, row[k].second));
+                        for(size_t h=0; h<hits.size(); ++h) {
+                            const size_t j = hits[h].first;
+                            F headcoeff = MOD-(hits[h].second);
+                            headcoeff *= headinv[j];
+                            headcoeff %= (UModulo)MOD;
+                            FaireEliminationIndependante(MOD, row, LigneA[pivotRow[j]], headcoeff, j);
+                        }
+                    }
+
+                    for(size_t t=0; t<selected.size(); ++t)
+                        LigneA[selected[t]] = Vecteur(0);
+
+                    active.clear();
+                    for(size_t t=0; t<remaining.size(); ++t)
+                        if (! LigneA[remaining[t]].empty())
+                            active.push_back(remaining[t]);
+                }
+
+                while( MOD > 1) {
+                    MOD /= PRIME;
+                    ranks.push_back( indcol );
+                }
+
+                    // pivot columns first, as Q.permute in gauss_rankin
+                std::vector<size_t> position(Nj), label(Nj);
+                for(size_t j=0; j<Nj; ++j) position[j] = label[j] = j;
+                for(size_t r=0; r<pivots.size(); ++r) {
+                    const size_t c = position[pivots[r]];
+                    if (c != r) {
+                        Q.permute(r,c);
+                        std::swap(label[r],label[c]);
+                        position[label[r]] = r;
+                        position[label[c]] = c;
+                    }
+                }
+
+#ifdef LINBOX_PRANK_OUT
+                std::cerr << "Rank mod " << FMOD << " : " << indcol << " in " << stamp << " steps" << std::endl;
+#endif
+                commentator().stop ("done", 0, "PPRGE");
+            }
+
 		template<class Modulo, class BB, class D, class Container, class Perm>
 		void prime_power_rankin (Modulo FMOD, Modulo PRIME, Container& ranks, BB& SLA, Perm& Q, const size_t Ni, const size_t Nj, const D& density_trait, int StaticParameters=PRIVILEGIATE_NO_COLUMN_PIVOTING)
             {
-                if (PRIVILEGIATE_NO_COLUMN_PIVOTING & StaticParameters) {
+                if (PARALLEL_PIVOTING & StaticParameters) {
+                    gauss_rankin_parallel(FMOD,PRIME,ranks, SLA, Q, Ni, Nj);
+                } else if (PRIVILEGIATE_NO_COLUMN_PIVOTING & StaticParameters) {
                     if (PRESERVE_UPPER_MATRIX & StaticParameters) {
                         gauss_rankin<Modulo,BB,D,Container,Perm,true,true>(FMOD,PRIME,ranks, SLA, Q, Ni, Nj, density_trait);
                     } else {
@@ -25,6 +25,8 @@
 #ifndef __LINBOX_pp_gauss_poweroftwo_H
 #define __LINBOX_pp_gauss_poweroftwo_H
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <givaro/givconfig.h> // for Signed_Trait
 #include "linbox/algorithms/smith-form-sparseelim-local.h"
 
@@ -95,7 +97,7 @@ namespace LinBox
             //  IEEE Trans. on Computers, 63(8), pp 2106-2109, 2014]
             // http://doi.org/10.1109/TC.2013.94
         UInt_t& MY_Zpz_inv (UInt_t& u1, const UInt_t& a, const size_t exponent, const UInt_t& TWOTOEXPMONE) const {
-            static const UInt_t ttep2(TWOTOEXPMONE+3U);
+            const UInt_t ttep2(TWOTOEXPMONE+3U);
             if (this->isOne(a)) return u1=this->one;
             REQUIRE( (one<<exponent) == (TWOTOEXPMONE+1U) );
             REQUIRE( a <= TWOTOEXPMONE );
@@ -349,6 +351,52 @@ namespace LinBox
             }
         }
 
+            // lignecourante <-- lignecourante + headcoeff * lignepivot,
+            // dropping column indcol. lignepivot has no entry in the
+            // other pivot columns of the step (see gauss_rankin_parallel)
+        template<class Vecteur>
+        void FaireEliminationIndependante( const UInt_t& TWOKMONE,
+                                           Vecteur& lignecourante,
+                                           const Vecteur& lignepivot,
+                                           const UInt_t& headcoeff,
+                                           const size_t indcol) const {
+            typedef typename Vecteur::value_type E;
+
+            const size_t nj = lignecourante.size();
+            const size_t npiv = lignepivot.size();
+            Vecteur construit(nj + npiv);
+
+            size_t j=0, m=0, l=0;
+            while ((m<nj) || (l<npiv)) {
+                if ((l==npiv) || ((m<nj) && (lignecourante[m].first < lignepivot[l].first))) {
+                    if (lignecourante[m].first != indcol)
+                        construit[j++] = lignecourante[m];
+                    ++m;
+                } else if ((m==nj) || (lignepivot[l].first < lignecourante[m].first)) {
+                    if (lignepivot[l].first != indcol) {
+                        UInt_t tmp(headcoeff);
+                        tmp *= (UInt_t)lignepivot[l].second;
+                        tmp &= TWOKMONE;
+                        if (isNZero(tmp))
+                            construit[j++] = E(lignepivot[l].first, tmp);
+                    }
+                    ++l;
+                } else {
+                    if (lignecourante[m].first != indcol) {
+                        UInt_t tmp(headcoeff);
+                        tmp *= (UInt_t)lignepivot[l].second;
+                        tmp += (UInt_t)lignecourante[m].second;
+                        tmp &= TWOKMONE;
+                        if (isNZero(tmp))
+                            construit[j++] = E(lignecourante[m].first, tmp);
+                    }
+                    ++m; ++l;
+                }
+            }
+            construit.resize(j);
+            lignecourante = construit;
+        }
+
             // ------------------------------------------------------
             // Rank calculators, defining row strategy
             // ------------------------------------------------------
@@ -530,9 +578,201 @@ namespace LinBox
 
             }
 
+            // Sets of independent odd pivots, eliminated in parallel;
+            // see PowerGaussDomain::gauss_rankin_parallel
+        template<class BB, class Container, class Perm>
+        void gauss_rankin_parallel(size_t EXPONENTMAX, Container& ranks, BB& LigneA, Perm& Q, const size_t Ni, const size_t Nj)
+            {
+                commentator().start ("Parallel Gaussian elimination modulo a prime power of 2",
+                                     "PPRGEPo2", Ni);
+
+                linbox_check( Q.coldim() == Q.rowdim() );
+                linbox_check( Q.coldim() == Nj );
+
+                ranks.resize(0);
+
+                typedef typename BB::Row Vecteur;
+                uint64_t EXPONENT = EXPONENTMAX;
+                UInt_t TWOK(1U); TWOK <<= EXPONENT;
+                UInt_t TWOKMONE(TWOK); --TWOKMONE;
+
+#ifdef LINBOX_PRANK_OUT
+                std::cerr << "Parallel elimination mod " << TWOK << std::endl;
+#endif
+
+                    // assignment of LigneA with the domain object
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                for(long jj=0; jj<(long)Ni; ++jj) {
+                    Vecteur & row = LigneA[(size_t)jj];
+                    size_t rs=0;
+                    for(size_t k=0; k<row.size(); ++k) {
+                        UInt_t r = ((UInt_t)row[k].second) & TWOKMONE;
+                        if (isNZero(r)) {
+                            row[rs] = row[k];
+                            row[rs].second = r;
+                            ++rs;
+                        }
+                    }
+                    row.resize(rs);
+                }
+
+                size_t indcol(0), stamp(0);
+                std::vector<size_t> col_density(Nj);
+                std::vector<size_t> pivotRow(Nj, Ni);   // row of the pivot in column j
+                std::vector<size_t> pivotCol(Ni, Nj);   // column of the pivot in row i
+                std::vector<UInt_t> headinv(Nj);        // inverse of the pivot in column j
+                std::vector<size_t> pivotMark(Nj, 0), touchMark(Nj, 0);
+                std::vector<size_t> pivots;             // pivot columns, in order
+
+                std::vector<size_t> active, selected, remaining;
+                for(size_t i=0; i<Ni; ++i)
+                    if (! LigneA[i].empty()) active.push_back(i);
+
+                    // candidate : (cost, row, column)
+                typedef std::pair<size_t, std::pair<size_t,size_t> > Candidate;
+                std::vector<Candidate> candidates;
+
+                while (! active.empty()) {
+                    ++stamp;
+                    commentator().progress ((long)indcol);
+
+                    std::fill(col_density.begin(), col_density.end(), 0);
+                    for(size_t t=0; t<active.size(); ++t) {
+                        const Vecteur & row = LigneA[active[t]];
+                        for(size_t k=0; k<row.size(); ++k)
+                            ++col_density[row[k].first];
+                    }
+
+                    candidates.resize(active.size());
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                    for(long t=0; t<(long)active.size(); ++t) {
+                        const Vecteur & row = LigneA[active[(size_t)t]];
+                        size_t c = Nj;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if ( this->isOdd((UInt_t)row[k].second)
+                                 && ((c == Nj) || (col_density[row[k].first] < col_density[c])) )
+                                c = row[k].first;
+                        const size_t cost = (c == Nj ? (size_t)-1 : (row.size()-1)*(col_density[c]-1));
+                        candidates[(size_t)t] = Candidate(cost, std::pair<size_t,size_t>(active[(size_t)t], c));
+                    }
+                    std::sort(candidates.begin(), candidates.end());
+
+                    if (candidates[0].second.second == Nj) {
+                            // No invertible pivot found
+                            // reduce everything by one power of 2
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                        for(long t=0; t<(long)active.size(); ++t) {
+                            Vecteur & row = LigneA[active[(size_t)t]];
+                            for(size_t k=0; k<row.size(); ++k)
+                                row[k].second >>= 1;
+                        }
+                        --EXPONENT;
+                        TWOK >>= 1;
+                        TWOKMONE >>= 1;
+                        ranks.push_back( indcol );
+#ifdef LINBOX_PRANK_OUT
+                        std::cerr << "Rank mod 2^" << ranks.size() << " : " << indcol << std::endl;
+#endif
+                        continue;
+                    }
+
+                        // greedy choice of independent pivots
+                    const size_t bound = (candidates[0].first + 1) * LINBOX_pp_gauss_RELAX;
+                    selected.clear();
+                    for(size_t t=0; t<candidates.size() && candidates[t].first <= bound; ++t) {
+                        const size_t i = candidates[t].second.first;
+                        const size_t j = candidates[t].second.second;
+                        if (touchMark[j] == stamp) continue;
+                        const Vecteur & row = LigneA[i];
+                        bool independent = true;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if (pivotMark[row[k].first] == stamp) {
+                                independent = false;
+                                break;
+                            }
+                        if (! independent) continue;
+                        pivotMark[j] = stamp;
+                        for(size_t k=0; k<row.size(); ++k)
+                            touchMark[row[k].first] = stamp;
+                        selected.push_back(i);
+
+                        pivotRow[j] = i;
+                        pivotCol[i] = j;
+                        size_t k=0;
+                        while (row[k].first != j) ++k;
+                        MY_Zpz_inv(headinv[j], (UInt_t)row[k].second, EXPONENT, TWOKMONE);
+                        pivots.push_back(j);
+                        ++indcol;
+                    }
+
+                    remaining.clear();
+                    for(size_t t=0; t<active.size(); ++t)
+                        if (pivotCol[active[t]] == Nj)
+                            remaining.push_back(active[t]);
+
+                        // every remaining row is updated by all the pivots it meets
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, LINBOX_pp_gauss_GRAIN)
+#endif
+                    for(long t=0; t<(long)remaining.size(); ++t) {
+                        Vecteur & row = LigneA[remaining[(size_t)t]];
+                        std::vector<std::pair<size_t,UInt_t> > hits;
+                        for(size_t k=0; k<row.size(); ++k)
+                            if (pivotMark[row[k].first] == stamp)
+                                hits.push_back(std::pair<size_t,UInt_t>(row[k].first, (UInt_t)row[k].second));
+                        for(size_t h=0; h<hits.size(); ++h) {
+                            const size_t j = hits[h].first;
+                            UInt_t headcoeff = TWOK-hits[h].second;
+                            headcoeff *= headinv[j];
+                            headcoeff &= TWOKMONE;
+                            FaireEliminationIndependante(TWOKMONE, row, LigneA[pivotRow[j]], headcoeff, j);
+                        }
+                    }
+
+                    for(size_t t=0; t<selected.size(); ++t)
+                        LigneA[selected[t]] = Vecteur(0);
+
+                    active.clear();
+                    for(size_t t=0; t<remaining.size(); ++t)
+                        if (! LigneA[remaining[t]].empty())
+                            active.push_back(remaining[t]);
+                }
+
+                while( TWOK > 1) {
+                    TWOK >>= 1;
+                    ranks.push_back( indcol );
+                }
+
+                    // pivot columns first, as Q.permute in gauss_rankin
+                std::vector<size_t> position(Nj), label(Nj);
+                for(size_t j=0; j<Nj; ++j) position[j] = label[j] = j;
+                for(size_t r=0; r<pivots.size(); ++r) {
+                    const size_t c = position[pivots[r]];
+                    if (c != r) {
+                        Q.permute(r,c);
+                        std::swap(label[r],label[c]);
+                        position[label[r]] = r;
+                        position[label[c]] = c;
+                    }
+                }
+
+#ifdef LINBOX_PRANK_OUT
+                std::cerr << "Rank mod 2^" << EXPONENTMAX << " : " << indcol << " in " << stamp << " steps" << std::endl;
+#endif
+                commentator().stop ("done", 0, "PPRGEPo2");
+            }
+
         template<class BB, class D, class Container, class Perm>
         void prime_power_rankin (size_t EXPONENT, Container& ranks, BB& SLA, Perm& Q, const size_t Ni, const size_t Nj, const D& density_trait, int StaticParameters=PRIVILEGIATE_NO_COLUMN_PIVOTING) {
-            if (PRIVILEGIATE_NO_COLUMN_PIVOTING & StaticParameters) {
+            if (PARALLEL_PIVOTING & StaticParameters) {
+                gauss_rankin_parallel(EXPONENT,ranks, SLA, Q, Ni, Nj);
+            } else if (PRIVILEGIATE_NO_COLUMN_PIVOTING & StaticParameters) {
                 if (PRESERVE_UPPER_MATRIX & StaticParameters) {
                     gauss_rankin<BB,D,Container,Perm,true,true>(EXPONENT,ranks, SLA, Q, Ni, Nj, density_trait);
                 } else {
@@ -43,6 +43,8 @@
 #include <linbox/util/error.h>
 
 #include <string>
+#include <mutex>
+#include <condition_variable>
 
 #ifndef __VALENCE_FACTOR_LOOPS__
 #define __VALENCE_FACTOR_LOOPS__ 50000
@@ -56,6 +58,21 @@
 # endif
 #endif
 
+// Strategy of the eliminations modulo prime powers
+#ifndef __VALENCE_LOCAL_PIVOTING__
+# ifdef __LINBOX_USE_OPENMP
+#  define __VALENCE_LOCAL_PIVOTING__ PARALLEL_PIVOTING
+# else
+#  define __VALENCE_LOCAL_PIVOTING__ PRIVILEGIATE_NO_COLUMN_PIVOTING
+# endif
+#endif
+
+// Maximal number of eliminations modulo prime powers running at the
+// same time (each one holds its own copy of the matrix)
+#ifndef __VALENCE_LOCAL_MATRICES__
+#define __VALENCE_LOCAL_MATRICES__ 2
+#endif
+
 #ifdef __LINBOX_USE_OPENMP
 #include <omp.h>
 #define THREAD_NUM omp_get_thread_num()
@@ -70,6 +87,30 @@
 
 namespace LinBox {
 
+    // Holds one of the __VALENCE_LOCAL_MATRICES__ slots of the
+    // local eliminations, waiting for it if needed
+class LocalEliminationSlot {
+    static std::mutex& lock() { static std::mutex m; return m; }
+    static std::condition_variable& freed() { static std::condition_variable c; return c; }
+    static size_t& used() { static size_t u(0); return u; }
+
+    LocalEliminationSlot(const LocalEliminationSlot&) = delete;
+    LocalEliminationSlot& operator=(const LocalEliminationSlot&) = delete;
+public:
+    LocalEliminationSlot() {
+        std::unique_lock<std::mutex> guard(lock());
+        freed().wait(guard, [] { return used() < __VALENCE_LOCAL_MATRICES__; });
+        ++used();
+    }
+    ~LocalEliminationSlot() {
+        {
+            std::lock_guard<std::mutex> guard(lock());
+            --used();
+        }
+        freed().notify_one();
+    }
+};
+
 template<class Field>
 size_t& TempLRank(size_t& r, const char * filename, const Field& F)
 {
@@ -185,6 +226,7 @@ std::vector<size_t>& PRank(std::vector<size_t>& ranks, size_t& effective_exponen
 #endif
 		}
 		Ring F(lq);
+		LocalEliminationSlot slot;
 		std::ifstream input(filename);
 		MatrixStream<Ring> ms( F, input );
 		SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
@@ -194,7 +236,7 @@ std::vector<size_t>& PRank(std::vector<size_t>& ranks, size_t& effective_exponen
         Permutation<Ring> Q(F,A.coldim());
 
 		Timer tim; tim.clear(); tim.start();
-		PGD.prime_power_rankin( lq, lp, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>());
+		PGD.prime_power_rankin( lq, lp, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>(), __VALENCE_LOCAL_PIVOTING__);
 		tim.stop();
 #if __VALENCE_REPORTING__
 		{
@@ -243,6 +285,7 @@ std::vector<size_t>& PRankPowerOfTwo(std::vector<size_t>& ranks, size_t& effecti
 
 	typedef Givaro::ZRing<int64_t> Ring;
 	Ring F;
+	LocalEliminationSlot slot;
 	std::ifstream input(filename);
 	MatrixStream<Ring> ms( F, input );
 	SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
@@ -252,7 +295,7 @@ std::vector<size_t>& PRankPowerOfTwo(std::vector<size_t>& ranks, size_t& effecti
     Permutation<GF2> Q(F2,A.coldim());
 
 	Timer tim; tim.clear(); tim.start();
-	PGD.prime_power_rankin( effective_exponent, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>());
+	PGD.prime_power_rankin( effective_exponent, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>(), __VALENCE_LOCAL_PIVOTING__);
 	tim.stop();
 #if __VALENCE_REPORTING__
 	{
@@ -270,6 +313,7 @@ std::vector<size_t>& PRankInteger(std::vector<size_t>& ranks, const char * filen
 	typedef Givaro::Modular<Givaro::Integer> Ring;
 	Givaro::Integer q = pow(p,uint64_t(e));
 	Ring F(q);
+	LocalEliminationSlot slot;
 	std::ifstream input(filename);
 	MatrixStream<Ring> ms( F, input );
 	SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
@@ -278,7 +322,7 @@ std::vector<size_t>& PRankInteger(std::vector<size_t>& ranks, const char * filen
     Permutation<Ring> Q(F,A.coldim());
 
 	Timer tim; tim.clear(); tim.start();
-	PGD.prime_power_rankin( q, p, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>());
+	PGD.prime_power_rankin( q, p, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>(), __VALENCE_LOCAL_PIVOTING__);
 	tim.stop();
 	if (__VALENCE_REPORTING__) {
         std::ostringstream logreport;
@@ -294,6 +338,7 @@ std::vector<size_t>& PRankIntegerPowerOfTwo(std::vector<size_t>& ranks, const ch
 {
 	typedef Givaro::ZRing<Givaro::Integer> Ring;
 	Ring ZZ;
+	LocalEliminationSlot slot;
 	std::ifstream input(filename);
 	MatrixStream<Ring> ms( ZZ, input );
 	SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
@@ -302,7 +347,7 @@ std::vector<size_t>& PRankIntegerPowerOfTwo(std::vector<size_t>& ranks, const ch
     Permutation<Ring> Q(ZZ, A.coldim());
 
 	Timer tim; tim.clear(); tim.start();
-	PGD.prime_power_rankin( e, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>());
+	PGD.prime_power_rankin( e, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>(), __VALENCE_LOCAL_PIVOTING__);
 	tim.stop();
 	if (__VALENCE_REPORTING__) {
         std::ostringstream logreport;
@@ -400,23 +445,51 @@ std::vector<Givaro::Integer>& populateSmithForm(
     return SmithDiagonal;
 }
 
-template<class Blackbox>
-std::vector<Givaro::Integer>& smithValence(std::vector<Givaro::Integer>& SmithDiagonal,
-                                           Givaro::Integer& valence,
-                                           const Blackbox& A,
-                                           const std::string& filename,
-                                           Givaro::Integer& coprimeV,
-                                           size_t method=0) {
-        // method for valence squarization:
-		//	0 for automatic, 1 for aat, 2 for ata
-        // Blackbox provides the Integer matrix rereadable from filename
-        // if valence != 0:
-		//	then the valence is not computed and the parameter is used
-        // if coprimeV != 1:
-		//  then this value is supposed to be coprime with the valence
+    // The part of the Smith form of valuation in p, as a list of
+    // [p^k, number of invariant factors of valuation k]
+std::ostream& writeLocalSmith(
+    std::ostream& out,
+    const Givaro::Integer& squarefreePrime,
+    const std::vector<size_t>& ranks,
+    const size_t& coprimeRank) {
+
+    size_t prev = (ranks.empty() ? coprimeRank : std::min(ranks.front(), coprimeRank));
+    out << squarefreePrime << "-local Smith form : ([1," << prev << "] ";
+    Givaro::Integer pk(squarefreePrime);
+    for(size_t k=1; (k < ranks.size()) && (prev < coprimeRank); ++k, pk *= squarefreePrime) {
+        const size_t r(std::min(ranks[k], coprimeRank));
+        if (r > prev) out << '[' << pk << ',' << (r-prev) << "] ";
+        prev = r;
+    }
+    if (prev < coprimeRank)
+        out << '[' << pk << ',' << (coprimeRank-prev) << "] ";
+    return out << ')';
+}
 
-    if (__VALENCE_REPORTING__)
-        std::clog << "sV threads: " << NUM_THREADS << std::endl;
+    // Task graph of smithValence, run by the master of a parallel region:
+    //  - rank modulo coprimeV (as soon as coprimeV is known)
+    //  - valence (with __LINBOX_USE_OPENMP, its CRA iterations are tasks
+    //    of the same team, see Protected::ValenceCRA)
+    //  - for each prime p of the valence: rank modulo p, then,
+    //    after both ranks, the ranks modulo the powers of p.
+    // The local Smith forms are reported as soon as they are known.
+template<class Blackbox>
+void smithValenceTasks(Givaro::Integer& valence,
+                       Givaro::Integer& coprimeV,
+                       size_t& coprimeR,
+                       std::vector<Givaro::Integer>& Moduli,
+                       std::vector<size_t>& exponents,
+                       std::vector<size_t>& smith,
+                       std::vector<std::vector<size_t> >& AllRanks,
+                       const Blackbox& A,
+                       const std::string& filename,
+                       size_t method) {
+
+    const bool givenCoprime(coprimeV != 1);
+    if (givenCoprime) {
+#pragma omp task shared(coprimeR,coprimeV,filename) depend(out:coprimeR)
+        LRank(coprimeR, filename.c_str(), coprimeV);
+    }
 
     if (valence == 0) {
         squarizeValence(valence, A, method);
@@ -425,9 +498,6 @@ std::vector<Givaro::Integer>& smithValence(std::vector<Givaro::Integer>& SmithDi
     if (__VALENCE_REPORTING__)
         std::clog << "Valence is " << valence << std::endl;
 
-    std::vector<Givaro::Integer> Moduli;
-	std::vector<size_t> exponents;
-
     if (__VALENCE_REPORTING__)
         std::clog << "Some factors (" << __VALENCE_FACTOR_LOOPS__ << " factoring loop bound): ";
 
@@ -440,42 +510,76 @@ std::vector<Givaro::Integer>& smithValence(std::vector<Givaro::Integer>& SmithDi
         std::clog << std::endl;
     }
 
-	std::vector< size_t > smith(Moduli.size());
-
-    if (coprimeV == 1) {
+    if (! givenCoprime) {
         coprimeV=2;
         while ( gcd(valence,coprimeV) > 1 ) {
             FTD.nextprimein(coprimeV);
         }
+#pragma omp task shared(coprimeR,coprimeV,filename) depend(out:coprimeR)
+        LRank(coprimeR, filename.c_str(), coprimeV);
     }
 
-    size_t coprimeR;
-    std::vector<std::vector<size_t> > AllRanks(Moduli.size());
+    smith.resize(Moduli.size());
+    AllRanks.resize(Moduli.size());
+    size_t * sm = smith.data();
 
     for(size_t j=0; j<Moduli.size(); ++j) {
-        { TASK(MODE(CONSTREFERENCE(Moduli,smith,filename) WRITE(smith[j]) ),
+#pragma omp task shared(Moduli,filename) firstprivate(j,sm) depend(out:sm[j])
+        LRank(sm[j], filename.c_str(), Moduli[j]);
+
+#pragma omp task shared(Moduli,exponents,AllRanks,filename,coprimeR) firstprivate(j,sm) depend(in:sm[j],coprimeR)
         {
-            LRank(smith[j], filename.c_str(), Moduli[j]);
-        })}
+            AllPowersRanks(AllRanks[j], Moduli[j], sm[j], exponents[j],
+                           coprimeR, filename.c_str());
+            if (__VALENCE_REPORTING__ && (sm[j] != coprimeR)) {
+                std::ostringstream report;
+                writeLocalSmith(report, Moduli[j], AllRanks[j], coprimeR) << " on T" << THREAD_NUM << std::endl;
+                std::clog << report.str();
+            }
+        }
     }
 
-//     { TASK(MODE(CONSTREFERENCE(coprimeV,filename) WRITE(coprimeR) ),
-//     {
-        LRank(coprimeR, filename.c_str(), coprimeV);
-//     })}
-
-    WAIT;
-
-    SYNCH_GROUP(
-        for(size_t j=0; j<Moduli.size(); ++j) {
-            { TASK(MODE(CONSTREFERENCE(smith,Moduli,AllRanks,filename,coprimeR,exponents)
-                        WRITE(AllRanks[j])),
-            {
-                AllPowersRanks(AllRanks[j], Moduli[j], smith[j], exponents[j],
-                               coprimeR, filename.c_str());
-            })}
-        }
-    )
+#pragma omp taskwait
+}
+
+template<class Blackbox>
+std::vector<Givaro::Integer>& smithValence(std::vector<Givaro::Integer>& SmithDiagonal,
+                                           Givaro::Integer& valence,
+                                           const Blackbox& A,
+                                           const std::string& filename,
+                                           Givaro::Integer& coprimeV,
+                                           size_t method=0) {
+        // method for valence squarization:
+		//	0 for automatic, 1 for aat, 2 for ata
+        // Blackbox provides the Integer matrix rereadable from filename
+        // if valence != 0:
+		//	then the valence is not computed and the parameter is used
+        // if coprimeV != 1:
+		//  then this value is supposed to be coprime with the valence
+        // Run from a parallel region (e.g. a PAR_BLOCK), the tasks
+        // use its threads, otherwise a parallel region is opened.
+
+    std::vector<Givaro::Integer> Moduli;
+	std::vector<size_t> exponents;
+	std::vector< size_t > smith;
+    std::vector<std::vector<size_t> > AllRanks;
+    size_t coprimeR(0);
+
+#ifdef __LINBOX_USE_OPENMP
+    if (! omp_in_parallel()) {
+        if (__VALENCE_REPORTING__)
+            std::clog << "sV threads: " << omp_get_max_threads() << std::endl;
+#pragma omp parallel
+#pragma omp single
+        smithValenceTasks(valence, coprimeV, coprimeR, Moduli, exponents, smith, AllRanks, A, filename, method);
+    } else {
+        if (__VALENCE_REPORTING__)
+            std::clog << "sV threads: " << omp_get_num_threads() << std::endl;
+        smithValenceTasks(valence, coprimeV, coprimeR, Moduli, exponents, smith, AllRanks, A, filename, method);
+    }
+#else
+    smithValenceTasks(valence, coprimeV, coprimeR, Moduli, exponents, smith, AllRanks, A, filename, method);
+#endif
 
     for(size_t j=0; j<Moduli.size(); ++j) {
         if (smith[j] != coprimeR) {
@@ -0,0 +1,319 @@
+/* linbox/matrix/densematrix/bit-matrix.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/*! @file matrix/densematrix/bit-matrix.h
+ * @ingroup densematrix
+ * @brief Dense matrices over \f$\mathbf{F}_2\f$, packed 64 entries per word.
+ * Arithmetic (M4RM product, M4RI elimination) is in
+ * linbox/matrix/matrixdomain/bit-matrix-domain.h
+ */
+
+#ifndef __LINBOX_matrix_densematrix_bit_matrix_H
+#define __LINBOX_matrix_densematrix_bit_matrix_H
+
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "linbox/util/debug.h"
+#include "linbox/field/gf2.h"
+#include "linbox/blackbox/zo-gf2.h"
+
+namespace LinBox
+{
+
+	/** Dense matrix over \f$\mathbf{F}_2\f$, bit packed by rows.
+	 *
+	 * Entry \f$(i,j)\f$ is bit \c j%64 of word \c j/64 of row \c i.
+	 * Every row starts on a 32 bytes boundary and spans stride() words,
+	 * a multiple of 4 : the xor kernels of BitMatrixDomain then run on
+	 * whole SIMD registers without tail handling.
+	 * The padding bits of a row are always zero.
+	 *
+	 * It is also a blackbox (apply, applyTranspose) on vectors of GF2 elements.
+	 */
+	class BitMatrix {
+	public:
+		typedef GF2             Field;
+		typedef GF2::Element    Element;
+		typedef uint64_t        Word;
+		typedef BitMatrix       Self_t;
+
+		static const size_t WordBits  = 64 ; //!< entries per word
+		static const size_t RowAlign  = 4 ;  //!< rows are padded to multiples of RowAlign words
+
+		BitMatrix (const GF2 &F = GF2()) :
+			_field(F), _row(0), _col(0), _stride(0), _rep(NULL)
+		{}
+
+		//! zero \p m x \p n matrix
+		BitMatrix (const GF2 &F, size_t m, size_t n) :
+			_field(F)
+		{
+			init(m,n);
+		}
+
+		BitMatrix (const BitMatrix &A) :
+			_field(A._field)
+		{
+			init(A._row, A._col);
+			std::copy(A._rep, A._rep+_row*_stride, _rep);
+		}
+
+		/** packs a matrix over GF2.
+		 * ZeroOne<GF2> is read row by row, any other matrix through
+		 * \f$O(mn)\f$ calls to \c getEntry.
+		 */
+		template<class Matrix>
+		BitMatrix (const Matrix &A)
+		{
+			// GF2 has no state, and ZeroOne<GF2> may not hold one
+			init(A.rowdim(), A.coldim());
+			pack(A);
+		}
+
+		BitMatrix& operator= (const BitMatrix &A)
+		{
+			if (&A == this)
+				return *this;
+			_field = A._field;
+			init(A._row, A._col);
+			std::copy(A._rep, A._rep+_row*_stride, _rep);
+			return *this;
+		}
+
+		//! resizes to a zero \p m x \p n matrix.
+		void resize (size_t m, size_t n)
+		{
+			init(m,n);
+		}
+
+		size_t rowdim () const { return _row; }
+		size_t coldim () const { return _col; }
+		//! number of words per row
+		size_t stride () const { return _stride; }
+		//! number of words actually holding entries in a row
+		size_t rowWords () const { return (_col+WordBits-1)/WordBits; }
+		const Field& field () const { return _field; }
+
+		Word* rowBegin (size_t i) { return _rep + i*_stride; }
+		const Word* rowBegin (size_t i) const { return _rep + i*_stride; }
+		Word* getPointer () { return _rep; }
+		const Word* getPointer () const { return _rep; }
+
+		Element getEntry (size_t i, size_t j) const
+		{
+			linbox_check(i < _row && j < _col);
+			return (rowBegin(i)[j/WordBits] >> (j%WordBits)) & 1;
+		}
+
+		Element& getEntry (Element &x, size_t i, size_t j) const
+		{
+			return x = getEntry(i,j);
+		}
+
+		void setEntry (size_t i, size_t j, const Element &x)
+		{
+			linbox_check(i < _row && j < _col);
+			Word &w = rowBegin(i)[j/WordBits];
+			const Word b = (Word)1 << (j%WordBits);
+			w = x ? (w | b) : (w & ~b);
+		}
+
+		void zero ()
+		{
+			std::fill(_rep, _rep+_row*_stride, (Word)0);
+		}
+
+		void swapRows (size_t i, size_t k)
+		{
+			if (i != k)
+				std::swap_ranges(rowBegin(i), rowBegin(i)+_stride, rowBegin(k));
+		}
+
+		bool operator== (const BitMatrix &A) const
+		{
+			return (_row == A._row) && (_col == A._col)
+				&& std::equal(_rep, _rep+_row*_stride, A._rep);
+		}
+
+		bool operator!= (const BitMatrix &A) const
+		{
+			return !(*this == A);
+		}
+
+		/** \p T gets the transpose of this matrix.
+		 * Works on 64x64 blocks, each transposed in place with 6 rounds of
+		 * masked swaps.
+		 */
+		BitMatrix& transpose (BitMatrix &T) const
+		{
+			T._field = _field;
+			T.init(_col, _row);
+			Word blk[WordBits];
+			for (size_t I = 0 ; I < _row ; I += WordBits)
+				for (size_t J = 0 ; J < rowWords() ; ++J) {
+					const size_t h = std::min((size_t)WordBits, _row-I);
+					for (size_t i = 0 ; i < h ; ++i)
+						blk[i] = rowBegin(I+i)[J];
+					std::fill(blk+h, blk+WordBits, (Word)0);
+					transpose64(blk);
+					const size_t w = std::min((size_t)WordBits, _col-J*WordBits);
+					for (size_t j = 0 ; j < w ; ++j)
+						T.rowBegin(J*WordBits+j)[I/WordBits] = blk[j];
+				}
+			return T;
+		}
+
+		/** \f$y \gets Ax\f$.
+		 * \p x is packed first, each entry of \p y is then a parity of a
+		 * row and-ed with it.
+		 */
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector &y, const InVector &x) const
+		{
+			linbox_check(x.size() == _col && y.size() == _row);
+			std::vector<Word> px(_stride, 0);
+			for (size_t j = 0 ; j < _col ; ++j)
+				if (x[j])
+					px[j/WordBits] ^= (Word)1 << (j%WordBits);
+			for (size_t i = 0 ; i < _row ; ++i) {
+				const Word *r = rowBegin(i);
+				Word acc = 0;
+				for (size_t k = 0 ; k < _stride ; ++k)
+					acc ^= r[k] & px[k];
+				y[i] = parity(acc);
+			}
+			return y;
+		}
+
+		//! \f$y \gets A^T x\f$, the sum of the rows selected by \p x.
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector &y, const InVector &x) const
+		{
+			linbox_check(x.size() == _row && y.size() == _col);
+			std::vector<Word> py(_stride, 0);
+			for (size_t i = 0 ; i < _row ; ++i)
+				if (x[i]) {
+					const Word *r = rowBegin(i);
+					for (size_t k = 0 ; k < _stride ; ++k)
+						py[k] ^= r[k];
+				}
+			for (size_t j = 0 ; j < _col ; ++j)
+				y[j] = (py[j/WordBits] >> (j%WordBits)) & 1;
+			return y;
+		}
+
+		std::ostream& write (std::ostream &os) const
+		{
+			for (size_t i = 0 ; i < _row ; ++i) {
+				for (size_t j = 0 ; j < _col ; ++j)
+					os << (getEntry(i,j) ? '1' : '0');
+				os << std::endl;
+			}
+			return os;
+		}
+
+		static bool parity (Word w)
+		{
+#ifdef __GNUC__
+			return __builtin_parityll(w);
+#else
+			w ^= w >> 32; w ^= w >> 16; w ^= w >> 8;
+			w ^= w >> 4;  w ^= w >> 2;  w ^= w >> 1;
+			return w & 1;
+#endif
+		}
+
+	protected:
+
+		void init (size_t m, size_t n)
+		{
+			_row = m;
+			_col = n;
+			_stride = (rowWords()+RowAlign-1)/RowAlign*RowAlign;
+			_storage.assign(_row*_stride+RowAlign, 0);
+			// vector<Word> is at least word aligned: shift to the next 32 bytes boundary
+			const size_t mis = (reinterpret_cast<uintptr_t>(_storage.data())/sizeof(Word)) % RowAlign;
+			_rep = _storage.data() + (RowAlign-mis)%RowAlign;
+		}
+
+		void pack (const BitMatrix &A)
+		{
+			std::copy(A._rep, A._rep+_row*_stride, _rep);
+		}
+
+		void pack (const ZeroOne<GF2> &A)
+		{
+			for (size_t i = 0 ; i < _row ; ++i)
+				for (ZeroOne<GF2>::Row_t::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+					rowBegin(i)[*it/WordBits] ^= (Word)1 << (*it%WordBits);
+		}
+
+		template<class Matrix>
+		void pack (const Matrix &A)
+		{
+			Element x;
+			for (size_t i = 0 ; i < _row ; ++i)
+				for (size_t j = 0 ; j < _col ; ++j)
+					if (A.getEntry(x,i,j))
+						setEntry(i,j,true);
+		}
+
+		//! transposes a 64x64 bit block, row i being \p b[i]
+		static void transpose64 (Word *b)
+		{
+			Word m = 0x00000000FFFFFFFFULL;
+			for (size_t s = 32 ; s != 0 ; s >>= 1, m ^= m << s)
+				for (size_t k = 0 ; k < WordBits ; k = (k+s+1) & ~s) {
+					const Word t = ((b[k] >> s) ^ b[k+s]) & m;
+					b[k]   ^= t << s;
+					b[k+s] ^= t;
+				}
+		}
+
+		GF2                 _field;
+		size_t              _row;
+		size_t              _col;
+		size_t              _stride;
+		std::vector<Word>   _storage;
+		Word               *_rep;
+	};
+
+	inline std::ostream& operator<< (std::ostream &os, const BitMatrix &A)
+	{
+		return A.write(os);
+	}
+
+} // LinBox
+
+#endif // __LINBOX_matrix_densematrix_bit_matrix_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,307 @@
+/* linbox/matrix/matrixdomain/bit-matrix-domain.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/*! @file matrix/matrixdomain/bit-matrix-domain.h
+ * @ingroup matrixdomain
+ * @brief Linear algebra on bit packed dense matrices over \f$\mathbf{F}_2\f$.
+ *
+ * The Method of the Four Russians, as in M4RI :
+ * - product by Gray code tables (M4RM) ;
+ * - echelon forms eliminating several pivots at once (M4RI),
+ *   hence rank, determinant, system solving and nullspace.
+ *
+ * All work is done by whole rows xors, vectorised with AVX2 or SSE2 when
+ * available.
+ */
+
+#ifndef __LINBOX_matrix_matrixdomain_bit_matrix_domain_H
+#define __LINBOX_matrix_matrixdomain_bit_matrix_domain_H
+
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/linbox-tags.h"
+#include "linbox/util/error.h"
+#include "linbox/util/commentator.h"
+#include "linbox/field/gf2.h"
+#include "linbox/matrix/densematrix/bit-matrix.h"
+#include "linbox/matrix/matrix-domain.h"
+
+#if defined(__LINBOX_HAVE_AVX2_INSTRUCTIONS) || defined(__LINBOX_HAVE_SSE2_INSTRUCTIONS)
+#include <immintrin.h>
+#endif
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+// rows below which the table lookups are not worth a parallel region
+#ifndef LINBOX_BITMATRIX_PARALLEL_ROWS
+#define LINBOX_BITMATRIX_PARALLEL_ROWS 512
+#endif
+
+namespace LinBox
+{
+
+	namespace Protected {
+
+		/* xor kernels on rows of a BitMatrix.
+		 * Pointers are 32 bytes aligned and lengths multiples of
+		 * BitMatrix::RowAlign words, see BitMatrix.
+		 */
+#if defined(__LINBOX_HAVE_AVX2_INSTRUCTIONS)
+		typedef __m256i BitVect_t;
+		static const size_t BitVectWords = 4;
+		inline BitVect_t bvload (const uint64_t *p) { return _mm256_load_si256 ((const __m256i*)p); }
+		inline void bvstore (uint64_t *p, BitVect_t v) { _mm256_store_si256 ((__m256i*)p, v); }
+		inline BitVect_t bvxor (BitVect_t a, BitVect_t b) { return _mm256_xor_si256 (a, b); }
+#elif defined(__LINBOX_HAVE_SSE2_INSTRUCTIONS)
+		typedef __m128i BitVect_t;
+		static const size_t BitVectWords = 2;
+		inline BitVect_t bvload (const uint64_t *p) { return _mm_load_si128 ((const __m128i*)p); }
+		inline void bvstore (uint64_t *p, BitVect_t v) { _mm_store_si128 ((__m128i*)p, v); }
+		inline BitVect_t bvxor (BitVect_t a, BitVect_t b) { return _mm_xor_si128 (a, b); }
+#else
+		typedef uint64_t BitVect_t;
+		static const size_t BitVectWords = 1;
+		inline BitVect_t bvload (const uint64_t *p) { return *p; }
+		inline void bvstore (uint64_t *p, BitVect_t v) { *p = v; }
+		inline BitVect_t bvxor (BitVect_t a, BitVect_t b) { return a ^ b; }
+#endif
+
+		//! \f$d \gets d \oplus s\f$ on \p n words
+		inline void bitRowAddin (uint64_t *d, const uint64_t *s, size_t n)
+		{
+			for (size_t k = 0 ; k < n ; k += BitVectWords)
+				bvstore (d+k, bvxor (bvload (d+k), bvload (s+k)));
+		}
+
+		//! \f$d \gets d \oplus s_1 \oplus s_2\f$ on \p n words
+		inline void bitRowAddin (uint64_t *d, const uint64_t *s1, const uint64_t *s2, size_t n)
+		{
+			for (size_t k = 0 ; k < n ; k += BitVectWords)
+				bvstore (d+k, bvxor (bvload (d+k), bvxor (bvload (s1+k), bvload (s2+k))));
+		}
+
+		//! \f$d \gets s_1 \oplus s_2\f$ on \p n words
+		inline void bitRowAdd (uint64_t *d, const uint64_t *s1, const uint64_t *s2, size_t n)
+		{
+			for (size_t k = 0 ; k < n ; k += BitVectWords)
+				bvstore (d+k, bvxor (bvload (s1+k), bvload (s2+k)));
+		}
+
+		inline bool bitRowGet (const uint64_t *r, size_t j)
+		{
+			return (r[j/64] >> (j%64)) & 1;
+		}
+
+		//! the \p k < 64 bits of row \p r from column \p j on.
+		inline uint64_t bitRowRead (const uint64_t *r, size_t j, size_t k)
+		{
+			const size_t w = j/64, o = j%64;
+			uint64_t v = r[w] >> o;
+			if (o+k > 64)
+				v |= r[w+1] << (64-o);
+			return v & ((((uint64_t)1) << k) - 1);
+		}
+
+		//! index of the lowest bit set in \p g > 0
+		inline size_t lowestBit (size_t g)
+		{
+#ifdef __GNUC__
+			return __builtin_ctzl (g);
+#else
+			size_t b = 0;
+			while (!(g & 1)) { g >>= 1; ++b; }
+			return b;
+#endif
+		}
+
+	} // Protected
+
+	/** Dense linear algebra over \f$\mathbf{F}_2\f$ on BitMatrix.
+	 *
+	 * With \f$k\f$ rows or pivots processed at once, the \f$2^k\f$
+	 * combinations of these rows are tabulated in Gray code order (one row
+	 * xor each), then every other row is updated by a single lookup and
+	 * xor instead of up to \f$k\f$.
+	 */
+	class BitMatrixDomain {
+	public:
+		typedef GF2                 Field;
+		typedef GF2::Element        Element;
+		typedef BitMatrix           Matrix;
+		typedef BitMatrix::Word     Word;
+
+		BitMatrixDomain (const GF2 &F = GF2()) :
+			_field(F)
+		{}
+
+		const Field& field () const { return _field; }
+
+		/** \f$C \gets AB\f$.
+		 * \p C is \p A.rowdim() x \p B.coldim().
+		 */
+		BitMatrix& mul (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const;
+
+		/** \f$C \gets C + AB\f$, by the Method of the Four Russians (M4RM).
+		 * \p B is cut in slices of \f$2k\f$ rows ; for each slice, two tables
+		 * of all the combinations of \f$k\f$ rows are built and each row of
+		 * \p C is updated with two of their rows, indexed by the bits of
+		 * the corresponding row of \p A.
+		 */
+		BitMatrix& axpyin (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const;
+
+		/** Row echelon form of \p A, in place (M4RI).
+		 * Columns are processed by blocks of \f$k\f$ : up to \f$k\f$ pivots
+		 * are searched in the block, then all the other rows are reduced
+		 * against them at once through a Gray code table.
+		 * @param A the matrix, replaced by its echelon form.
+		 * The \f$r\f$ first rows are the non zero ones.
+		 * @param pivots the columns of the pivots, increasing, row by row.
+		 * @param reduced if \c true, the pivot columns are also cleared
+		 * above the pivots (reduced echelon form).
+		 * @return the rank \f$r\f$.
+		 */
+		size_t echelonize (BitMatrix &A, std::vector<size_t> &pivots, bool reduced = false) const;
+
+		size_t rankInPlace (BitMatrix &A) const
+		{
+			std::vector<size_t> pivots;
+			return echelonize (A, pivots, false);
+		}
+
+		size_t rank (const BitMatrix &A) const
+		{
+			BitMatrix B (A);
+			return rankInPlace (B);
+		}
+
+		//! determinant, \p A is modified.
+		Element& detInPlace (Element &d, BitMatrix &A) const
+		{
+			if (A.coldim() != A.rowdim())
+				throw LinboxError("LinBox ERROR: matrix must be square for determinant computation\n");
+			return d = (rankInPlace (A) == A.rowdim());
+		}
+
+		Element& det (Element &d, const BitMatrix &A) const
+		{
+			BitMatrix B (A);
+			return detInPlace (d, B);
+		}
+
+		/** A solution \p x to \f$Ax=b\f$, free variables set to zero.
+		 * @throws LinboxMathInconsistentSystem if there is none.
+		 */
+		template<class Vector1, class Vector2>
+		Vector1& solve (Vector1 &x, const BitMatrix &A, const Vector2 &b) const;
+
+		/** Right nullspace basis, as the columns of \p Ker.
+		 * \p A is replaced by its reduced echelon form.
+		 * @return the dimension of the nullspace.
+		 */
+		size_t nullspaceBasisIn (BitMatrix &Ker, BitMatrix &A) const;
+
+	protected:
+
+		//! table size exponent for \p d rows to reduce
+		static size_t tableBits (size_t d, size_t kmax = 8)
+		{
+			size_t k = 1;
+			while (k < kmax && (((size_t)2) << k) <= d)
+				++k;
+			return k;
+		}
+
+		/*! \p T[g] gets the xor of the rows \p R[i] such that bit \c i
+		 * of \c g is set, for \f$ g < 2^k\f$, on words \p w0 to \p W.
+		 * \p T[0] is zero.
+		 */
+		static void makeTable (BitMatrix &T, const Word *const *R, size_t k, size_t w0, size_t W);
+
+		GF2 _field;
+	};
+
+	/*! Nullspace of a dense matrix over \f$\mathbf{F}_2\f$.
+	 * As NullSpaceBasisIn in linbox/algorithms/dense-nullspace.h.
+	 * A is modified.
+	 * @param         Side \c Tag::Side::Left or \c Tag::Side::Right nullspace.
+	 * @param[in,out] A Input matrix
+	 * @param[out]    Ker Nullspace of the matrix, basis in columns (right)
+	 * or rows (left).
+	 * @param[out]    kerdim rank of the kernel
+	 * @return \p kerdim
+	 */
+	inline size_t&
+	NullSpaceBasisIn (const Tag::Side Side,
+			  BitMatrix & A,
+			  BitMatrix & Ker,
+			  size_t & kerdim)
+	{
+		BitMatrixDomain BMD (A.field());
+		if (Side == Tag::Side::Right)
+			kerdim = BMD.nullspaceBasisIn (Ker, A);
+		else {
+			BitMatrix At, K;
+			A.transpose (At);
+			kerdim = BMD.nullspaceBasisIn (K, At);
+			K.transpose (Ker);
+		}
+		return kerdim;
+	}
+
+	//! A is preserved.
+	inline size_t&
+	NullSpaceBasis (const Tag::Side Side,
+			const BitMatrix & A,
+			BitMatrix & Ker,
+			size_t & kerdim)
+	{
+		BitMatrix B (A);
+		return NullSpaceBasisIn (Side, B, Ker, kerdim);
+	}
+
+	inline BitMatrix &MatrixDomain<GF2>::mul (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const
+	{
+		return BitMatrixDomain (_VD.field ()).mul (C, A, B);
+	}
+
+	inline BitMatrix &MatrixDomain<GF2>::axpyin (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const
+	{
+		return BitMatrixDomain (_VD.field ()).axpyin (C, A, B);
+	}
+
+} // LinBox
+
+#include "linbox/matrix/matrixdomain/bit-matrix-domain.inl"
+
+#endif // __LINBOX_matrix_matrixdomain_bit_matrix_domain_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,220 @@
+/* linbox/matrix/matrixdomain/bit-matrix-domain.inl
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+#ifndef __LINBOX_matrix_matrixdomain_bit_matrix_domain_INL
+#define __LINBOX_matrix_matrixdomain_bit_matrix_domain_INL
+
+namespace LinBox
+{
+
+	inline void BitMatrixDomain::makeTable (BitMatrix &T, const Word *const *R, size_t k, size_t w0, size_t W)
+	{
+		// consecutive Gray codes differ by the lowest bit set in g
+		for (size_t g = 1 ; g < ((size_t)1 << k) ; ++g) {
+			const size_t cur  = g ^ (g >> 1);
+			const size_t prev = (g-1) ^ ((g-1) >> 1);
+			Protected::bitRowAdd (T.rowBegin (cur)+w0, T.rowBegin (prev)+w0,
+					      R[Protected::lowestBit (g)]+w0, W-w0);
+		}
+	}
+
+	inline BitMatrix& BitMatrixDomain::mul (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const
+	{
+		linbox_check (C.rowdim () == A.rowdim () && C.coldim () == B.coldim ());
+		C.zero ();
+		return axpyin (C, A, B);
+	}
+
+	inline BitMatrix& BitMatrixDomain::axpyin (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const
+	{
+		linbox_check (A.coldim () == B.rowdim ());
+		linbox_check (C.rowdim () == A.rowdim () && C.coldim () == B.coldim ());
+
+		const size_t m = A.rowdim (), l = A.coldim (), W = C.stride ();
+		if (!m || !l || !W)
+			return C;
+
+		// a table of 2^k rows of C pays off once there are about 2^k rows of A
+		const size_t k = tableBits (m);
+		BitMatrix T0 (field (), (size_t)1 << k, B.coldim ());
+		BitMatrix T1 (T0);
+		std::vector<const Word*> R (2*k);
+
+		for (size_t s = 0 ; s < l ; s += 2*k) {
+			const size_t k0 = std::min (k, l-s);
+			const size_t k1 = std::min (k, l-s-k0);
+			for (size_t t = 0 ; t < k0+k1 ; ++t)
+				R[t] = B.rowBegin (s+t);
+			makeTable (T0, &R[0], k0, 0, W);
+			if (k1)
+				makeTable (T1, &R[k0], k1, 0, W);
+
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m >= LINBOX_BITMATRIX_PARALLEL_ROWS)
+#endif
+			for (size_t i = 0 ; i < m ; ++i) {
+				const Word *a = A.rowBegin (i);
+				const size_t x0 = Protected::bitRowRead (a, s, k0);
+				const size_t x1 = k1 ? Protected::bitRowRead (a, s+k0, k1) : 0;
+				Word *c = C.rowBegin (i);
+				if (x0 && x1)
+					Protected::bitRowAddin (c, T0.rowBegin (x0), T1.rowBegin (x1), W);
+				else if (x0)
+					Protected::bitRowAddin (c, T0.rowBegin (x0), W);
+				else if (x1)
+					Protected::bitRowAddin (c, T1.rowBegin (x1), W);
+			}
+		}
+		return C;
+	}
+
+	/* Invariant : at the start of the block of columns [c,c+k), the rows
+	 * from r on are zero on the columns before c. Xors then start at the
+	 * aligned word w0 holding column c.
+	 */
+	inline size_t BitMatrixDomain::echelonize (BitMatrix &A, std::vector<size_t> &pivots, bool reduced) const
+	{
+		const size_t m = A.rowdim (), n = A.coldim (), W = A.stride ();
+		pivots.clear ();
+		if (!m || !n)
+			return 0;
+
+		// the pivot search costs O(k^2) per row, take k about 3/4 log(min(m,n)) as M4RI
+		const size_t k = std::max ((size_t)1, 3*tableBits (std::min (m, n), 10)/4);
+		BitMatrix T (field (), (size_t)1 << k, n);
+		std::vector<size_t> pc (k);
+		std::vector<const Word*> R (k);
+
+		size_t r = 0;
+		for (size_t c = 0 ; c < n && r < m ; c += k) {
+			const size_t kk = std::min (k, n-c);
+			const size_t w0 = (c/BitMatrix::WordBits)/BitMatrix::RowAlign*BitMatrix::RowAlign;
+
+			// pivots of the block, rows r..r+found-1, reduced among themselves
+			size_t found = 0;
+			for (size_t j = c ; j < c+kk && r+found < m ; ++j) {
+				size_t i = r+found;
+				for ( ; i < m ; ++i) {
+					Word *x = A.rowBegin (i);
+					for (size_t t = 0 ; t < found ; ++t)
+						if (Protected::bitRowGet (x, pc[t]))
+							Protected::bitRowAddin (x+w0, A.rowBegin (r+t)+w0, W-w0);
+					if (Protected::bitRowGet (x, j))
+						break;
+				}
+				if (i == m)
+					continue;
+				A.swapRows (r+found, i);
+				const Word *p = A.rowBegin (r+found);
+				for (size_t t = 0 ; t < found ; ++t)
+					if (Protected::bitRowGet (A.rowBegin (r+t), j))
+						Protected::bitRowAddin (A.rowBegin (r+t)+w0, p+w0, W-w0);
+				pc[found++] = j;
+			}
+			if (!found)
+				continue;
+
+			// T[g] has the bits g on the pivot columns
+			for (size_t t = 0 ; t < found ; ++t)
+				R[t] = A.rowBegin (r+t);
+			makeTable (T, &R[0], found, w0, W);
+
+			const size_t first = reduced ? 0 : r+found;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m-first >= LINBOX_BITMATRIX_PARALLEL_ROWS)
+#endif
+			for (size_t i = first ; i < m ; ++i) {
+				if (i >= r && i < r+found)
+					continue;
+				Word *x = A.rowBegin (i);
+				size_t g = 0;
+				for (size_t t = 0 ; t < found ; ++t)
+					g |= (size_t)Protected::bitRowGet (x, pc[t]) << t;
+				if (g)
+					Protected::bitRowAddin (x+w0, T.rowBegin (g)+w0, W-w0);
+			}
+
+			pivots.insert (pivots.end (), pc.begin (), pc.begin ()+found);
+			r += found;
+		}
+		return r;
+	}
+
+	template<class Vector1, class Vector2>
+	Vector1& BitMatrixDomain::solve (Vector1 &x, const BitMatrix &A, const Vector2 &b) const
+	{
+		linbox_check (x.size () == A.coldim () && b.size () == A.rowdim ());
+		const size_t m = A.rowdim (), n = A.coldim ();
+
+		// reduced echelon form of [A|b]
+		BitMatrix Ab (field (), m, n+1);
+		for (size_t i = 0 ; i < m ; ++i) {
+			std::copy (A.rowBegin (i), A.rowBegin (i)+A.rowWords (), Ab.rowBegin (i));
+			if (b[i])
+				Ab.setEntry (i, n, true);
+		}
+		std::vector<size_t> pivots;
+		const size_t r = echelonize (Ab, pivots, true);
+		if (r && pivots[r-1] == n)
+			throw LinboxMathInconsistentSystem ("From BitMatrixDomain solve.");
+
+		for (size_t j = 0 ; j < n ; ++j)
+			x[j] = false;
+		for (size_t t = 0 ; t < r ; ++t)
+			x[pivots[t]] = Ab.getEntry (t, n);
+		return x;
+	}
+
+	inline size_t BitMatrixDomain::nullspaceBasisIn (BitMatrix &Ker, BitMatrix &A) const
+	{
+		const size_t n = A.coldim ();
+		std::vector<size_t> pivots;
+		const size_t r = echelonize (A, pivots, true);
+
+		// one vector per free column f : x_f = 1 and x_{pivots[t]} = A[t,f]
+		Ker.resize (n, n-r);
+		for (size_t j = 0, t = 0, f = 0 ; j < n ; ++j) {
+			if (t < r && pivots[t] == j) {
+				++t;
+				continue;
+			}
+			Ker.setEntry (j, f, true);
+			for (size_t s = 0 ; s < t ; ++s)
+				if (A.getEntry (s, j))
+					Ker.setEntry (pivots[s], f, true);
+			++f;
+		}
+		return n-r;
+	}
+
+} // LinBox
+
+#endif // __LINBOX_matrix_matrixdomain_bit_matrix_domain_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -44,9 +44,11 @@
 // Specialization of MatrixDomain for GF2
 namespace LinBox
 {
+	class BitMatrix;
+
 	/*! Specialization of MatrixDomain for GF2.
 	 * @bug this is half done and makes MatrixDomain on GF2 hardly usable.
-	 * @todo this is where m4ri will play.
+	 * Products of bit packed matrices go to BitMatrixDomain (M4RM).
 	 */
 	template <>
 	class MatrixDomain<GF2> {
@@ -61,6 +63,14 @@ namespace LinBox
 			return mulSpecialized (w, A, v, typename MatrixTraits<Matrix>::MatrixCategory ());
 		}
 
+		/** \f$C \gets AB\f$ on bit packed matrices.
+		 * Defined in linbox/matrix/matrixdomain/bit-matrix-domain.h
+		 */
+		BitMatrix &mul (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const;
+
+		//! \f$C \gets C + AB\f$ on bit packed matrices.
+		BitMatrix &axpyin (BitMatrix &C, const BitMatrix &A, const BitMatrix &B) const;
+
 		template <class Vector1, class Matrix, class Vector2>
 		Vector1 &mulSpecialized (Vector1 &w, const Matrix &A, const Vector2 &v,
 					 MatrixCategories::RowMatrixTag) const
@@ -46,12 +46,62 @@ uint64_t max_memory=0, cur_memory=0;
 #endif
 
 #define COPY_BLOCKSIZE 32
+// below this number of elements a layout conversion stays sequential
+#ifndef COPY_PARALLEL_THRESHOLD
+#define COPY_PARALLEL_THRESHOLD (1<<16)
+#endif
 
 namespace LinBox{
 
 	enum PMType {polfirst, matfirst};
 	enum PMStorage {plain, view, const_view};
 
+	namespace Protected {
+		// Conversion between the polfirst and matfirst layouts, which is a
+		// transposition of the (entries x coefficients) array: f(j,k) is
+		// called for every entry j in [j0,j1) and coefficient k in [k0,k1).
+		// The largest range is halved until the block is at most
+		// COPY_BLOCKSIZE x COPY_BLOCKSIZE, so that both sides are walked in
+		// cache sized tiles whatever the dimensions and the degree.
+		template<typename Func>
+		void layout_transpose(size_t j0, size_t j1, size_t k0, size_t k1, Func& f)
+		{
+			while ((j1-j0)*(k1-k0) > COPY_BLOCKSIZE*COPY_BLOCKSIZE) {
+				if (j1-j0 >= k1-k0) {
+					size_t jm=j0+(j1-j0)/2;
+					layout_transpose(j0,jm,k0,k1,f);
+					j0=jm;
+				}
+				else {
+					size_t km=k0+(k1-k0)/2;
+					layout_transpose(j0,j1,k0,km,f);
+					k0=km;
+				}
+			}
+			for (size_t k=k0;k<k1;k++)
+				for (size_t j=j0;j<j1;j++)
+					f(j,k);
+		}
+
+		// Same, the coefficients being split in strips among the threads.
+		// f must be safe to call concurrently on distinct (j,k).
+		template<typename Func>
+		void layout_transpose_par(size_t entries, size_t k0, size_t k1, Func& f)
+		{
+#ifdef __LINBOX_USE_OPENMP
+			const size_t strip = 4*COPY_BLOCKSIZE;
+			if (entries*(k1-k0) >= COPY_PARALLEL_THRESHOLD && k1-k0 > strip) {
+				const size_t nstrips = (k1-k0+strip-1)/strip;
+#pragma omp parallel for schedule(static)
+				for (size_t t=0;t<nstrips;t++)
+					layout_transpose(0,entries,k0+t*strip,std::min(k1,k0+(t+1)*strip),f);
+				return;
+			}
+#endif
+			layout_transpose(0,entries,k0,k1,f);
+		}
+	}
+
 	// Generic handler class for Polynomial Matrix
 	template<size_t type, size_t storage, class Field>
 	class PolynomialMatrix;
@@ -191,13 +241,10 @@ namespace LinBox{
 		// copy elt from M[beg..end], _size must be >= j-i
 		void copy(const Self_t& M, size_t beg, size_t end){
 			//cout<<"copying.....polfirst to polfirst.....same field"<<endl;
-			for (size_t k=0;k<_row*_col;k++){
-				size_t j=0;
-				for (size_t i=beg;i<=end;i++){
-					ref(k,j)=M.get(k,i);
-					j++;
-				}
-			}
+			// both sides are contiguous per entry
+			for (size_t k=0;k<_row*_col;k++)
+				std::copy(M._rep.begin()+k*M._store+beg, M._rep.begin()+k*M._store+end+1,
+					  _rep.begin()+k*_store);
 		}
 		template<typename OtherField>
 		void copy(const PolynomialMatrix<PMType::polfirst,PMStorage::plain,OtherField> & M, size_t beg, size_t end){
@@ -216,13 +263,8 @@ namespace LinBox{
 		template <size_t storage>
 		void copy(const PolynomialMatrix<PMType::matfirst,storage,Field>& M, size_t beg, size_t end){
 			//std::cout<<"copying.....matfirst to polfirst.....same field"<<std::endl;
-			const size_t ls = COPY_BLOCKSIZE;
-			for (size_t i = beg; i <= end; i+=ls)
-				for (size_t j = 0; j < _col * _row; j+=ls)
-					// Rk: the two loop must be interchanged in some cases
-					for (size_t _i = i; _i < std::min(end+1, i + ls); _i++)
-						for (size_t _j = j; _j < std::min(_col * _row, j + ls);++_j)
-							ref(_j,_i-beg)= M.get(_j,_i);
+			auto f = [&](size_t j, size_t i){ ref(j,i-beg) = M.get(j,i); };
+			Protected::layout_transpose_par(_row*_col, beg, end+1, f);
 		}
 
 		// copy elt from M[beg..end], _size must be >= end-beg+1
@@ -230,14 +272,9 @@ namespace LinBox{
 		template<size_t storage, typename OtherField>
 		void copy(const PolynomialMatrix<PMType::matfirst,storage,OtherField> & M, size_t beg, size_t end){
 			//std::cout<<"copying.....matfirst to polfirst.....other field"<<std::endl;
-			const size_t ls = COPY_BLOCKSIZE;
 			Hom<OtherField,Field> hom(M.field(),field()) ;
-			for (size_t i = beg; i <= end; i+=ls)
-				for (size_t j = 0; j < _col * _row; j+=ls)
-					for (size_t _i = i; _i < std::min(end+1, i + ls); _i++) {
-						for (size_t _j = j; _j < std::min(_col * _row, j + ls);++_j)
-							hom.image(ref(_j,_i-beg),M.get(_j,_i) );
-					}
+			auto f = [&](size_t j, size_t i){ hom.image(ref(j,i-beg),M.get(j,i)); };
+			Protected::layout_transpose(0, _row*_col, beg, end+1, f);
 		}
 
 		template<typename Mat>
@@ -440,13 +477,8 @@ namespace LinBox{
 		// M is stored as a Matrix of Polynomials
 		void copy(const Other_t& M, size_t beg, size_t end, size_t start=0){
 			//cout<<"copying.....polfirst to matfirst.....same field"<<endl;
-			const size_t ls = COPY_BLOCKSIZE; // Loop unrooling to be more cache-friendly (cache block transposition)
-			for(size_t i = beg; i < end+1; i+=ls)
-				for (size_t j = 0; j < _col * _row; j+=ls)
-					for (size_t _i = i; _i < std::min(end+1, i + ls); _i++) {
-						for (size_t _j = j; _j < std::min(_col * _row, j + ls); _j++)
-							ref(_j,start+_i-beg) = M.get(_j,_i);
-					}
+			auto f = [&](size_t j, size_t i){ ref(j,start+i-beg) = M.get(j,i); };
+			Protected::layout_transpose_par(_row*_col, beg, end+1, f);
 		}
 
 		// copy elt from M[beg..end], _size must be >= end-beg+1
@@ -454,14 +486,9 @@ namespace LinBox{
 		template<typename OtherField>
 		void copy(const PolynomialMatrix<PMType::polfirst,PMStorage::plain,OtherField> & M, size_t beg, size_t end, size_t start=0){
 			//cout<<"copying.....polfirst to matfirst.....other field"<<endl;
-			const size_t ls = COPY_BLOCKSIZE;
 			Hom<OtherField,Field> hom(M.field(),field()) ;
-			for(size_t i = beg; i < end+1; i+=ls)
-				for (size_t j = 0; j < _col * _row; j+=ls)
-					for (size_t _i = i; _i < std::min(end+1, i + ls); _i++) {
-						for (size_t _j = j; _j < std::min(_col * _row, j + ls); _j++)
-							hom.image(ref(_j,start+_i-beg) , M.get(_j,_i));
-					}
+			auto f = [&](size_t j, size_t i){ hom.image(ref(j,start+i-beg),M.get(j,i)); };
+			Protected::layout_transpose(0, _row*_col, beg, end+1, f);
 		}
 
 		template<typename Mat>
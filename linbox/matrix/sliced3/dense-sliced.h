@@ -14,6 +14,9 @@
   into a pair of ints. The int type is a template parameter.
 */
 
+#include <vector>
+#include <algorithm>
+
 #include "dense-matrix.h"
 //#include <linbox/util/timer.h>
 //#include "sliced-stepper.h"
@@ -417,8 +420,69 @@ public:
 	//  (only seems to work if row packed so far)
 	//  (does not check for compatible sizes)
 	//  (does NOT work yet for two submatrices)
+	//  word aligned row packed operands go to the Four Russians table product.
 	template <class Gettable>
 	Sliced & mul(Gettable& A, Sliced& B){
+		if(!_colPacked && !B._colPacked && !_loff && !_roff && !B._loff && !B._roff)
+			return mulTable(A, B);
+		return mulEntries(A, B);
+	}
+
+	//  Four Russians: for each slice of k rows of B, the 3^k combinations
+	//  of these rows are tabulated, one unit row add each, then every row
+	//  of C gets a single add, indexed by the k entries of A read in base 3.
+	template <class Gettable>
+	Sliced & mulTable(Gettable& A, Sliced& B){
+		zero();
+		const size_t m = rowdim(), l = A.coldim();
+		const size_t units = Matrix::coldim();
+		if(!m || !l || !units)
+			return *this;
+
+		//  3^k table rows are paid once per slice, against m row updates.
+		size_t k = 1, tsize = 3;
+		while(k < 6 && 3*tsize <= m){ ++k; tsize *= 3; }
+		std::vector<SlicedUnit> T(tsize*units);
+		for(size_t u = 0; u < units; ++u)
+			T[u].zero();
+
+		for(size_t s = 0; s < l; s += k){
+			const size_t kk = std::min(k, l-s);
+			//  T[x] for 3^t <= x < 3^(t+1) : T[x - 3^t] + row s+t of B
+			for(size_t t = 0, pw = 1; t < kk; ++t, pw *= 3){
+				const SlicedUnit *b = B._rep + (s+t)*B._stride;
+				for(size_t x = pw; x < 3*pw; ++x){
+					SlicedUnit *d = &T[x*units];
+					const SlicedUnit *e = &T[(x-pw)*units];
+					for(size_t u = 0; u < units; ++u){
+						d[u] = e[u];
+						d[u] += b[u];
+					}
+				}
+			}
+
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m >= 512)
+#endif
+			for(size_t i = 0; i < m; ++i){
+				Scalar a_ij;
+				size_t x = 0;
+				for(size_t t = kk; t-- > 0; )
+					x = 3*x + (size_t)A.getEntry(a_ij, i, s+t);
+				if(!x)
+					continue;
+				SlicedUnit *c = _rep + i*_stride;
+				const SlicedUnit *e = &T[x*units];
+				for(size_t u = 0; u < units; ++u)
+					c[u] += e[u];
+			}
+		}
+		return *this;
+	}
+
+	//  entry by entry axpy of the rows of B, for submatrices.
+	template <class Gettable>
+	Sliced & mulEntries(Gettable& A, Sliced& B){
 		zero();
 
 		Scalar a_ij;
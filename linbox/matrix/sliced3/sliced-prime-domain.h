@@ -0,0 +1,433 @@
+/* linbox/matrix/sliced3/sliced-prime-domain.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/*! @file matrix/sliced3/sliced-prime-domain.h
+ * @ingroup matrix
+ * @brief Linear algebra on bitsliced dense matrices over
+ * \f$\mathbf{F}_3\f$, \f$\mathbf{F}_5\f$ and \f$\mathbf{F}_7\f$.
+ *
+ * - product by the Method of the Four Russians ;
+ * - echelon forms (row and column permutations of PLUQ, \f$L\f$ not
+ *   kept), hence rank, determinant and system solving.
+ *
+ * slicedRank, slicedDet and slicedSolve pack a dense matrix over
+ * Givaro::Modular or Givaro::ModularBalanced of characteristic 3, 5 or 7.
+ * The dense elimination methods of rank, det and solve try them first,
+ * for matrices of order at least \c LINBOX_SLICED_THRESHOLD only. It is
+ * 0, off, unless defined before the LinBox headers.
+ */
+
+#ifndef __LINBOX_matrix_sliced3_sliced_prime_domain_H
+#define __LINBOX_matrix_sliced3_sliced_prime_domain_H
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "linbox/linbox-config.h"
+#include "linbox/ring/modular.h"
+#include "linbox/util/error.h"
+#include "linbox/matrix/sliced3/sliced-prime.h"
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+// rows below which the row updates are not worth a parallel region
+#ifndef LINBOX_SLICED_PARALLEL_ROWS
+#define LINBOX_SLICED_PARALLEL_ROWS 256
+#endif
+
+// smallest order from which rank, det and solve by dense elimination go
+// the bitsliced way, 0 never. Opt-in : it is off by default, since
+// FFPACK's delayed reductions make the crossover machine dependent and
+// no default was measured. Time benchmark-dense-solve -q 3 with either
+// setting, then define it (e.g. -DLINBOX_SLICED_THRESHOLD=512) to enable
+// it. slicedRank, slicedDet and slicedSolve also return false when off.
+#ifndef LINBOX_SLICED_THRESHOLD
+#define LINBOX_SLICED_THRESHOLD 0
+#endif
+
+namespace LinBox
+{
+
+	/** Dense linear algebra over \f$\mathbf{F}_p\f$ on SlicedPrime<p>.
+	 *
+	 * Every row operation is a bitsliced addition of whole rows : a
+	 * product by a scalar \f$c\f$ is never computed, but looked up in a
+	 * table of multiples or of combinations built once, one row addition
+	 * per table row.
+	 */
+	template<size_t p>
+	class SlicedPrimeDomain {
+	public:
+		typedef SlicedPrime<p>              Matrix;
+		typedef typename Matrix::Arith      Arith;
+		typedef typename Matrix::Word       Word;
+		typedef size_t                      Element;
+
+		static const size_t K = Matrix::K ;
+
+		//! \f$x \gets x+y\f$ on \p g groups
+		static void rowAddin (Word *x, const Word *y, size_t g)
+		{
+			for (size_t k = 0 ; k < g*K ; k += K)
+				Arith::add (x+k, x+k, y+k);
+		}
+
+		//! \f$r \gets x+y\f$ on \p g groups
+		static void rowAdd (Word *r, const Word *x, const Word *y, size_t g)
+		{
+			for (size_t k = 0 ; k < g*K ; k += K)
+				Arith::add (r+k, x+k, y+k);
+		}
+
+		//! inverse of \p a in \f$[1,p)\f$
+		static Element inv (Element a)
+		{
+			Element b = 1;
+			while ((a*b) % p != 1)
+				++b;
+			return b;
+		}
+
+		/** \f$C \gets AB\f$.
+		 * \p C is \p A.rowdim() x \p B.coldim().
+		 */
+		Matrix& mul (Matrix &C, const Matrix &A, const Matrix &B) const
+		{
+			linbox_check (C.rowdim () == A.rowdim () && C.coldim () == B.coldim ());
+			C.zero ();
+			return axpyin (C, A, B);
+		}
+
+		/** \f$C \gets C + AB\f$, by the Method of the Four Russians.
+		 * For each slice of \f$k\f$ rows of \p B, the table of the
+		 * \f$p^k\f$ combinations of these rows is built, each from a
+		 * previous one by a single row addition.
+		 * Each row of \p C is then updated by one addition, with the row
+		 * indexed by the \f$k\f$ corresponding entries of \p A in base \p p.
+		 */
+		Matrix& axpyin (Matrix &C, const Matrix &A, const Matrix &B) const
+		{
+			linbox_check (A.coldim () == B.rowdim ());
+			linbox_check (C.rowdim () == A.rowdim () && C.coldim () == B.coldim ());
+
+			const size_t m = A.rowdim (), l = A.coldim (), G = C.rowGroups ();
+			if (!m || !l || !G)
+				return C;
+
+			// p^k table rows are paid once per slice, against m row updates
+			size_t k = 1, tsize = p;
+			while (p*tsize <= std::min (m, (size_t)1024)) {
+				++k;
+				tsize *= p;
+			}
+			Matrix T (tsize, B.coldim ());
+
+			for (size_t s = 0 ; s < l ; s += k) {
+				const size_t kk = std::min (k, l-s);
+				// T[x] for p^t <= x < p^(t+1) : T[x - p^t] + B[s+t]
+				for (size_t t = 0, pw = 1 ; t < kk ; ++t, pw *= p)
+					for (size_t x = pw ; x < p*pw ; ++x)
+						rowAdd (T.rowBegin (x), T.rowBegin (x-pw), B.rowBegin (s+t), G);
+
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m >= LINBOX_SLICED_PARALLEL_ROWS)
+#endif
+				for (size_t i = 0 ; i < m ; ++i) {
+					size_t x = 0;
+					for (size_t t = kk ; t-- > 0 ; )
+						x = p*x + A.getEntry (i, s+t);
+					if (x)
+						rowAddin (C.rowBegin (i), T.rowBegin (x), G);
+				}
+			}
+			return C;
+		}
+
+		/** Row echelon form of \p A, in place.
+		 * Pivots are searched column by column, rows are swapped to
+		 * bring them up (the \f$P\f$ and \f$Q\f$ of a PLUQ decomposition,
+		 * \f$L\f$ is not kept).
+		 * Each pivot row is made monic and its \f$p\f$ multiples are
+		 * tabulated, so that eliminating a row is a single row addition.
+		 * @param A the matrix, replaced by its echelon form.
+		 * The \f$r\f$ first rows are the non zero ones, with unit pivots.
+		 * @param pivots the columns of the pivots, increasing, row by row.
+		 * @param reduced if \c true, the pivot columns are also cleared
+		 * above the pivots (reduced echelon form).
+		 * @param d if not \c NULL, gets the product of the pivots times the
+		 * sign of the row permutation.
+		 * @return the rank \f$r\f$.
+		 */
+		size_t echelonize (Matrix &A, std::vector<size_t> &pivots, bool reduced = false, Element *d = NULL) const
+		{
+			const size_t m = A.rowdim (), n = A.coldim (), G = A.rowGroups ();
+			pivots.clear ();
+			Element dp = 1;
+			Matrix M (p, n);
+
+			size_t r = 0;
+			for (size_t c = 0 ; c < n && r < m ; ++c) {
+				size_t i = r;
+				while (i < m && !A.getEntry (i, c))
+					++i;
+				if (i == m)
+					continue;
+				if (i != r) {
+					A.swapRows (r, i);
+					dp = p-dp;
+				}
+
+				// rows from r on are zero before c: work from the group of c on
+				const size_t g0 = c/Matrix::WordBits, W = G-g0, o = g0*K;
+				Word *piv = A.rowBegin (r)+o;
+				const Element a = A.getEntry (r, c);
+				dp = (dp*a) % p;
+				if (a != 1) {
+					std::copy (piv, piv+W*K, M.rowBegin (1)+o);
+					for (Element e = 2 ; e < p ; ++e)
+						rowAdd (M.rowBegin (e)+o, M.rowBegin (e-1)+o, piv, W);
+					const Element ai = inv (a);
+					std::copy (M.rowBegin (ai)+o, M.rowBegin (ai)+o+W*K, piv);
+				}
+				std::copy (piv, piv+W*K, M.rowBegin (1)+o);
+				for (Element e = 2 ; e < p ; ++e)
+					rowAdd (M.rowBegin (e)+o, M.rowBegin (e-1)+o, piv, W);
+
+				const size_t first = reduced ? 0 : r+1;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static) if(m-first >= LINBOX_SLICED_PARALLEL_ROWS)
+#endif
+				for (size_t k = first ; k < m ; ++k) {
+					if (k == r)
+						continue;
+					const Element f = A.getEntry (k, c);
+					if (f)
+						rowAddin (A.rowBegin (k)+o, M.rowBegin (p-f)+o, W);
+				}
+
+				pivots.push_back (c);
+				++r;
+			}
+			if (d)
+				*d = dp;
+			return r;
+		}
+
+		size_t rankInPlace (Matrix &A) const
+		{
+			std::vector<size_t> pivots;
+			return echelonize (A, pivots, false);
+		}
+
+		size_t rank (const Matrix &A) const
+		{
+			Matrix B (A);
+			return rankInPlace (B);
+		}
+
+		//! determinant, in \f$[0,p)\f$, \p A is modified.
+		Element& detInPlace (Element &d, Matrix &A) const
+		{
+			if (A.coldim() != A.rowdim())
+				throw LinboxError("LinBox ERROR: matrix must be square for determinant computation\n");
+			std::vector<size_t> pivots;
+			if (echelonize (A, pivots, false, &d) < A.rowdim ())
+				d = 0;
+			return d;
+		}
+
+		Element& det (Element &d, const Matrix &A) const
+		{
+			Matrix B (A);
+			return detInPlace (d, B);
+		}
+
+		/** A solution \p x to \f$Ax=b\f$, free variables set to zero.
+		 * Entries of \p x and \p b are integers in \f$[0,p)\f$.
+		 * @throws LinboxMathInconsistentSystem if there is none.
+		 */
+		template<class Vector1, class Vector2>
+		Vector1& solve (Vector1 &x, const Matrix &A, const Vector2 &b) const
+		{
+			if (!trySolve (x, A, b))
+				throw LinboxMathInconsistentSystem ("From SlicedPrimeDomain solve.");
+			return x;
+		}
+
+		//! as solve, but \c false, \p x untouched, if there is no solution.
+		template<class Vector1, class Vector2>
+		bool trySolve (Vector1 &x, const Matrix &A, const Vector2 &b) const
+		{
+			linbox_check (x.size () == A.coldim () && b.size () == A.rowdim ());
+			const size_t m = A.rowdim (), n = A.coldim ();
+
+			// reduced echelon form of [A|b], the groups of A are a prefix of those of [A|b]
+			Matrix Ab (m, n+1);
+			for (size_t i = 0 ; i < m ; ++i) {
+				std::copy (A.rowBegin (i), A.rowBegin (i)+A.stride (), Ab.rowBegin (i));
+				Ab.setEntry (i, n, b[i]);
+			}
+			std::vector<size_t> pivots;
+			const size_t r = echelonize (Ab, pivots, true);
+			if (r && pivots[r-1] == n)
+				return false;
+
+			for (size_t j = 0 ; j < n ; ++j)
+				x[j] = 0;
+			for (size_t t = 0 ; t < r ; ++t)
+				x[pivots[t]] = Ab.getEntry (t, n);
+			return true;
+		}
+	};
+
+	namespace Protected {
+
+		//! \p c if it is 3, 5 or 7, else 0.
+		inline size_t slicedPrime (uint64_t c)
+		{
+			return (c == 3 || c == 5 || c == 7) ? (size_t)c : 0;
+		}
+
+		//! whether \p A reaches LINBOX_SLICED_THRESHOLD
+		template<class Matrix>
+		bool slicedSize (const Matrix &A)
+		{
+			return (LINBOX_SLICED_THRESHOLD > 0)
+				&& (std::min (A.rowdim (), A.coldim ()) >= (size_t)LINBOX_SLICED_THRESHOLD);
+		}
+
+		/** \p p if \p A is large enough and \p F is a prime field of
+		 * characteristic \p p handled by SlicedPrimeDomain, else 0.
+		 * Only fields storing the residues in machine words qualify, so that
+		 * SlicedPrime reads the entries in place.
+		 */
+		template<class Field, class Matrix>
+		size_t slicedPrime (const Field &, const Matrix &)
+		{
+			return 0;
+		}
+
+		template<class T1, class T2, class Matrix>
+		typename std::enable_if<std::is_arithmetic<T1>::value, size_t>::type
+		slicedPrime (const Givaro::Modular<T1,T2> &F, const Matrix &A)
+		{
+			return slicedSize (A) ? slicedPrime ((uint64_t)F.characteristic ()) : 0;
+		}
+
+		template<class T, class Matrix>
+		typename std::enable_if<std::is_arithmetic<T>::value, size_t>::type
+		slicedPrime (const Givaro::ModularBalanced<T> &F, const Matrix &A)
+		{
+			return slicedSize (A) ? slicedPrime ((uint64_t)F.characteristic ()) : 0;
+		}
+
+		template<size_t p, class Field, class Matrix>
+		size_t slicedRank (const Field &F, const Matrix &A)
+		{
+			SlicedPrime<p> S (F, A);
+			return SlicedPrimeDomain<p> ().rankInPlace (S);
+		}
+
+		template<size_t p, class Field, class Matrix>
+		typename Field::Element& slicedDet (typename Field::Element &d, const Field &F, const Matrix &A)
+		{
+			SlicedPrime<p> S (F, A);
+			size_t e;
+			SlicedPrimeDomain<p> ().detInPlace (e, S);
+			return F.init (d, (uint64_t)e);
+		}
+
+		template<size_t p, class Field, class Matrix, class Vector1, class Vector2>
+		bool slicedSolve (Vector1 &x, const Field &F, const Matrix &A, const Vector2 &b)
+		{
+			SlicedPrime<p> S (F, A);
+			std::vector<size_t> sx (A.coldim ()), sb (A.rowdim ());
+			for (size_t i = 0 ; i < sb.size () ; ++i)
+				sb[i] = SlicedPrime<p>::residue (b[i]);
+			if (!SlicedPrimeDomain<p> ().trySolve (sx, S, sb))
+				return false;
+			for (size_t j = 0 ; j < sx.size () ; ++j)
+				F.init (x[j], (uint64_t)sx[j]);
+			return true;
+		}
+
+	} // Protected
+
+	/** Rank of a dense matrix by bitsliced elimination, when \p F is
+	 * \f$\mathbf{F}_3\f$, \f$\mathbf{F}_5\f$ or \f$\mathbf{F}_7\f$ and
+	 * \p A is of order at least \c LINBOX_SLICED_THRESHOLD.
+	 * @param A a matrix with \c getPointer and \c getStride
+	 * @return \c false, \p r untouched, otherwise.
+	 */
+	template<class Field, class Matrix>
+	bool slicedRank (size_t &r, const Field &F, const Matrix &A)
+	{
+		switch (Protected::slicedPrime (F, A)) {
+		case 3: r = Protected::slicedRank<3> (F, A); return true;
+		case 5: r = Protected::slicedRank<5> (F, A); return true;
+		case 7: r = Protected::slicedRank<7> (F, A); return true;
+		default: return false;
+		}
+	}
+
+	//! Determinant, as slicedRank.
+	template<class Field, class Matrix>
+	bool slicedDet (typename Field::Element &d, const Field &F, const Matrix &A)
+	{
+		switch (Protected::slicedPrime (F, A)) {
+		case 3: Protected::slicedDet<3> (d, F, A); return true;
+		case 5: Protected::slicedDet<5> (d, F, A); return true;
+		case 7: Protected::slicedDet<7> (d, F, A); return true;
+		default: return false;
+		}
+	}
+
+	/** A solution of \f$Ax=b\f$, as slicedRank.
+	 * @return \c false, \p x untouched, also when the system is
+	 * inconsistent : the caller's own elimination decides what to do.
+	 */
+	template<class Field, class Matrix, class Vector1, class Vector2>
+	bool slicedSolve (Vector1 &x, const Field &F, const Matrix &A, const Vector2 &b)
+	{
+		switch (Protected::slicedPrime (F, A)) {
+		case 3: return Protected::slicedSolve<3> (x, F, A, b);
+		case 5: return Protected::slicedSolve<5> (x, F, A, b);
+		case 7: return Protected::slicedSolve<7> (x, F, A, b);
+		default: return false;
+		}
+	}
+
+} // LinBox
+
+#endif // __LINBOX_matrix_sliced3_sliced_prime_domain_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,287 @@
+/* linbox/matrix/sliced3/sliced-prime.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/*! @file matrix/sliced3/sliced-prime.h
+ * @ingroup matrix
+ * @brief Dense matrices over \f$\mathbf{F}_p\f$, \f$p\f$ a small odd prime,
+ * bitsliced 64 entries per group of words.
+ *
+ * Where \c Sliced packs GF(3) only, with a dedicated two words addition,
+ * \c SlicedPrime<p> holds the binary expansion of the entries on
+ * \f$K = \lceil\log_2 p\rceil\f$ bit planes and adds them with a ripple
+ * carry adder followed by a conditional subtraction of \f$p\f$.
+ * Arithmetic (Four Russians product, elimination) is in
+ * linbox/matrix/sliced3/sliced-prime-domain.h
+ */
+
+#ifndef __LINBOX_matrix_sliced3_sliced_prime_H
+#define __LINBOX_matrix_sliced3_sliced_prime_H
+
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "linbox/util/debug.h"
+
+namespace LinBox
+{
+
+	/** Bitsliced arithmetic on 64 elements of \f$\mathbf{F}_p\f$ at once.
+	 * An element vector is \c K words : bit \c j of word \c i is bit \c i
+	 * of the element at position \c j, in \f$[0,p)\f$.
+	 * Zero positions stay zero, so padding needs no masking.
+	 */
+	template<size_t p>
+	struct SlicedPrimeArith {
+		typedef uint64_t Word;
+
+		//! number of bit planes
+		static const size_t K = (p <= 2) ? 1 : (p <= 4) ? 2 : (p <= 8) ? 3 : (p <= 16) ? 4 : 0;
+
+		//! \f$r \gets x+y\f$, \p r may alias \p x or \p y.
+		static inline void add (Word *r, const Word *x, const Word *y)
+		{
+			Word s[K], d[K], c = 0, br = 0;
+			for (size_t i = 0 ; i < K ; ++i) {
+				const Word u = x[i] ^ y[i];
+				s[i] = u ^ c;
+				c = (x[i] & y[i]) | (u & c);
+			}
+			// d = s - p, and s >= p iff the carry out or no borrow
+			for (size_t i = 0 ; i < K ; ++i) {
+				if ((p >> i) & 1) {
+					d[i] = ~(s[i] ^ br);
+					br = ~s[i] | br;
+				}
+				else {
+					d[i] = s[i] ^ br;
+					br = ~s[i] & br;
+				}
+			}
+			const Word ge = c | ~br;
+			for (size_t i = 0 ; i < K ; ++i)
+				r[i] = s[i] ^ (ge & (d[i] ^ s[i]));
+		}
+
+		//! \f$r \gets -x\f$, that is \f$p-x\f$ where \f$x\neq 0\f$.
+		static inline void neg (Word *r, const Word *x)
+		{
+			Word d[K], nz = 0, br = 0;
+			for (size_t i = 0 ; i < K ; ++i)
+				nz |= x[i];
+			for (size_t i = 0 ; i < K ; ++i) {
+				if ((p >> i) & 1) {
+					d[i] = ~(x[i] ^ br);
+					br = x[i] & br;
+				}
+				else {
+					d[i] = x[i] ^ br;
+					br = x[i] | br;
+				}
+			}
+			for (size_t i = 0 ; i < K ; ++i)
+				r[i] = d[i] & nz;
+		}
+
+		//! \f$r \gets x-y\f$
+		static inline void sub (Word *r, const Word *x, const Word *y)
+		{
+			Word t[K];
+			neg (t, y);
+			add (r, x, t);
+		}
+
+		//! the element at bit position \p b
+		static inline size_t get (const Word *x, size_t b)
+		{
+			size_t v = 0;
+			for (size_t i = 0 ; i < K ; ++i)
+				v |= (size_t)((x[i] >> b) & 1) << i;
+			return v;
+		}
+
+		//! sets the element at bit position \p b to \p v in \f$[0,p)\f$
+		static inline void set (Word *x, size_t b, size_t v)
+		{
+			const Word m = (Word)1 << b;
+			for (size_t i = 0 ; i < K ; ++i)
+				x[i] = ((v >> i) & 1) ? (x[i] | m) : (x[i] & ~m);
+		}
+	};
+
+	/** Dense matrix over \f$\mathbf{F}_p\f$, \f$p < 16\f$, bitsliced by rows.
+	 *
+	 * Row \c i is rowGroups() groups of \c K words, group \c g holding the
+	 * columns \f$64g\f$ to \f$64g+63\f$, see SlicedPrimeArith.
+	 * Entries are the integers in \f$[0,p)\f$.
+	 */
+	template<size_t p>
+	class SlicedPrime {
+	public:
+		typedef SlicedPrimeArith<p>        Arith;
+		typedef typename Arith::Word       Word;
+		typedef size_t                     Element;
+		typedef SlicedPrime<p>             Self_t;
+
+		static const size_t K        = Arith::K ;
+		static const size_t WordBits = 64 ; //!< entries per group
+
+		//! zero \p m x \p n matrix
+		SlicedPrime (size_t m = 0, size_t n = 0)
+		{
+			init(m,n);
+		}
+
+		/** packs a dense matrix over a field of characteristic \p p.
+		 * The entries are read in place and must be machine integers or
+		 * floating point numbers congruent to their residue, as those of
+		 * Givaro::Modular and Givaro::ModularBalanced.
+		 * @param F the field of \p A
+		 * @param A any matrix with \c getPointer and \c getStride
+		 */
+		template<class Field, class Matrix>
+		SlicedPrime (const Field &/* F */, const Matrix &A)
+		{
+			init(A.rowdim(), A.coldim());
+			const size_t ld = A.getStride();
+			for (size_t i = 0 ; i < _row ; ++i) {
+				const auto *a = A.getPointer() + i*ld;
+				Word *r = rowBegin(i);
+				for (size_t j = 0 ; j < _col ; j += WordBits, r += K) {
+					const size_t e = std::min(_col-j, (size_t)WordBits);
+					for (size_t b = 0 ; b < e ; ++b) {
+						const Word v = residue(a[j+b]);
+						for (size_t k = 0 ; k < K ; ++k)
+							r[k] |= ((v >> k) & 1) << b;
+					}
+				}
+			}
+		}
+
+		//! \p x modulo \p p in \f$[0,p)\f$, \p x a machine number.
+		template<class T>
+		static size_t residue (const T &x)
+		{
+			const int64_t v = (int64_t)x % (int64_t)p;
+			return (size_t)(v < 0 ? v + (int64_t)p : v);
+		}
+
+		//! resizes to a zero \p m x \p n matrix.
+		void resize (size_t m, size_t n)
+		{
+			init(m,n);
+		}
+
+		size_t rowdim () const { return _row; }
+		size_t coldim () const { return _col; }
+		//! number of groups of \c K words per row
+		size_t rowGroups () const { return _groups; }
+		//! number of words per row
+		size_t stride () const { return _groups*K; }
+
+		Word* rowBegin (size_t i) { return _rep.data() + i*stride(); }
+		const Word* rowBegin (size_t i) const { return _rep.data() + i*stride(); }
+
+		Element getEntry (size_t i, size_t j) const
+		{
+			linbox_check(i < _row && j < _col);
+			return Arith::get(rowBegin(i) + (j/WordBits)*K, j%WordBits);
+		}
+
+		Element& getEntry (Element &x, size_t i, size_t j) const
+		{
+			return x = getEntry(i,j);
+		}
+
+		//! \p x is reduced modulo \p p
+		void setEntry (size_t i, size_t j, const Element &x)
+		{
+			linbox_check(i < _row && j < _col);
+			Arith::set(rowBegin(i) + (j/WordBits)*K, j%WordBits, x % p);
+		}
+
+		void zero ()
+		{
+			std::fill(_rep.begin(), _rep.end(), (Word)0);
+		}
+
+		void swapRows (size_t i, size_t k)
+		{
+			if (i != k)
+				std::swap_ranges(rowBegin(i), rowBegin(i)+stride(), rowBegin(k));
+		}
+
+		bool operator== (const SlicedPrime &A) const
+		{
+			return (_row == A._row) && (_col == A._col) && (_rep == A._rep);
+		}
+
+		bool operator!= (const SlicedPrime &A) const
+		{
+			return !(*this == A);
+		}
+
+		std::ostream& write (std::ostream &os) const
+		{
+			for (size_t i = 0 ; i < _row ; ++i) {
+				for (size_t j = 0 ; j < _col ; ++j)
+					os << getEntry(i,j) << ' ';
+				os << std::endl;
+			}
+			return os;
+		}
+
+	protected:
+
+		void init (size_t m, size_t n)
+		{
+			_row = m;
+			_col = n;
+			_groups = (n+WordBits-1)/WordBits;
+			_rep.assign(_row*_groups*K, 0);
+		}
+
+		size_t              _row;
+		size_t              _col;
+		size_t              _groups;
+		std::vector<Word>   _rep;
+	};
+
+	template<size_t p>
+	inline std::ostream& operator<< (std::ostream &os, const SlicedPrime<p> &A)
+	{
+		return A.write(os);
+	}
+
+} // LinBox
+
+#endif // __LINBOX_matrix_sliced3_sliced_prime_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -64,6 +64,7 @@ namespace LinBox {
 		class TPL_omp     : public ANY {} ; //!< triplesbb for openmp
 		class LIL         : public ANY {} ; //!< vector of pairs
 		class SMM         : public ANY {} ; //!< Sparse Map of Maps
+		class Auto        : public ANY {} ; //!< CSR, ELL_R or COO, chosen by timing apply
 
 		// the old sparse matrix reps.
 		// class VVP : public ANY {} ; // vector of vector of pairs
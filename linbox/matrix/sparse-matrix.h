@@ -76,9 +76,10 @@ namespace LinBox {
 #include "linbox/matrix/sparsematrix/sparse-ell-matrix.h"
 #include "linbox/matrix/sparsematrix/sparse-ellr-matrix.h"
 // #include "linbox/matrix/sparsematrix/sparse-ellr-1-matrix.h"
-// #include "linbox/matrix/sparsematrix/sparse-bcsr-matrix.h"
-// #include "linbox/matrix/sparsematrix/sparse-dia-matrix.h"
+#include "linbox/matrix/sparsematrix/sparse-bcsr-matrix.h"
+#include "linbox/matrix/sparsematrix/sparse-dia-matrix.h"
 // #include "linbox/matrix/sparsematrix/sparse-hyb-matrix.h"
+#include "linbox/matrix/sparsematrix/sparse-auto-matrix.h"
 #include "linbox/matrix/sparsematrix/sparse-map-map-matrix.h"
 
 #include "linbox/matrix/sparsematrix/sparse-tpl-matrix.h"
@@ -0,0 +1,482 @@
+/* linbox/matrix/sparsematrix/sparse-auto-matrix.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-auto-matrix.h
+ * @ingroup sparsematrix
+ * @brief Sparse matrix choosing its storage (CSR, ELL_R or COO) by timing apply.
+ *
+ * The matrix is always stored in CSR. When it is finalized, row length
+ * statistics discard the formats that cannot win (ELL_R when padding would
+ * be too large), then each remaining candidate is built and \c apply is
+ * timed a few times. The fastest one is kept and used by \c apply,
+ * \c applyTranspose, \c applyLeft and \c applyRight.
+ *
+ * The choice is remembered in a process wide cache keyed by a fingerprint
+ * of the matrix (dimensions, sparsity pattern, field type and
+ * characteristic). If the environment variable \c LINBOX_TUNING_CACHE names
+ * a file, decisions are read from and appended to it, so that later runs skip
+ * the probing.
+ */
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_auto_matrix_H
+#define __LINBOX_matrix_sparsematrix_sparse_auto_matrix_H
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/timer.h"
+#include "linbox/vector/blas-vector.h"
+#include "linbox/blackbox/blockbb.h"
+#include "sparse-domain.h"
+#include "sparse-coo-matrix.h"
+#include "sparse-csr-matrix.h"
+#include "sparse-ellr-matrix.h"
+
+//! number of non zero entries under which CSR is chosen without timing.
+#ifndef LINBOX_AUTO_PROBE_THRESHOLD
+#define LINBOX_AUTO_PROBE_THRESHOLD 10000
+#endif
+
+//! number of timed applies per candidate format.
+#ifndef LINBOX_AUTO_PROBE_TRIALS
+#define LINBOX_AUTO_PROBE_TRIALS 3
+#endif
+
+//! ELL_R is a candidate only if rowdim*maxrow <= LINBOX_AUTO_ELL_FILL * nnz.
+#ifndef LINBOX_AUTO_ELL_FILL
+#define LINBOX_AUTO_ELL_FILL 1.5
+#endif
+
+namespace LinBox {
+
+	namespace Protected {
+
+		//! Formats \c SparseMatrix<Field,SparseMatrixFormat::Auto> chooses from.
+		enum class AutoSparseChoice : int { CSR = 0, ELL_R = 1, COO = 2 } ;
+
+		/*! Tuning decisions, keyed by matrix fingerprint.
+		 * Shared by all fields : the fingerprint includes the field type
+		 * and characteristic.
+		 */
+		class SparseTuningCache {
+		public:
+			static bool find(uint64_t key, AutoSparseChoice & c)
+			{
+				std::lock_guard<std::mutex> lock(mutex());
+				load();
+				std::map<uint64_t,int>::const_iterator it = table().find(key);
+				if (it == table().end())
+					return false ;
+				c = (AutoSparseChoice) it->second ;
+				return true ;
+			}
+
+			static void insert(uint64_t key, AutoSparseChoice c)
+			{
+				std::lock_guard<std::mutex> lock(mutex());
+				load();
+				table()[key] = (int) c ;
+				const char * file = std::getenv("LINBOX_TUNING_CACHE");
+				if (file != NULL) {
+					std::ofstream out(file, std::ios::app);
+					if (out)
+						out << std::hex << key << std::dec << ' ' << (int)c << std::endl;
+				}
+			}
+
+		private:
+			static std::map<uint64_t,int> & table()
+			{
+				static std::map<uint64_t,int> t ;
+				return t ;
+			}
+
+			static std::mutex & mutex()
+			{
+				static std::mutex m ;
+				return m ;
+			}
+
+			// reads LINBOX_TUNING_CACHE once ; malformed lines are ignored.
+			static void load()
+			{
+				static bool loaded = false ;
+				if (loaded)
+					return ;
+				loaded = true ;
+				const char * file = std::getenv("LINBOX_TUNING_CACHE");
+				if (file == NULL)
+					return ;
+				std::ifstream in(file);
+				uint64_t key ;
+				int c ;
+				while (in >> std::hex >> key >> std::dec >> c)
+					if (c >= 0 && c <= 2)
+						table()[key] = c ;
+			}
+		};
+
+	} // Protected
+
+	/** Sparse matrix, storage chosen at run time.
+	 *
+	 * Built like the other formats (from a matrix, a stream, or with
+	 * \c setEntry followed by \c finalize). The format is chosen in
+	 * \c finalize().
+	 *
+	 * \ingroup matrix
+	 * \ingroup sparse
+	 */
+	template<class _Field>
+	class SparseMatrix<_Field, SparseMatrixFormat::Auto > {
+	public :
+		typedef _Field                             Field ; //!< Field
+		typedef typename _Field::Element         Element ; //!< Element
+		typedef const Element               constElement ; //!< const Element
+		typedef SparseMatrixFormat::Auto         Storage ; //!< Matrix Storage Format
+		typedef SparseMatrix<_Field,Storage>      Self_t ; //!< Self type
+		typedef typename Vector<Field>::SparseSeq    Row ; //!< @warning this is not the row type. Just used for streams.
+		typedef Protected::AutoSparseChoice       Choice ;
+
+		typedef SparseMatrix<_Field,SparseMatrixFormat::CSR>   Csr_t ;
+		typedef SparseMatrix<_Field,SparseMatrixFormat::ELL_R> Ellr_t ;
+		typedef SparseMatrix<_Field,SparseMatrixFormat::COO>   Coo_t ;
+
+		/*! Constructors.
+		 */
+		//@{
+		SparseMatrix<_Field, SparseMatrixFormat::Auto> (const _Field & F) :
+			_csr(new Csr_t(F)), _ellr(), _coo(), _choice(Choice::CSR)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::Auto> (const _Field & F, size_t m, size_t n) :
+			_csr(new Csr_t(F,m,n)), _ellr(), _coo(), _choice(Choice::CSR)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::Auto> (const SparseMatrix<_Field, SparseMatrixFormat::Auto> & S) :
+			_csr(new Csr_t(*S._csr)), _ellr(), _coo(), _choice(Choice::CSR)
+		{
+			build(S._choice);
+		}
+
+		template<typename _Tp1, typename _Rw1>
+		SparseMatrix (const SparseMatrix<_Tp1, _Rw1> &S, const Field& F) :
+			_csr(new Csr_t(S,F)), _ellr(), _coo(), _choice(Choice::CSR)
+		{
+			select();
+		}
+
+		SparseMatrix<_Field, SparseMatrixFormat::Auto> ( MatrixStream<Field>& ms ) :
+			_csr(new Csr_t(ms)), _ellr(), _coo(), _choice(Choice::CSR)
+		{
+			select();
+		}
+
+		//! copy and swap: the candidates of S are rebuilt, not shared.
+		Self_t & operator= (const Self_t & S)
+		{
+			Self_t T(S);
+			swap(T);
+			return *this;
+		}
+
+		void swap(Self_t & S)
+		{
+			std::swap(_csr,S._csr);
+			std::swap(_ellr,S._ellr);
+			std::swap(_coo,S._coo);
+			std::swap(_choice,S._choice);
+		}
+		//@}
+
+		template<typename _Tp1, typename _Rw1 = SparseMatrixFormat::Auto>
+		struct rebind {
+			typedef SparseMatrix<_Tp1, _Rw1> other;
+
+			// conversions go through the CSR representation.
+			template<class _Rw>
+			void operator() (SparseMatrix<_Tp1,_Rw> & Ap, const Self_t & A)
+			{
+				typename Csr_t::template rebind<_Tp1,_Rw>()(Ap, A.csr());
+			}
+		};
+
+		size_t rowdim() const { return _csr->rowdim(); }
+
+		size_t coldim() const { return _csr->coldim(); }
+
+		size_t size() const { return _csr->size(); }
+
+		const Field & field()  const { return _csr->field() ; }
+
+		void resize(const size_t & m, const size_t & n, const size_t & z = 0)
+		{
+			clearCandidates();
+			_csr->resize(m,n,z);
+		}
+
+		const Element& setEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			clearCandidates();
+			return _csr->setEntry(i,j,e);
+		}
+
+		void appendEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			clearCandidates();
+			_csr->appendEntry(i,(index_t)j,e);
+		}
+
+		constElement & getEntry(const size_t &i, const size_t &j) const
+		{
+			return _csr->getEntry(i,j);
+		}
+
+		Element & getEntry(Element &x, size_t i, size_t j) const
+		{
+			return _csr->getEntry(x,i,j);
+		}
+
+		//! make matrix ready to use after a sequence of setEntry calls, and choose the format.
+		void finalize()
+		{
+			_csr->finalize();
+			select();
+		}
+
+		//! The format in use.
+		Choice choice() const { return _choice ; }
+
+		//! The reference representation, always available.
+		const Csr_t & csr() const { return *_csr ; }
+
+		void firstTriple() const { _csr->firstTriple(); }
+
+		bool nextTriple(size_t & i, size_t &j, Element &e) const
+		{
+			return _csr->nextTriple(i,j,e);
+		}
+
+		std::ostream & write(std::ostream &os
+				     , Tag::FileFormat format  = Tag::FileFormat::MatrixMarket) const
+		{
+			return _csr->write(os,format);
+		}
+
+		std::istream& read (std::istream &is
+				    , Tag::FileFormat format = Tag::FileFormat::Detect)
+		{
+			clearCandidates();
+			_csr->read(is,format);
+			select();
+			return is;
+		}
+
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x ) const
+		{
+			switch (_choice) {
+			case Choice::ELL_R : return _ellr->apply(y,x);
+			case Choice::COO   : return _coo ->apply(y,x);
+			default            : return _csr ->apply(y,x);
+			}
+		}
+
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x ) const
+		{
+			switch (_choice) {
+			case Choice::ELL_R : return _ellr->applyTranspose(y,x);
+			case Choice::COO   : return _coo ->applyTranspose(y,x);
+			default            : return _csr ->applyTranspose(y,x);
+			}
+		}
+
+		//! Y <- AX (COO has no block kernel, CSR is used instead).
+		template<class Mat1, class Mat2>
+		Mat1 & applyLeft(Mat1 &Y, const Mat2 &X) const
+		{
+			if (_choice == Choice::ELL_R)
+				return _ellr->applyLeft(Y,X);
+			return _csr->applyLeft(Y,X);
+		}
+
+		//! Y <- XA
+		template<class Mat1, class Mat2>
+		Mat1 & applyRight(Mat1 &Y, const Mat2 &X) const
+		{
+			if (_choice == Choice::ELL_R)
+				return _ellr->applyRight(Y,X);
+			return _csr->applyRight(Y,X);
+		}
+
+		/*! Fingerprint of the matrix.
+		 * FNV-1a hash of the dimensions, of the row pointers, of (a sample of)
+		 * the column indices, of the field type and of its characteristic
+		 * (the timings depend on the size of the modulus).
+		 */
+		uint64_t fingerprint() const
+		{
+			uint64_t h = UINT64_C(14695981039346656037) ;
+			hashIn(h, rowdim());
+			hashIn(h, coldim());
+			hashIn(h, size());
+			const std::string name(typeid(Field).name());
+			for (size_t k = 0 ; k < name.size() ; ++k)
+				hashIn(h, (uint64_t)(unsigned char)name[k]);
+			integer c;
+			field().characteristic(c);
+			for (const integer two64 = integer(1) << 64 ; c > 0 ; c /= two64)
+				hashIn(h, (uint64_t)(c % two64));
+			const size_t rstep = std::max((size_t)1, rowdim()/4096);
+			for (size_t i = 0 ; i <= rowdim() ; i += rstep)
+				hashIn(h, (uint64_t)(i < rowdim() ? _csr->getStart(i) : _csr->size()));
+			const size_t cstep = std::max((size_t)1, size()/4096);
+			for (size_t k = 0 ; k < size() ; k += cstep)
+				hashIn(h, (uint64_t)_csr->getColid(k));
+			return h ;
+		}
+
+	private :
+
+		static void hashIn(uint64_t & h, uint64_t v)
+		{
+			for (size_t b = 0 ; b < 8 ; ++b) {
+				h ^= (v >> (8*b)) & 0xff ;
+				h *= UINT64_C(1099511628211) ;
+			}
+		}
+
+		void clearCandidates()
+		{
+			_ellr.reset();
+			_coo.reset();
+			_choice = Choice::CSR ;
+		}
+
+		// builds the representation for c (CSR is always there).
+		void build(Choice c)
+		{
+			if (c == Choice::ELL_R && !_ellr)
+				_ellr.reset(new Ellr_t(*_csr, field()));
+			if (c == Choice::COO && !_coo)
+				_coo.reset(new Coo_t(*_csr, field()));
+			_choice = c ;
+		}
+
+		// ELL_R pads every row to the longest one.
+		bool ellrCandidate() const
+		{
+			if (rowdim() == 0)
+				return false ;
+			return (double)rowdim()*(double)_csr->maxrow() <= LINBOX_AUTO_ELL_FILL*(double)size() ;
+		}
+
+		// best of LINBOX_AUTO_PROBE_TRIALS applies.
+		template<class Matrix>
+		double probe(const Matrix & A, BlasVector<Field> & y, const BlasVector<Field> & x) const
+		{
+			double best = -1 ;
+			Timer chrono ;
+			for (size_t t = 0 ; t < LINBOX_AUTO_PROBE_TRIALS ; ++t) {
+				chrono.clear();
+				chrono.start();
+				A.apply(y,x);
+				chrono.stop();
+				if (best < 0 || chrono.realtime() < best)
+					best = chrono.realtime() ;
+			}
+			return best ;
+		}
+
+		void select()
+		{
+			clearCandidates();
+			if (size() < LINBOX_AUTO_PROBE_THRESHOLD)
+				return ;
+
+			const uint64_t key = fingerprint();
+			Choice c ;
+			if (Protected::SparseTuningCache::find(key,c)) {
+				build(c);
+				return ;
+			}
+
+			BlasVector<Field> x(field(),coldim()), y(field(),rowdim());
+			for (size_t j = 0 ; j < coldim() ; ++j)
+				field().init(x[j], (int64_t)(j % 251) + 1);
+
+			c = Choice::CSR ;
+			double best = probe(*_csr,y,x);
+
+			if (ellrCandidate()) {
+				build(Choice::ELL_R);
+				double t = probe(*_ellr,y,x);
+				if (t < best) { best = t ; c = Choice::ELL_R ; }
+			}
+
+			build(Choice::COO);
+			{
+				double t = probe(*_coo,y,x);
+				if (t < best) { best = t ; c = Choice::COO ; }
+			}
+
+			// only keep the winner
+			if (c != Choice::ELL_R) _ellr.reset();
+			if (c != Choice::COO)   _coo.reset();
+			_choice = c ;
+
+			Protected::SparseTuningCache::insert(key,c);
+		}
+
+		// CSR is held by pointer too, its field reference making it non assignable
+		std::unique_ptr<Csr_t>  _csr ;
+		std::unique_ptr<Ellr_t> _ellr ;
+		std::unique_ptr<Coo_t>  _coo ;
+		Choice   _choice ;
+	};
+
+	template<class Field>
+	struct is_blockbb<SparseMatrix<Field,SparseMatrixFormat::Auto> > {
+		static const bool value = true;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_auto_matrix_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,635 @@
+/* linbox/matrix/sparsematrix/sparse-bcsr-matrix.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-bcsr-matrix.h
+ * @ingroup sparsematrix
+ * @brief Block CSR sparse matrix : CSR of dense \f$r\times c\f$ blocks.
+ *
+ * Only one column index is stored per block, and the products inside a
+ * block run over fixed size loops that the compiler unrolls and vectorises
+ * for the usual block sizes (2x2, 3x3, 4x4, 8x8).
+ * Word size floating point fields use the delayed reduction of
+ * \c DelayedSparseKernel.
+ */
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_bcsr_matrix_H
+#define __LINBOX_matrix_sparsematrix_sparse_bcsr_matrix_H
+
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/field/hom.h"
+#include "sparse-domain.h"
+#include "sparse-delayed-kernels.h"
+#include "sparse-csr-matrix.h"
+
+//! default number of rows of a block.
+#ifndef LINBOX_BCSR_ROWS
+#define LINBOX_BCSR_ROWS 4
+#endif
+
+//! default number of columns of a block.
+#ifndef LINBOX_BCSR_COLS
+#define LINBOX_BCSR_COLS 4
+#endif
+
+namespace LinBox {
+
+	/** Sparse matrix, Block CSR storage.
+	 *
+	 * Block row \c I holds rows <code>I*r..I*r+r-1</code>. Its blocks are
+	 * <code>_start[I].._start[I+1]-1</code>, sorted by block column;
+	 * block \c b covers columns <code>_bcolid[b]*c..</code> and is stored row
+	 * major in <code>_data[b*r*c..]</code>. Missing entries of a block are zeros.
+	 *
+	 * \ingroup matrix
+	 * \ingroup sparse
+	 */
+	template<class _Field>
+	class SparseMatrix<_Field, SparseMatrixFormat::BCSR > {
+	private :
+		typedef std::vector<index_t> svector_t ;
+	public :
+		typedef _Field                             Field ; //!< Field
+		typedef typename _Field::Element         Element ; //!< Element
+		typedef const Element               constElement ; //!< const Element
+		typedef SparseMatrixFormat::BCSR         Storage ; //!< Matrix Storage Format
+		typedef SparseMatrix<_Field,Storage>      Self_t ; //!< Self type
+		typedef typename Vector<Field>::SparseSeq    Row ; //!< @warning this is not the row type. Just used for streams.
+		typedef SparseMatrix<_Field,SparseMatrixFormat::CSR> Csr_t ;
+
+		/*! Constructors.
+		 * @param r number of rows of a block
+		 * @param c number of columns of a block
+		 */
+		//@{
+		SparseMatrix<_Field, SparseMatrixFormat::BCSR> (const _Field & F) :
+			_rownb(0),_colnb(0),_nbnz(0)
+			,_br(LINBOX_BCSR_ROWS),_bc(LINBOX_BCSR_COLS)
+			,_start(1,0),_bcolid(0),_data(0)
+			,_field(F)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::BCSR> (const _Field & F, size_t m, size_t n,
+								size_t r = LINBOX_BCSR_ROWS, size_t c = LINBOX_BCSR_COLS) :
+			_rownb(m),_colnb(n),_nbnz(0)
+			,_br(r),_bc(c)
+			,_start(blockRows()+1,0),_bcolid(0),_data(0)
+			,_field(F)
+		{
+			linbox_check(r > 0 && c > 0);
+		}
+
+		SparseMatrix<_Field, SparseMatrixFormat::BCSR> (const SparseMatrix<_Field, SparseMatrixFormat::BCSR> & S) :
+			_rownb(S._rownb),_colnb(S._colnb),_nbnz(S._nbnz)
+			,_br(S._br),_bc(S._bc)
+			,_start(S._start),_bcolid(S._bcolid),_data(S._data)
+			,_pending(S._pending)
+			,_field(S._field)
+		{}
+
+		//! Conversion from CSR.
+		SparseMatrix<_Field, SparseMatrixFormat::BCSR> (const Csr_t & S,
+								size_t r = LINBOX_BCSR_ROWS, size_t c = LINBOX_BCSR_COLS) :
+			_rownb(S.rowdim()),_colnb(S.coldim()),_nbnz(0)
+			,_br(r),_bc(c)
+			,_field(S.field())
+		{
+			linbox_check(r > 0 && c > 0);
+			importe(S);
+		}
+
+		//! Conversion from any format (and field), through CSR.
+		template<typename _Tp1, typename _Rw1>
+		SparseMatrix (const SparseMatrix<_Tp1, _Rw1> &S, const Field& F,
+			      size_t r = LINBOX_BCSR_ROWS, size_t c = LINBOX_BCSR_COLS) :
+			_rownb(S.rowdim()),_colnb(S.coldim()),_nbnz(0)
+			,_br(r),_bc(c)
+			,_field(F)
+		{
+			linbox_check(r > 0 && c > 0);
+			Csr_t T(S,F);
+			importe(T);
+		}
+
+		//! Reads MatrixMarket, SMS,... (anything \c MatrixStream knows).
+		SparseMatrix<_Field, SparseMatrixFormat::BCSR> ( MatrixStream<Field>& ms,
+								 size_t r = LINBOX_BCSR_ROWS, size_t c = LINBOX_BCSR_COLS) :
+			_rownb(0),_colnb(0),_nbnz(0)
+			,_br(r),_bc(c)
+			,_field(ms.field())
+		{
+			linbox_check(r > 0 && c > 0);
+			Csr_t T(ms);
+			importe(T);
+		}
+		//@}
+
+		template<typename _Tp1, typename _Rw1 = SparseMatrixFormat::BCSR>
+		struct rebind {
+			typedef SparseMatrix<_Tp1, _Rw1> other;
+
+			template<class _Rw>
+			void operator() (SparseMatrix<_Tp1,_Rw> & Ap, const Self_t & A)
+			{
+				typename _Tp1::Element e;
+				Hom<typename Self_t::Field, _Tp1> hom(A.field(), Ap.field());
+				Ap.resize(A.rowdim(), A.coldim(), 0);
+				size_t i, j ;
+				Element f ;
+				A.firstTriple();
+				while ( A.nextTriple(i,j,f) ) {
+					hom. image ( e, f) ;
+					if (! Ap.field().isZero(e) )
+						Ap.appendEntry(i,j,e);
+				}
+				A.firstTriple();
+				Ap.finalize();
+			}
+		};
+
+		/*! Build from a CSR matrix (block sizes are kept).
+		 */
+		void importe(const Csr_t & S)
+		{
+			_rownb = S.rowdim();
+			_colnb = S.coldim();
+			_nbnz  = 0 ;
+			_pending.clear();
+			const size_t nbr = blockRows();
+			const size_t bs  = _br*_bc ;
+			_start.assign(nbr+1,0);
+			_bcolid.clear();
+			_data.clear();
+
+			const index_t none = (index_t)-1 ;
+			svector_t slot(blockCols(), none);
+			for (size_t I = 0 ; I < nbr ; ++I) {
+				const size_t first = _bcolid.size();
+				const size_t iend = std::min(_rownb, (I+1)*_br);
+				for (size_t i = I*_br ; i < iend ; ++i) {
+					for (index_t k = S.getStart(i) ; k < S.getEnd(i) ; ++k) {
+						if (field().isZero(S.getData(k)))
+							continue ;
+						const size_t j = S.getColid(k);
+						const size_t J = j / _bc ;
+						if (slot[J] == none) {
+							slot[J] = (index_t)_bcolid.size();
+							_bcolid.push_back((index_t)J);
+							_data.resize(_data.size()+bs, field().zero);
+						}
+						field().assign(_data[slot[J]*bs + (i-I*_br)*_bc + j%_bc], S.getData(k));
+						++_nbnz ;
+					}
+				}
+				sortBlockRow(first, _bcolid.size());
+				for (size_t b = first ; b < _bcolid.size() ; ++b)
+					slot[_bcolid[b]] = none ;
+				_start[I+1] = (index_t)_bcolid.size();
+			}
+		}
+
+		size_t rowdim() const { return _rownb ; }
+
+		size_t coldim() const { return _colnb ; }
+
+		//! number of (non zero) entries, padding not included.
+		size_t size() const { return _nbnz ; }
+
+		//! number of stored blocks.
+		size_t blocks() const { return _bcolid.size() ; }
+
+		size_t blockRowdim() const { return _br ; }
+
+		size_t blockColdim() const { return _bc ; }
+
+		const Field & field()  const { return _field ; }
+
+		void resize(const size_t & m, const size_t & n, const size_t & = 0)
+		{
+			_rownb = m ;
+			_colnb = n ;
+			_nbnz = 0 ;
+			_start.assign(blockRows()+1,0);
+			_bcolid.clear();
+			_data.clear();
+			_pending.clear();
+		}
+
+		constElement & getEntry(const size_t &i, const size_t &j) const
+		{
+			linbox_check(i < _rownb);
+			linbox_check(j < _colnb);
+			for (size_t t = _pending.size() ; t > 0 ; --t)
+				if (_pending[t-1].first.first == i && _pending[t-1].first.second == j)
+					return _pending[t-1].second ;
+			ptrdiff_t b = findBlock(i/_br, j/_bc);
+			if (b < 0)
+				return field().zero ;
+			return _data[(size_t)b*_br*_bc + (i%_br)*_bc + j%_bc] ;
+		}
+
+		Element &getEntry (Element &x, size_t i, size_t j) const
+		{
+			return x = getEntry (i, j);
+		}
+
+		/** Set an individual entry.
+		 * Entries in an existing block are set in place, others are
+		 * inserted by the next call to \c finalize().
+		 */
+		const Element& setEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			linbox_check(i < _rownb);
+			linbox_check(j < _colnb);
+			ptrdiff_t b = findBlock(i/_br, j/_bc);
+			if (b >= 0) {
+				Element & a = _data[(size_t)b*_br*_bc + (i%_br)*_bc + j%_bc] ;
+				if (field().isZero(a) && !field().isZero(e)) ++_nbnz ;
+				if (!field().isZero(a) && field().isZero(e)) --_nbnz ;
+				field().assign(a,e);
+				return e ;
+			}
+			if (!field().isZero(e) || !_pending.empty())
+				_pending.push_back(std::make_pair(std::make_pair(i,j),e));
+			return e ;
+		}
+
+		void appendEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			setEntry(i,j,e);
+		}
+
+		/// make matrix ready to use after a sequence of setEntry calls.
+		void finalize()
+		{
+			if (_pending.empty())
+				return ;
+			// later setEntry win
+			std::vector<std::pair<std::pair<size_t,size_t>,Element> > all ;
+			size_t i, j ;
+			Element e ;
+			std::vector<std::pair<std::pair<size_t,size_t>,Element> > pend ;
+			pend.swap(_pending);
+			firstTriple();
+			while (nextTriple(i,j,e))
+				all.push_back(std::make_pair(std::make_pair(i,j),e));
+			for (size_t t = 0 ; t < pend.size() ; ++t)
+				all.push_back(pend[t]);
+			std::stable_sort(all.begin(), all.end(), lessPosition);
+
+			Csr_t T(field(), _rownb, _colnb);
+			for (size_t t = 0 ; t < all.size() ; ++t) {
+				if (t+1 < all.size() && all[t].first == all[t+1].first)
+					continue ;
+				if (!field().isZero(all[t].second))
+					T.appendEntry(all[t].first.first, (index_t)all[t].first.second, all[t].second);
+			}
+			T.finalize();
+			importe(T);
+		}
+
+		void firstTriple() const
+		{
+			_triples.reset();
+		}
+
+		//! Triples in row major order, zeros of the blocks skipped.
+		bool nextTriple(size_t & i, size_t &j, Element &e) const
+		{
+			linbox_check(_pending.empty());
+			_triples_t & t = _triples ;
+			if (t._row == (size_t)-1) {
+				t._row = 0 ;
+				t._blk = _start[0] ;
+				t._l = 0 ;
+			}
+			else
+				++t._l ;
+			const size_t bs = _br*_bc ;
+			while (t._row < _rownb) {
+				const size_t I = t._row / _br ;
+				const size_t k = t._row % _br ;
+				for ( ; t._blk < (size_t)_start[I+1] ; ++t._blk, t._l = 0)
+					for ( ; t._l < _bc ; ++t._l) {
+						const Element & a = _data[t._blk*bs + k*_bc + t._l] ;
+						if (!field().isZero(a)) {
+							i = t._row ;
+							j = (size_t)_bcolid[t._blk]*_bc + t._l ;
+							e = a ;
+							return true ;
+						}
+					}
+				++t._row ;
+				t._blk = _start[t._row / _br] ;
+				t._l = 0 ;
+			}
+			t.reset();
+			return false ;
+		}
+
+		std::ostream & write(std::ostream &os
+				     , Tag::FileFormat format  = Tag::FileFormat::MatrixMarket) const
+		{
+			return toCSR().write(os,format);
+		}
+
+		std::istream& read (std::istream &is
+				    , Tag::FileFormat format = Tag::FileFormat::Detect)
+		{
+			Csr_t T(field());
+			T.read(is,format);
+			importe(T);
+			return is ;
+		}
+
+		// y= Ax
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x, const Element & a ) const
+		{
+			linbox_check(_pending.empty());
+			prepare(field(),y,a);
+			std::vector<Element> xs(blockCols()*_bc, field().zero) ;
+			std::vector<Element> ys(blockRows()*_br, field().zero) ;
+			for (size_t j = 0 ; j < _colnb ; ++j)
+				field().assign(xs[j], x[j]);
+
+			switch (_br*16+_bc) {
+			case 2*16+2 : applyBlocks<2,2>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 3*16+3 : applyBlocks<3,3>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 4*16+4 : applyBlocks<4,4>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 8*16+8 : applyBlocks<8,8>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			default     : applyBlocks<0,0>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			}
+
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				field().assign(y[i], ys[i]);
+			return y;
+		}
+
+		// y= A^t x
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a ) const
+		{
+			linbox_check(_pending.empty());
+			prepare(field(),y,a);
+			std::vector<Element> xs(blockRows()*_br, field().zero) ;
+			std::vector<Element> ys(blockCols()*_bc, field().zero) ;
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				field().assign(xs[i], x[i]);
+
+			switch (_br*16+_bc) {
+			case 2*16+2 : applyTransposeBlocks<2,2>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 3*16+3 : applyTransposeBlocks<3,3>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 4*16+4 : applyTransposeBlocks<4,4>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			case 8*16+8 : applyTransposeBlocks<8,8>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			default     : applyTransposeBlocks<0,0>(ys.data(), xs.data(), DelayedSparseKernel<Field>()); break;
+			}
+
+			for (size_t j = 0 ; j < _colnb ; ++j)
+				field().assign(y[j], ys[j]);
+			return y;
+		}
+
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x ) const
+		{
+			return apply(y,x,field().zero);
+		}
+
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x ) const
+		{
+			return applyTranspose(y,x,field().zero);
+		}
+
+		//! CSR copy of this matrix.
+		Csr_t toCSR() const
+		{
+			return Csr_t(*this, field());
+		}
+
+	private :
+
+		size_t blockRows() const { return (_rownb + _br - 1)/_br ; }
+
+		size_t blockCols() const { return (_colnb + _bc - 1)/_bc ; }
+
+		static bool lessPosition(const std::pair<std::pair<size_t,size_t>,Element> & u,
+					 const std::pair<std::pair<size_t,size_t>,Element> & v)
+		{
+			return u.first < v.first ;
+		}
+
+		// index of block (I,J) or -1.
+		ptrdiff_t findBlock(size_t I, size_t J) const
+		{
+			if (I+1 >= _start.size())
+				return -1 ;
+			svector_t::const_iterator beg = _bcolid.begin() + (ptrdiff_t)_start[I] ;
+			svector_t::const_iterator end = _bcolid.begin() + (ptrdiff_t)_start[I+1] ;
+			svector_t::const_iterator it = std::lower_bound(beg, end, (index_t)J);
+			if (it == end || *it != (index_t)J)
+				return -1 ;
+			return it - _bcolid.begin() ;
+		}
+
+		// sorts blocks first..last-1 (one block row) by block column.
+		void sortBlockRow(size_t first, size_t last)
+		{
+			const size_t bs = _br*_bc ;
+			std::vector<size_t> perm(last-first);
+			for (size_t b = 0 ; b < perm.size() ; ++b)
+				perm[b] = first+b ;
+			std::sort(perm.begin(), perm.end(), BlockColumnLess(_bcolid));
+			svector_t col(perm.size());
+			std::vector<Element> dat(perm.size()*bs);
+			for (size_t b = 0 ; b < perm.size() ; ++b) {
+				col[b] = _bcolid[perm[b]] ;
+				std::copy(_data.begin()+(ptrdiff_t)(perm[b]*bs), _data.begin()+(ptrdiff_t)((perm[b]+1)*bs),
+					  dat.begin()+(ptrdiff_t)(b*bs));
+			}
+			std::copy(col.begin(), col.end(), _bcolid.begin()+(ptrdiff_t)first);
+			std::copy(dat.begin(), dat.end(), _data.begin()+(ptrdiff_t)(first*bs));
+		}
+
+		struct BlockColumnLess {
+			const svector_t & _col ;
+			BlockColumnLess(const svector_t & col) : _col(col) {}
+			bool operator() (size_t a, size_t b) const { return _col[a] < _col[b] ; }
+		};
+
+		/*! ys = A xs on padded vectors.
+		 * R_ and C_ are the block sizes, 0 meaning "read them at run time".
+		 */
+		template<size_t R_, size_t C_>
+		void applyBlocks(Element * ys, const Element * xs, std::false_type) const
+		{
+			const size_t R = R_ ? R_ : _br ;
+			const size_t C = C_ ? C_ : _bc ;
+			const FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > acc(R, accu0);
+			for (size_t I = 0 ; I < blockRows() ; ++I) {
+				for (size_t k = 0 ; k < R ; ++k)
+					acc[k].reset();
+				for (index_t b = _start[I] ; b < _start[I+1] ; ++b) {
+					const Element * blk = _data.data() + (size_t)b*R*C ;
+					const Element * xb  = xs + (size_t)_bcolid[b]*C ;
+					for (size_t k = 0 ; k < R ; ++k)
+						for (size_t l = 0 ; l < C ; ++l)
+							acc[k].mulacc(blk[k*C+l], xb[l]);
+				}
+				for (size_t k = 0 ; k < R ; ++k)
+					acc[k].get(ys[I*R+k]);
+			}
+		}
+
+		// word size floating point fields : reduce once every delay() products.
+		template<size_t R_, size_t C_>
+		void applyBlocks(Element * ys, const Element * xs, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			const size_t R = R_ ? R_ : _br ;
+			const size_t C = C_ ? C_ : _bc ;
+			const size_t d = Kernel::delay(field());
+			if (d < C)
+				return applyBlocks<R_,C_>(ys, xs, std::false_type());
+			const Element p = (Element) field().characteristic() ;
+			std::vector<Element> acc(R);
+			for (size_t I = 0 ; I < blockRows() ; ++I) {
+				std::fill(acc.begin(), acc.end(), (Element)0);
+				size_t cnt = 0 ;
+				for (index_t b = _start[I] ; b < _start[I+1] ; ++b) {
+					if (cnt + C > d) {
+						for (size_t k = 0 ; k < R ; ++k)
+							acc[k] = std::fmod(acc[k], p);
+						cnt = 0 ;
+					}
+					const Element * blk = _data.data() + (size_t)b*R*C ;
+					const Element * xb  = xs + (size_t)_bcolid[b]*C ;
+					for (size_t k = 0 ; k < R ; ++k)
+						for (size_t l = 0 ; l < C ; ++l)
+							acc[k] += blk[k*C+l] * xb[l] ;
+					cnt += C ;
+				}
+				for (size_t k = 0 ; k < R ; ++k)
+					field().init(ys[I*R+k], acc[k]);
+			}
+		}
+
+		//! ys = A^t xs on padded vectors.
+		template<size_t R_, size_t C_>
+		void applyTransposeBlocks(Element * ys, const Element * xs, std::false_type) const
+		{
+			const size_t R = R_ ? R_ : _br ;
+			const size_t C = C_ ? C_ : _bc ;
+			const FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > acc(blockCols()*C, accu0);
+			for (size_t I = 0 ; I < blockRows() ; ++I) {
+				const Element * xb = xs + I*R ;
+				for (index_t b = _start[I] ; b < _start[I+1] ; ++b) {
+					const Element * blk = _data.data() + (size_t)b*R*C ;
+					FieldAXPY<Field> * yb = acc.data() + (size_t)_bcolid[b]*C ;
+					for (size_t k = 0 ; k < R ; ++k)
+						for (size_t l = 0 ; l < C ; ++l)
+							yb[l].mulacc(blk[k*C+l], xb[k]);
+				}
+			}
+			for (size_t j = 0 ; j < acc.size() ; ++j)
+				acc[j].get(ys[j]);
+		}
+
+		// a block row adds at most R products to each column.
+		template<size_t R_, size_t C_>
+		void applyTransposeBlocks(Element * ys, const Element * xs, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			const size_t R = R_ ? R_ : _br ;
+			const size_t C = C_ ? C_ : _bc ;
+			const size_t per = Kernel::delay(field()) / R ;
+			if (per == 0)
+				return applyTransposeBlocks<R_,C_>(ys, xs, std::false_type());
+			const Element p = (Element) field().characteristic() ;
+			std::vector<Element> acc(blockCols()*C, (Element)0);
+			size_t cnt = 0 ;
+			for (size_t I = 0 ; I < blockRows() ; ++I) {
+				if (cnt == per) {
+					for (size_t j = 0 ; j < acc.size() ; ++j)
+						acc[j] = std::fmod(acc[j], p);
+					cnt = 0 ;
+				}
+				const Element * xb = xs + I*R ;
+				for (index_t b = _start[I] ; b < _start[I+1] ; ++b) {
+					const Element * blk = _data.data() + (size_t)b*R*C ;
+					Element * yb = acc.data() + (size_t)_bcolid[b]*C ;
+					for (size_t k = 0 ; k < R ; ++k)
+						for (size_t l = 0 ; l < C ; ++l)
+							yb[l] += blk[k*C+l] * xb[k] ;
+				}
+				++cnt ;
+			}
+			for (size_t j = 0 ; j < acc.size() ; ++j)
+				field().init(ys[j], acc[j]);
+		}
+
+	protected :
+
+		size_t              _rownb ;
+		size_t              _colnb ;
+		size_t               _nbnz ;
+		size_t                 _br ; //!< rows of a block
+		size_t                 _bc ; //!< columns of a block
+
+		svector_t _start ;           //!< block row pointers
+		svector_t _bcolid ;          //!< block column of each block
+		std::vector<Element> _data ; //!< blocks, row major, one after the other
+
+		//! entries set outside existing blocks, waiting for \c finalize().
+		std::vector<std::pair<std::pair<size_t,size_t>,Element> > _pending ;
+
+		const _Field & _field;
+
+		struct _triples_t {
+			size_t _row ;
+			size_t _blk ;
+			size_t _l ;
+			_triples_t() : _row((size_t)-1), _blk(0), _l(0) {}
+			void reset() { _row = (size_t)-1 ; _blk = 0 ; _l = 0 ; }
+		} ;
+		mutable _triples_t _triples ;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_bcsr_matrix_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -723,8 +723,8 @@ namespace LinBox
 		}
 
 		// y = A x + a * y ;
-		template<class Vector>
-		Vector& apply(Vector &y, const Vector& x, const Element & a ) const
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x, const Element & a ) const
 		{
 			// linbox_check(consistent());
 			prepare(field(),y,a);
@@ -756,8 +756,8 @@ namespace LinBox
 		}
 
 
-		template<class Vector>
-		Vector& applyTranspose(Vector &y, const Vector& x, const Element & a ) const
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a ) const
 		{
 			linbox_check(consistent());
 			if (_helper.optimized(*this)) {
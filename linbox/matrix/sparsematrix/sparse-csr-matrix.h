@@ -39,13 +39,24 @@
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 #include "linbox/field/hom.h"
+#include "linbox/blackbox/blockbb.h"
 #include "sparse-domain.h"
+#include "sparse-delayed-kernels.h"
 #include "givaro/zring.h"
 
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
 #ifndef LINBOX_CSR_TRANSPOSE
 #define LINBOX_CSR_TRANSPOSE 1000
 #endif
 
+//! number of non zero entries (times block width for applyLeft) under which apply stays sequential.
+#ifndef LINBOX_CSR_PARALLEL_THRESHOLD
+#define LINBOX_CSR_PARALLEL_THRESHOLD 65536
+#endif
+
 namespace LinBox {
 #if 0
 	template<class _Field>
@@ -827,25 +838,51 @@ namespace LinBox {
 
 
 			// std::cout << "apply" << std::endl;
-			FieldAXPY<Field> accu(field());
-			for (size_t i = 0 ; i < _rownb ; ++i) {
-				accu.reset();
-				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
-					// field().axpyin( y[i], _data[k], x[_colid[k]] ); //! @todo delay !!!
-					accu.mulacc(_data[k],x[_colid[k]]);
-				accu.get(y[i]);
+#ifdef __LINBOX_USE_OPENMP
+			size_t nbt = (size_t)omp_get_max_threads();
+			if (nbt > 1 && _nbnz >= LINBOX_CSR_PARALLEL_THRESHOLD && _rownb >= nbt) {
+				std::vector<size_t> bounds ;
+				rowPartition(bounds,nbt);
+#pragma omp parallel for schedule(static,1)
+				for (long t = 0 ; t < (long)nbt ; ++t)
+					applyRows(y,x,bounds[(size_t)t],bounds[(size_t)t+1]);
+				return y;
 			}
+#endif
+			applyRows(y,x,0,_rownb);
 
 			return y;
 		}
 
 
+		/*! Splits the rows in \p parts contiguous blocks holding about the same number of non zero entries.
+		 * Block \c t is made of rows <code>bounds[t]..bounds[t+1]-1</code>.
+		 * Each block writes a contiguous range of the output of \c apply,
+		 * so threads only share cache lines on block boundaries.
+		 */
+		void rowPartition(std::vector<size_t> & bounds, size_t parts) const
+		{
+			linbox_check(parts > 0);
+			bounds.resize(parts+1);
+			bounds[0] = 0 ;
+			bounds[parts] = _rownb ;
+			svector_t::const_iterator beg = _start.begin();
+			svector_t::const_iterator end = _start.begin() + (ptrdiff_t)_rownb + 1;
+			for (size_t t = 1 ; t < parts ; ++t) {
+				index_t target = (index_t)((_nbnz * t) / parts) ;
+				size_t r = (size_t)(std::lower_bound(beg, end, target) - beg) ;
+				bounds[t] = std::max(bounds[t-1], std::min(r,_rownb));
+			}
+		}
+
 		// y= A^t x
 		// y[i] = sum(A(j,i) x(j)
 		template<class inVector, class outVector>
 		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a) const
 		{
 			linbox_check(consistent());
+			// large matrices keep their transpose, so that A^t x is a (parallel) row-wise apply
+			// and needs no scatter/reduction on y.
 			if (_helper.optimized(*this)) {
 				return _helper.matrix().apply(y,x,a) ; // NEVER use applyTranspose on that thing.
 			}
@@ -880,6 +917,46 @@ namespace LinBox {
 			return applyTranspose(y,x,field().zero);
 		}
 
+		/*! Mul with this on left: Y <- AX.
+		 * The matrix is streamed once per panel of \c LINBOX_SPMM_PANEL
+		 * columns of \p X (that is once for usual block sizes).
+		 * @pre \p X and \p Y are dense, row major (\c getPointer, \c getStride).
+		 */
+		template<class Mat1, class Mat2>
+		Mat1 & applyLeft(Mat1 &Y, const Mat2 &X) const
+		{
+			linbox_check(Y.rowdim() == rowdim());
+			linbox_check(X.rowdim() == coldim());
+			linbox_check(Y.coldim() == X.coldim());
+			spmm(Y.getPointer(), Y.getStride(), X.getPointer(), X.getStride(), X.coldim());
+			return Y;
+		}
+
+		/*! Mul with this on right: Y <- XA.
+		 * Computed as \f$(A^T X^T)^T\f$ so that the kernel still runs along rows.
+		 */
+		template<class Mat1, class Mat2>
+		Mat1 & applyRight(Mat1 &Y, const Mat2 &X) const
+		{
+			linbox_check(Y.coldim() == coldim());
+			linbox_check(X.coldim() == rowdim());
+			linbox_check(Y.rowdim() == X.rowdim());
+			const size_t b = X.rowdim() ;
+			std::vector<Element> Xt(_rownb*b), Yt(_colnb*b);
+			const Element * Xp = X.getPointer();
+			for (size_t i = 0 ; i < b ; ++i)
+				for (size_t k = 0 ; k < _rownb ; ++k)
+					Xt[k*b+i] = Xp[i*X.getStride()+k] ;
+
+			spmmTranspose(Yt.data(), Xt.data(), b);
+
+			Element * Yp = Y.getPointer();
+			for (size_t i = 0 ; i < b ; ++i)
+				for (size_t j = 0 ; j < _colnb ; ++j)
+					Yp[i*Y.getStride()+j] = Yt[j*b+i] ;
+			return Y;
+		}
+
 		const Field & field()  const
 		{
 			return _field ;
@@ -903,6 +980,107 @@ namespace LinBox {
 
 	private :
 
+		// y[i] = sum(A(i,j) x(j) for rbeg <= i < rend.
+		template<class inVector, class outVector>
+		void applyRows(outVector &y, const inVector& x, size_t rbeg, size_t rend) const
+		{
+			applyRows(y,x,rbeg,rend,DelayedSparseKernel<Field>());
+		}
+
+		// word size floating point fields : reduce once every delay() products.
+		template<class inVector, class outVector>
+		void applyRows(outVector &y, const inVector& x, size_t rbeg, size_t rend, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			size_t d = Kernel::delay(field());
+			if (d == 0)
+				return applyRows(y,x,rbeg,rend,std::false_type());
+			for (size_t i = rbeg ; i < rend ; ++i)
+				y[i] = Kernel::rowDot(field(), d, _data.data()+_start[i], _colid.data()+_start[i],
+						      (size_t)(_start[i+1]-_start[i]), x);
+		}
+
+		// One accumulator per call : reduction is delayed as long as FieldAXPY allows.
+		template<class inVector, class outVector>
+		void applyRows(outVector &y, const inVector& x, size_t rbeg, size_t rend, std::false_type) const
+		{
+			FieldAXPY<Field> accu(field());
+			for (size_t i = rbeg ; i < rend ; ++i) {
+				accu.reset();
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
+					accu.mulacc(_data[k],x[_colid[k]]);
+				accu.get(y[i]);
+			}
+		}
+
+		// Yt = A^t Xt, Yt and Xt row major with b columns, on the cached transpose if any.
+		void spmmTranspose(Element * Yt, const Element * Xt, size_t b) const
+		{
+			if (_helper.optimized(*this)) {
+				_helper.matrix().spmm(Yt, b, Xt, b, b);
+			}
+			else {
+				Self_t T(field(),_colnb,_rownb);
+				transpose(T);
+				T.spmm(Yt, b, Xt, b, b);
+			}
+		}
+
+		// Y = A X, Y and X row major with leading dimensions ldy and ldx, b columns.
+		void spmm(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b) const
+		{
+#ifdef __LINBOX_USE_OPENMP
+			size_t nbt = (size_t)omp_get_max_threads();
+			if (nbt > 1 && _nbnz*b >= LINBOX_CSR_PARALLEL_THRESHOLD && _rownb >= nbt) {
+				std::vector<size_t> bounds ;
+				rowPartition(bounds,nbt);
+#pragma omp parallel for schedule(static,1)
+				for (long t = 0 ; t < (long)nbt ; ++t)
+					spmmRows(Y,ldy,X,ldx,b,bounds[(size_t)t],bounds[(size_t)t+1],DelayedSparseKernel<Field>());
+				return;
+			}
+#endif
+			spmmRows(Y,ldy,X,ldx,b,0,_rownb,DelayedSparseKernel<Field>());
+		}
+
+		// word size floating point fields : reduce once every delay() products.
+		void spmmRows(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b,
+			      size_t rbeg, size_t rend, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			size_t d = Kernel::delay(field());
+			if (d == 0)
+				return spmmRows(Y,ldy,X,ldx,b,rbeg,rend,std::false_type());
+			std::vector<Element> acc(std::min(b,(size_t)LINBOX_SPMM_PANEL));
+			for (size_t j0 = 0 ; j0 < b ; j0 += LINBOX_SPMM_PANEL) {
+				size_t w = std::min(b-j0,(size_t)LINBOX_SPMM_PANEL);
+				for (size_t i = rbeg ; i < rend ; ++i)
+					Kernel::rowPanel(field(), d, _data.data()+_start[i], _colid.data()+_start[i],
+							 (size_t)(_start[i+1]-_start[i]), X+j0, ldx, w, acc.data(), Y+i*ldy+j0);
+			}
+		}
+
+		void spmmRows(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b,
+			      size_t rbeg, size_t rend, std::false_type) const
+		{
+			const FieldAXPY<Field> accu0(field());
+			for (size_t j0 = 0 ; j0 < b ; j0 += LINBOX_SPMM_PANEL) {
+				size_t w = std::min(b-j0,(size_t)LINBOX_SPMM_PANEL);
+				std::vector<FieldAXPY<Field> > acc(w, accu0);
+				for (size_t i = rbeg ; i < rend ; ++i) {
+					for (size_t l = 0 ; l < w ; ++l)
+						acc[l].reset();
+					for (index_t k = _start[i] ; k < _start[i+1] ; ++k) {
+						const Element * xr = X + (size_t)_colid[k]*ldx + j0 ;
+						for (size_t l = 0 ; l < w ; ++l)
+							acc[l].mulacc(_data[k],xr[l]);
+					}
+					for (size_t l = 0 ; l < w ; ++l)
+						acc[l].get(Y[i*ldy+j0+l]);
+				}
+			}
+		}
+
 		class Helper {
 			bool _useable ;
 			bool _optimized ;
@@ -1469,6 +1647,11 @@ namespace LinBox {
 		}_triples;
 	};
 
+	template<class Field>
+	struct is_blockbb<SparseMatrix<Field,SparseMatrixFormat::CSR> > {
+		static const bool value = true;
+	};
+
 #if 1
 
 	// template<>
@@ -0,0 +1,173 @@
+/* linbox/matrix/sparsematrix/sparse-delayed-kernels.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-delayed-kernels.h
+ * @ingroup sparsematrix
+ * @brief Sparse row times dense vector (or dense panel) kernels with delayed reduction.
+ *
+ * For floating point word size fields (\c Givaro::Modular<double>,
+ * \c Givaro::ModularBalanced<double>, \c Givaro::Modular<float>) the
+ * products of a row are summed exactly in the mantissa and reduced only
+ * once every \c delay() products, where \c delay() is the largest number
+ * of products that cannot overflow the mantissa.
+ * The inner loop has no branch and four independent accumulators, so that
+ * it vectorises (with gathers on \c x on AVX2/AVX-512 targets).
+ *
+ * The sparse formats select these kernels through
+ * \c DelayedSparseKernel<Field>::value and fall back on \c FieldAXPY otherwise.
+ */
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_delayed_kernels_H
+#define __LINBOX_matrix_sparsematrix_sparse_delayed_kernels_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "givaro/modular.h"
+#include "givaro/modular-balanced.h"
+
+namespace LinBox {
+
+	/*! Delayed reduction kernels for sparse rows.
+	 * Generic fields do not have them (\c value is \c false).
+	 */
+	template<class Field>
+	struct DelayedSparseKernel : public std::false_type {} ;
+
+	namespace Protected {
+
+		/*! Floating point delayed kernels.
+		 * @tparam Field a field whose elements are floating point numbers.
+		 * @tparam balanced whether representatives lie in <code>[-(p-1)/2,(p-1)/2]</code>
+		 * (instead of <code>[0,p-1]</code>).
+		 */
+		template<class Field, bool balanced>
+		struct DelayedFloatingKernel : public std::true_type {
+			typedef typename Field::Element Element ;
+
+			/*! Number of products that can be summed to a reduced
+			 * value without losing exactness. 0 if the modulus is too large.
+			 */
+			static size_t delay(const Field & F)
+			{
+				const Element p    = (Element) F.characteristic() ;
+				const Element e    = balanced ? std::floor(p/2) : p-1 ;
+				const Element maxi = (Element) (uint64_t(1) << std::numeric_limits<Element>::digits) ;
+				if (e*e >= maxi - p)
+					return 0 ;
+				return (size_t) std::floor( (maxi - p) / (e*e) ) ;
+			}
+
+			/*! Returns <code>sum(dat[k]*x[col[k]], k=0..len-1)</code>, reduced.
+			 * @param F field
+			 * @param d \c delay(F), computed once per apply.
+			 */
+			template<class Index, class inVector>
+			static Element rowDot(const Field & F, size_t d,
+					      const Element * dat, const Index * col, size_t len,
+					      const inVector & x)
+			{
+				linbox_check(d > 0);
+				const Element p = (Element) F.characteristic() ;
+				Element acc = 0 ;
+				size_t k = 0 ;
+				while (k < len) {
+					const size_t stop = std::min(len, k + d) ;
+					Element s0 = 0, s1 = 0, s2 = 0, s3 = 0 ;
+					for ( ; k + 4 <= stop ; k += 4) {
+						s0 += dat[k  ] * x[col[k  ]] ;
+						s1 += dat[k+1] * x[col[k+1]] ;
+						s2 += dat[k+2] * x[col[k+2]] ;
+						s3 += dat[k+3] * x[col[k+3]] ;
+					}
+					for ( ; k < stop ; ++k)
+						s0 += dat[k] * x[col[k]] ;
+					acc += (s0 + s1) + (s2 + s3) ;
+					acc = std::fmod(acc, p) ;
+				}
+				Element r ;
+				return F.init(r, acc) ;
+			}
+
+			/*! Sparse row times a dense row major panel.
+			 * <code>y[l] = sum(dat[k]*X[col[k]*ldx+l], k=0..len-1)</code>
+			 * for <code>0 <= l < w</code>, reduced.
+			 * The innermost loop runs along contiguous rows of \p X.
+			 * @param acc scratch space of size \p w.
+			 */
+			template<class Index>
+			static void rowPanel(const Field & F, size_t d,
+					     const Element * dat, const Index * col, size_t len,
+					     const Element * X, size_t ldx, size_t w,
+					     Element * acc, Element * y)
+			{
+				linbox_check(d > 0);
+				const Element p = (Element) F.characteristic() ;
+				for (size_t l = 0 ; l < w ; ++l)
+					acc[l] = 0 ;
+				size_t k = 0 ;
+				while (k < len) {
+					const size_t stop = std::min(len, k + d) ;
+					for ( ; k < stop ; ++k) {
+						const Element a = dat[k] ;
+						const Element * xr = X + (size_t)col[k]*ldx ;
+						for (size_t l = 0 ; l < w ; ++l)
+							acc[l] += a * xr[l] ;
+					}
+					if (k < len)
+						for (size_t l = 0 ; l < w ; ++l)
+							acc[l] = std::fmod(acc[l], p) ;
+				}
+				for (size_t l = 0 ; l < w ; ++l)
+					F.init(y[l], acc[l]) ;
+			}
+		};
+
+	} // Protected
+
+	template<>
+	struct DelayedSparseKernel<Givaro::Modular<double> > :
+		public Protected::DelayedFloatingKernel<Givaro::Modular<double>, false> {} ;
+
+	template<>
+	struct DelayedSparseKernel<Givaro::ModularBalanced<double> > :
+		public Protected::DelayedFloatingKernel<Givaro::ModularBalanced<double>, true> {} ;
+
+	template<>
+	struct DelayedSparseKernel<Givaro::Modular<float> > :
+		public Protected::DelayedFloatingKernel<Givaro::Modular<float>, false> {} ;
+
+} // LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_delayed_kernels_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
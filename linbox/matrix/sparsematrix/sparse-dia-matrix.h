@@ -0,0 +1,452 @@
+/* linbox/matrix/sparsematrix/sparse-dia-matrix.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-dia-matrix.h
+ * @ingroup sparsematrix
+ * @brief Diagonal (DIA) sparse matrix storage, for banded matrices.
+ *
+ * Each stored diagonal is a contiguous array, so that apply and
+ * applyTranspose are sums of shifted dense vector products, with no
+ * index indirection.
+ */
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_dia_matrix_H
+#define __LINBOX_matrix_sparsematrix_sparse_dia_matrix_H
+
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/field/hom.h"
+#include "sparse-domain.h"
+#include "sparse-delayed-kernels.h"
+#include "sparse-csr-matrix.h"
+
+namespace LinBox {
+
+	/** Sparse matrix, DIA storage.
+	 *
+	 * Diagonal \c d has offset <code>_offset[d] = j - i</code> (offsets are
+	 * sorted) and entry <code>(i, i+_offset[d])</code> is stored in
+	 * <code>_data[d*rowdim()+i]</code>. Positions falling outside of the
+	 * matrix are zeros that are never read.
+	 *
+	 * The format pays off when the number of diagonals is small (banded,
+	 * Toeplitz like matrices) ; it is wasteful otherwise.
+	 *
+	 * \ingroup matrix
+	 * \ingroup sparse
+	 */
+	template<class _Field>
+	class SparseMatrix<_Field, SparseMatrixFormat::DIA > {
+	private :
+		typedef std::vector<ptrdiff_t> ovector_t ;
+	public :
+		typedef _Field                             Field ; //!< Field
+		typedef typename _Field::Element         Element ; //!< Element
+		typedef const Element               constElement ; //!< const Element
+		typedef SparseMatrixFormat::DIA          Storage ; //!< Matrix Storage Format
+		typedef SparseMatrix<_Field,Storage>      Self_t ; //!< Self type
+		typedef typename Vector<Field>::SparseSeq    Row ; //!< @warning this is not the row type. Just used for streams.
+		typedef SparseMatrix<_Field,SparseMatrixFormat::CSR> Csr_t ;
+
+		/*! Constructors.
+		 */
+		//@{
+		SparseMatrix<_Field, SparseMatrixFormat::DIA> (const _Field & F) :
+			_rownb(0),_colnb(0),_nbnz(0)
+			,_offset(0),_data(0)
+			,_field(F)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::DIA> (const _Field & F, size_t m, size_t n) :
+			_rownb(m),_colnb(n),_nbnz(0)
+			,_offset(0),_data(0)
+			,_field(F)
+		{}
+
+		SparseMatrix<_Field, SparseMatrixFormat::DIA> (const SparseMatrix<_Field, SparseMatrixFormat::DIA> & S) :
+			_rownb(S._rownb),_colnb(S._colnb),_nbnz(S._nbnz)
+			,_offset(S._offset),_data(S._data)
+			,_field(S._field)
+		{}
+
+		//! Conversion from CSR.
+		SparseMatrix<_Field, SparseMatrixFormat::DIA> (const Csr_t & S) :
+			_rownb(S.rowdim()),_colnb(S.coldim()),_nbnz(0)
+			,_field(S.field())
+		{
+			importe(S);
+		}
+
+		//! Conversion from any format (and field), through CSR.
+		template<typename _Tp1, typename _Rw1>
+		SparseMatrix (const SparseMatrix<_Tp1, _Rw1> &S, const Field& F) :
+			_rownb(S.rowdim()),_colnb(S.coldim()),_nbnz(0)
+			,_field(F)
+		{
+			Csr_t T(S,F);
+			importe(T);
+		}
+
+		//! Reads MatrixMarket, SMS,... (anything \c MatrixStream knows).
+		SparseMatrix<_Field, SparseMatrixFormat::DIA> ( MatrixStream<Field>& ms ) :
+			_rownb(0),_colnb(0),_nbnz(0)
+			,_field(ms.field())
+		{
+			Csr_t T(ms);
+			importe(T);
+		}
+		//@}
+
+		template<typename _Tp1, typename _Rw1 = SparseMatrixFormat::DIA>
+		struct rebind {
+			typedef SparseMatrix<_Tp1, _Rw1> other;
+
+			template<class _Rw>
+			void operator() (SparseMatrix<_Tp1,_Rw> & Ap, const Self_t & A)
+			{
+				typename _Tp1::Element e;
+				Hom<typename Self_t::Field, _Tp1> hom(A.field(), Ap.field());
+				Ap.resize(A.rowdim(), A.coldim(), 0);
+				size_t i, j ;
+				Element f ;
+				A.firstTriple();
+				while ( A.nextTriple(i,j,f) ) {
+					hom. image ( e, f) ;
+					if (! Ap.field().isZero(e) )
+						Ap.appendEntry(i,j,e);
+				}
+				A.firstTriple();
+				Ap.finalize();
+			}
+		};
+
+		/*! Build from a CSR matrix.
+		 */
+		void importe(const Csr_t & S)
+		{
+			_rownb = S.rowdim();
+			_colnb = S.coldim();
+			_nbnz  = 0 ;
+			_offset.clear();
+
+			// which diagonals are used
+			std::vector<bool> used(_rownb+_colnb, false);
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				for (index_t k = S.getStart(i) ; k < S.getEnd(i) ; ++k)
+					if (!field().isZero(S.getData(k)))
+						used[_rownb - 1 + S.getColid(k) - i] = true ;
+			std::vector<size_t> where(used.size(), 0);
+			for (size_t t = 0 ; t < used.size() ; ++t)
+				if (used[t]) {
+					where[t] = _offset.size();
+					_offset.push_back((ptrdiff_t)t - (ptrdiff_t)_rownb + 1);
+				}
+
+			_data.assign(_offset.size()*_rownb, field().zero);
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				for (index_t k = S.getStart(i) ; k < S.getEnd(i) ; ++k) {
+					if (field().isZero(S.getData(k)))
+						continue ;
+					const size_t d = where[_rownb - 1 + S.getColid(k) - i] ;
+					field().assign(_data[d*_rownb+i], S.getData(k));
+					++_nbnz ;
+				}
+			_triples.reset();
+		}
+
+		size_t rowdim() const { return _rownb ; }
+
+		size_t coldim() const { return _colnb ; }
+
+		//! number of (non zero) entries.
+		size_t size() const { return _nbnz ; }
+
+		//! number of stored diagonals.
+		size_t diagonals() const { return _offset.size() ; }
+
+		const Field & field()  const { return _field ; }
+
+		void resize(const size_t & m, const size_t & n, const size_t & = 0)
+		{
+			_rownb = m ;
+			_colnb = n ;
+			_nbnz = 0 ;
+			_offset.clear();
+			_data.clear();
+			_triples.reset();
+		}
+
+		constElement & getEntry(const size_t &i, const size_t &j) const
+		{
+			linbox_check(i < _rownb);
+			linbox_check(j < _colnb);
+			ptrdiff_t d = findDiagonal((ptrdiff_t)j-(ptrdiff_t)i);
+			if (d < 0)
+				return field().zero ;
+			return _data[(size_t)d*_rownb+i] ;
+		}
+
+		Element &getEntry (Element &x, size_t i, size_t j) const
+		{
+			return x = getEntry (i, j);
+		}
+
+		/** Set an individual entry.
+		 * A missing diagonal is inserted (this moves the diagonals after it).
+		 */
+		const Element& setEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			linbox_check(i < _rownb);
+			linbox_check(j < _colnb);
+			const ptrdiff_t o = (ptrdiff_t)j-(ptrdiff_t)i ;
+			ptrdiff_t d = findDiagonal(o);
+			if (d < 0) {
+				if (field().isZero(e))
+					return e ;
+				d = std::lower_bound(_offset.begin(), _offset.end(), o) - _offset.begin() ;
+				_offset.insert(_offset.begin()+d, o);
+				_data.insert(_data.begin()+d*(ptrdiff_t)_rownb, _rownb, field().zero);
+			}
+			Element & a = _data[(size_t)d*_rownb+i] ;
+			if (field().isZero(a) && !field().isZero(e)) ++_nbnz ;
+			if (!field().isZero(a) && field().isZero(e)) --_nbnz ;
+			field().assign(a,e);
+			return e ;
+		}
+
+		void appendEntry(const size_t &i, const size_t &j, const Element& e)
+		{
+			setEntry(i,j,e);
+		}
+
+		/// make matrix ready to use after a sequence of setEntry calls.
+		void finalize()
+		{
+			_triples.reset();
+		}
+
+		void firstTriple() const
+		{
+			_triples.reset();
+		}
+
+		//! Triples in row major order.
+		bool nextTriple(size_t & i, size_t &j, Element &e) const
+		{
+			_triples_t & t = _triples ;
+			if (t._row == (size_t)-1) {
+				t._row = 0 ;
+				t._diag = 0 ;
+			}
+			else
+				++t._diag ;
+			for ( ; t._row < _rownb ; ++t._row, t._diag = 0)
+				for ( ; t._diag < _offset.size() ; ++t._diag) {
+					const ptrdiff_t c = (ptrdiff_t)t._row + _offset[t._diag] ;
+					if (c < 0)
+						continue ;
+					if (c >= (ptrdiff_t)_colnb)
+						break ;
+					const Element & a = _data[t._diag*_rownb+t._row] ;
+					if (!field().isZero(a)) {
+						i = t._row ;
+						j = (size_t)c ;
+						e = a ;
+						return true ;
+					}
+				}
+			t.reset();
+			return false ;
+		}
+
+		std::ostream & write(std::ostream &os
+				     , Tag::FileFormat format  = Tag::FileFormat::MatrixMarket) const
+		{
+			return Csr_t(*this, field()).write(os,format);
+		}
+
+		std::istream& read (std::istream &is
+				    , Tag::FileFormat format = Tag::FileFormat::Detect)
+		{
+			Csr_t T(field());
+			T.read(is,format);
+			importe(T);
+			return is ;
+		}
+
+		// y= Ax
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x, const Element & a ) const
+		{
+			prepare(field(),y,a);
+			std::vector<Element> xs(_colnb);
+			std::vector<Element> ys(_rownb);
+			for (size_t j = 0 ; j < _colnb ; ++j)
+				field().assign(xs[j], x[j]);
+			applyDiagonals(ys, xs, false, DelayedSparseKernel<Field>());
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				field().assign(y[i], ys[i]);
+			return y;
+		}
+
+		// y= A^t x
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a ) const
+		{
+			prepare(field(),y,a);
+			std::vector<Element> xs(_rownb);
+			std::vector<Element> ys(_colnb);
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				field().assign(xs[i], x[i]);
+			applyDiagonals(ys, xs, true, DelayedSparseKernel<Field>());
+			for (size_t j = 0 ; j < _colnb ; ++j)
+				field().assign(y[j], ys[j]);
+			return y;
+		}
+
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x ) const
+		{
+			return apply(y,x,field().zero);
+		}
+
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x ) const
+		{
+			return applyTranspose(y,x,field().zero);
+		}
+
+	private :
+
+		// index of the diagonal of offset o or -1.
+		ptrdiff_t findDiagonal(ptrdiff_t o) const
+		{
+			ovector_t::const_iterator it = std::lower_bound(_offset.begin(), _offset.end(), o);
+			if (it == _offset.end() || *it != o)
+				return -1 ;
+			return it - _offset.begin() ;
+		}
+
+		/*! Rows <code>[ibeg,iend)</code> of diagonal \p d meet the matrix.
+		 */
+		void range(size_t d, size_t & ibeg, size_t & iend) const
+		{
+			const ptrdiff_t o = _offset[d] ;
+			ibeg = (size_t) std::max((ptrdiff_t)0, -o);
+			iend = (size_t) std::max((ptrdiff_t)ibeg,
+						 std::min((ptrdiff_t)_rownb, (ptrdiff_t)_colnb - o));
+		}
+
+		/*! y = A x, or y = A^t x when \p trans.
+		 * One pass per diagonal, every pass is a unit stride loop on
+		 * the diagonal, on \p x and on the accumulators.
+		 */
+		void applyDiagonals(std::vector<Element> & y, const std::vector<Element> & x,
+				    bool trans, std::false_type) const
+		{
+			const FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > acc(y.size(), accu0);
+			for (size_t d = 0 ; d < _offset.size() ; ++d) {
+				size_t ibeg, iend ;
+				range(d, ibeg, iend);
+				const Element * dat = _data.data() + d*_rownb ;
+				const ptrdiff_t o = _offset[d] ;
+				if (trans)
+					for (size_t i = ibeg ; i < iend ; ++i)
+						acc[(size_t)((ptrdiff_t)i+o)].mulacc(dat[i], x[i]);
+				else
+					for (size_t i = ibeg ; i < iend ; ++i)
+						acc[i].mulacc(dat[i], x[(size_t)((ptrdiff_t)i+o)]);
+			}
+			for (size_t k = 0 ; k < y.size() ; ++k)
+				acc[k].get(y[k]);
+		}
+
+		// word size floating point fields : a diagonal adds one product
+		// to each accumulator, so reduce once every delay() diagonals.
+		void applyDiagonals(std::vector<Element> & y, const std::vector<Element> & x,
+				    bool trans, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			const size_t dl = Kernel::delay(field());
+			if (dl == 0)
+				return applyDiagonals(y, x, trans, std::false_type());
+			const Element p = (Element) field().characteristic() ;
+			std::vector<Element> acc(y.size(), (Element)0);
+			size_t cnt = 0 ;
+			for (size_t d = 0 ; d < _offset.size() ; ++d) {
+				if (cnt == dl) {
+					for (size_t k = 0 ; k < acc.size() ; ++k)
+						acc[k] = std::fmod(acc[k], p);
+					cnt = 0 ;
+				}
+				size_t ibeg, iend ;
+				range(d, ibeg, iend);
+				const size_t len = iend - ibeg ;
+				const size_t jbeg = (size_t)((ptrdiff_t)ibeg + _offset[d]) ;
+				const Element * dat = _data.data() + d*_rownb + ibeg ;
+				const Element * xd = x.data() + (trans ? ibeg : jbeg) ;
+				Element * yd = acc.data() + (trans ? jbeg : ibeg) ;
+				for (size_t k = 0 ; k < len ; ++k)
+					yd[k] += dat[k] * xd[k] ;
+				++cnt ;
+			}
+			for (size_t k = 0 ; k < y.size() ; ++k)
+				field().init(y[k], acc[k]);
+		}
+
+	protected :
+
+		size_t              _rownb ;
+		size_t              _colnb ;
+		size_t               _nbnz ;
+
+		ovector_t _offset ;          //!< sorted offsets <code>j-i</code> of the diagonals
+		std::vector<Element> _data ; //!< diagonals, <code>rowdim()</code> entries each
+
+		const _Field & _field;
+
+		struct _triples_t {
+			size_t _row ;
+			size_t _diag ;
+			_triples_t() : _row((size_t)-1), _diag(0) {}
+			void reset() { _row = (size_t)-1 ; _diag = 0 ; }
+		} ;
+		mutable _triples_t _triples ;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_dia_matrix_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -34,6 +34,11 @@
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 
+//! number of columns of a dense block handled in one sweep of a sparse matrix by applyLeft/applyRight.
+#ifndef LINBOX_SPMM_PANEL
+#define LINBOX_SPMM_PANEL 64
+#endif
+
 namespace LinBox {
 
 	/// y <- ay.  @todo Vector knows Field
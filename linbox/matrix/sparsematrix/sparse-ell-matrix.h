@@ -40,6 +40,7 @@
 #include "linbox/util/debug.h"
 #include "linbox/field/hom.h"
 #include "sparse-domain.h"
+#include "sparse-delayed-kernels.h"
 
 #ifndef LINBOX_ELL_TRANSPOSE
 #define LINBOX_ELL_TRANSPOSE 1000
@@ -771,19 +772,7 @@ namespace LinBox
 			// linbox_check(consistent());
 			prepare(field(),y,a);
 
-
-			FieldAXPY<Field> accu(field());
-			for (size_t i = 0 ; i < _rownb ; ++i) {
-				accu.reset();
-				for (size_t k = 0   ; k < _maxc ; ++k)
-					if (!field().isZero(getData(i,k)))
-						// field().axpyin( y[i], getData(i,k), x[getColid(i,k)] ); //! @todo delay !!!
-						accu.mulacc( getData(i,k), x[getColid(i,k)] );
-					else {
-						break;
-					}
-				accu.get(y[i]);
-			}
+			applyRows(y,x,DelayedSparseKernel<Field>());
 
 			return y;
 		}
@@ -892,6 +881,39 @@ namespace LinBox
 
 	private :
 
+		// word size floating point fields : reduce once every delay() products.
+		template<class outVector, class inVector>
+		void applyRows(outVector &y, const inVector& x, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			size_t d = Kernel::delay(field());
+			if (d == 0)
+				return applyRows(y,x,std::false_type());
+			for (size_t i = 0 ; i < _rownb ; ++i) {
+				const Element * dat = _data.data() + i*_maxc ;
+				size_t len = 0 ;
+				while (len < _maxc && !field().isZero(dat[len]))
+					++len ;
+				y[i] = Kernel::rowDot(field(), d, dat, _colid.data() + i*_maxc, len, x);
+			}
+		}
+
+		template<class outVector, class inVector>
+		void applyRows(outVector &y, const inVector& x, std::false_type) const
+		{
+			FieldAXPY<Field> accu(field());
+			for (size_t i = 0 ; i < _rownb ; ++i) {
+				accu.reset();
+				for (size_t k = 0   ; k < _maxc ; ++k)
+					if (!field().isZero(getData(i,k)))
+						accu.mulacc( getData(i,k), x[getColid(i,k)] );
+					else {
+						break;
+					}
+				accu.get(y[i]);
+			}
+		}
+
 		class Helper {
 			bool _useable ;
 			bool _optimized ;
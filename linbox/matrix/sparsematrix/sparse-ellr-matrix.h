@@ -39,12 +39,23 @@
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 #include "linbox/field/hom.h"
+#include "linbox/blackbox/blockbb.h"
 #include "sparse-domain.h"
+#include "sparse-delayed-kernels.h"
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
 
 #ifndef LINBOX_ELLR_TRANSPOSE
 #define LINBOX_ELLR_TRANSPOSE 1000
 #endif
 
+//! number of non zero entries (times block width) under which applyLeft stays sequential.
+#ifndef LINBOX_ELLR_PARALLEL_THRESHOLD
+#define LINBOX_ELLR_PARALLEL_THRESHOLD 65536
+#endif
+
 namespace LinBox
 {
 
@@ -780,21 +791,13 @@ namespace LinBox
 
 		// y= Ax
 		// y[i] = sum(A(i,j) x(j)
-		template<class Vector>
-		Vector& apply(Vector &y, const Vector& x, const Element & a ) const
+		template<class outVector, class inVector>
+		outVector& apply(outVector &y, const inVector& x, const Element & a ) const
 		{
 			// linbox_check(consistent());
 			prepare(field(),y,a);
 
-
-			FieldAXPY<Field> accu(field());
-			for (size_t i = 0 ; i < _rownb ; ++i) {
-				accu.reset();
-				for (size_t k = 0   ; k < _rowid[i] ; ++k)
-					// field().axpyin( y[i], getData(i,k), x[getColid(i,k)] ); //! @todo delay !!!
-					accu.mulacc( getData(i,k), x[getColid(i,k)] );
-				accu.get(y[i]);
-			}
+			applyRows(y,x,DelayedSparseKernel<Field>());
 
 			return y;
 		}
@@ -802,8 +805,8 @@ namespace LinBox
 
 		// y= A^t x
 		// y[i] = sum(A(j,i) x(j)
-		template<class Vector>
-		Vector& applyTranspose(Vector &y, const Vector& x, const Element & a ) const
+		template<class outVector, class inVector>
+		outVector& applyTranspose(outVector &y, const inVector& x, const Element & a ) const
 		{
 			// linbox_check(consistent());
 			if (_helper.optimized(*this)) {
@@ -849,6 +852,45 @@ namespace LinBox
 			return applyTranspose(y,x,field().zero);
 		}
 
+		/*! Mul with this on left: Y <- AX.
+		 * The matrix is streamed once per panel of \c LINBOX_SPMM_PANEL
+		 * columns of \p X.
+		 * @pre \p X and \p Y are dense, row major (\c getPointer, \c getStride).
+		 */
+		template<class Mat1, class Mat2>
+		Mat1 & applyLeft(Mat1 &Y, const Mat2 &X) const
+		{
+			linbox_check(Y.rowdim() == rowdim());
+			linbox_check(X.rowdim() == coldim());
+			linbox_check(Y.coldim() == X.coldim());
+			spmm(Y.getPointer(), Y.getStride(), X.getPointer(), X.getStride(), X.coldim());
+			return Y;
+		}
+
+		/*! Mul with this on right: Y <- XA, computed as \f$(A^T X^T)^T\f$.
+		 */
+		template<class Mat1, class Mat2>
+		Mat1 & applyRight(Mat1 &Y, const Mat2 &X) const
+		{
+			linbox_check(Y.coldim() == coldim());
+			linbox_check(X.coldim() == rowdim());
+			linbox_check(Y.rowdim() == X.rowdim());
+			const size_t b = X.rowdim() ;
+			std::vector<Element> Xt(_rownb*b), Yt(_colnb*b);
+			const Element * Xp = X.getPointer();
+			for (size_t i = 0 ; i < b ; ++i)
+				for (size_t k = 0 ; k < _rownb ; ++k)
+					Xt[k*b+i] = Xp[i*X.getStride()+k] ;
+
+			spmmTranspose(Yt.data(), Xt.data(), b);
+
+			Element * Yp = Y.getPointer();
+			for (size_t i = 0 ; i < b ; ++i)
+				for (size_t j = 0 ; j < _colnb ; ++j)
+					Yp[i*Y.getStride()+j] = Yt[j*b+i] ;
+			return Y;
+		}
+
 		const Field & field()  const
 		{
 			return _field ;
@@ -894,6 +936,99 @@ namespace LinBox
 
 	private :
 
+		// word size floating point fields : reduce once every delay() products.
+		template<class outVector, class inVector>
+		void applyRows(outVector &y, const inVector& x, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			size_t d = Kernel::delay(field());
+			if (d == 0)
+				return applyRows(y,x,std::false_type());
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				y[i] = Kernel::rowDot(field(), d, _data.data() + i*_maxc, _colid.data() + i*_maxc,
+						      (size_t)_rowid[i], x);
+		}
+
+		template<class outVector, class inVector>
+		void applyRows(outVector &y, const inVector& x, std::false_type) const
+		{
+			FieldAXPY<Field> accu(field());
+			for (size_t i = 0 ; i < _rownb ; ++i) {
+				accu.reset();
+				for (size_t k = 0   ; k < _rowid[i] ; ++k)
+					accu.mulacc( getData(i,k), x[getColid(i,k)] );
+				accu.get(y[i]);
+			}
+		}
+
+		// Yt = A^t Xt, Yt and Xt row major with b columns, on the cached transpose if any.
+		void spmmTranspose(Element * Yt, const Element * Xt, size_t b) const
+		{
+			if (_helper.optimized(*this)) {
+				_helper.matrix().spmm(Yt, b, Xt, b, b);
+			}
+			else {
+				Self_t T(field(),_colnb,_rownb);
+				transpose(T);
+				T.spmm(Yt, b, Xt, b, b);
+			}
+		}
+
+		// Y = A X, Y and X row major with leading dimensions ldy and ldx, b columns.
+		// rows have at most _maxc entries, so an even split of the rows is balanced enough.
+		void spmm(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b) const
+		{
+#ifdef __LINBOX_USE_OPENMP
+			size_t nbt = (size_t)omp_get_max_threads();
+			if (nbt > 1 && _nbnz*b >= LINBOX_ELLR_PARALLEL_THRESHOLD && _rownb >= nbt) {
+#pragma omp parallel for schedule(static,1)
+				for (long t = 0 ; t < (long)nbt ; ++t)
+					spmmRows(Y,ldy,X,ldx,b,((size_t)t*_rownb)/nbt,((size_t)(t+1)*_rownb)/nbt,
+						 DelayedSparseKernel<Field>());
+				return;
+			}
+#endif
+			spmmRows(Y,ldy,X,ldx,b,0,_rownb,DelayedSparseKernel<Field>());
+		}
+
+		// word size floating point fields : reduce once every delay() products.
+		void spmmRows(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b,
+			      size_t rbeg, size_t rend, std::true_type) const
+		{
+			typedef DelayedSparseKernel<Field> Kernel ;
+			size_t d = Kernel::delay(field());
+			if (d == 0)
+				return spmmRows(Y,ldy,X,ldx,b,rbeg,rend,std::false_type());
+			std::vector<Element> acc(std::min(b,(size_t)LINBOX_SPMM_PANEL));
+			for (size_t j0 = 0 ; j0 < b ; j0 += LINBOX_SPMM_PANEL) {
+				size_t w = std::min(b-j0,(size_t)LINBOX_SPMM_PANEL);
+				for (size_t i = rbeg ; i < rend ; ++i)
+					Kernel::rowPanel(field(), d, _data.data()+i*_maxc, _colid.data()+i*_maxc,
+							 (size_t)_rowid[i], X+j0, ldx, w, acc.data(), Y+i*ldy+j0);
+			}
+		}
+
+		void spmmRows(Element * Y, size_t ldy, const Element * X, size_t ldx, size_t b,
+			      size_t rbeg, size_t rend, std::false_type) const
+		{
+			const FieldAXPY<Field> accu0(field());
+			for (size_t j0 = 0 ; j0 < b ; j0 += LINBOX_SPMM_PANEL) {
+				size_t w = std::min(b-j0,(size_t)LINBOX_SPMM_PANEL);
+				std::vector<FieldAXPY<Field> > acc(w, accu0);
+				for (size_t i = rbeg ; i < rend ; ++i) {
+					for (size_t l = 0 ; l < w ; ++l)
+						acc[l].reset();
+					for (size_t k = 0 ; k < _rowid[i] ; ++k) {
+						const Element * xr = X + getColid(i,k)*ldx + j0 ;
+						for (size_t l = 0 ; l < w ; ++l)
+							acc[l].mulacc(getData(i,k),xr[l]);
+					}
+					for (size_t l = 0 ; l < w ; ++l)
+						acc[l].get(Y[i*ldy+j0+l]);
+				}
+			}
+		}
+
 		class Helper {
 			bool _useable ;
 			bool _optimized ;
@@ -1527,9 +1662,10 @@ namespace LinBox
 		}_triples;
 	};
 
-
-
-
+	template<class Field>
+	struct is_blockbb<SparseMatrix<Field,SparseMatrixFormat::ELL_R> > {
+		static const bool value = true;
+	};
 
 } // namespace LinBox
 
@@ -0,0 +1,397 @@
+/* linbox/matrix/sparsematrix/sparse-mapped-csr.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sparsematrix/sparse-mapped-csr.h
+ * @ingroup sparsematrix
+ * @brief Binary CSR files, memory mapped.
+ *
+ * The file is, by bytes count (native endianness, checked at load) :
+ *  0-7     "LBXCSR\0\0"
+ *  8-11    version (2)
+ *  12-15   0x01020304, endianness mark
+ *  16-19   sizeof(index_t)
+ *  20-23   sizeof(Element)
+ *  24-31   row dimension m
+ *  32-39   column dimension n
+ *  40-47   number of non zero entries z
+ *  48-55   number w of 64 bits words of the cardinality of the field
+ *  56-63   offset of the row starts (m+1 index_t)
+ *  64-71   offset of the column indices (z index_t)
+ *  72-79   offset of the values (z Element)
+ *  80-87   offset of the cardinality (w uint64_t, least significant first)
+ *  88-127  reserved
+ * The arrays are aligned on LINBOX_MAPPED_CSR_ALIGN bytes.
+ * Loading is an mmap : the arrays of MappedCSR are those of the file.
+ */
+
+
+#ifndef __LINBOX_sparse_matrix_sparse_mapped_csr_H
+#define __LINBOX_sparse_matrix_sparse_mapped_csr_H
+
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/util/field-axpy.h"
+#include "linbox/matrix/sparse-matrix.h"
+
+#ifndef LINBOX_MAPPED_CSR_ALIGN
+#define LINBOX_MAPPED_CSR_ALIGN 64
+#endif
+
+namespace LinBox {
+
+	//! Header of a binary CSR file.
+	struct MappedCSRHeader {
+		char     magic[8];
+		uint32_t version;
+		uint32_t endian;
+		uint32_t indexSize;
+		uint32_t elementSize;
+		uint64_t rowdim;
+		uint64_t coldim;
+		uint64_t nbnz;
+		uint64_t cardinalityWords;
+		uint64_t startOffset;
+		uint64_t colidOffset;
+		uint64_t dataOffset;
+		uint64_t cardinalityOffset;
+		uint64_t reserved[5];
+
+		static const uint32_t currentVersion = 2;
+		static const uint32_t endianMark = 0x01020304;
+
+		static bool sameMagic(const char * m)
+		{
+			return std::memcmp(m, "LBXCSR\0\0", 8) == 0;
+		}
+	};
+
+	/** Read only sparse matrix, mapped from a binary CSR file.
+	 * Nothing is parsed nor copied : the row starts, column indices and
+	 * values are used in place, pages are read on demand.
+	 * This is a blackbox (apply, applyTranspose) and exporte copies it in
+	 * bulk to a SparseMatrix in CSR or SparseSeq format.
+	 * Written by writeMappedCSR.
+	 *
+	 * \ingroup matrix
+	 * \ingroup sparse
+	 */
+	template<class _Field>
+	class MappedCSR {
+	public :
+		typedef _Field                             Field ; //!< Field
+		typedef typename _Field::Element         Element ; //!< Element
+		typedef MappedCSR<_Field>                 Self_t ; //!< Self type
+
+		static_assert(std::is_trivially_copyable<Element>::value,
+			      "binary CSR files need trivially copyable elements");
+
+		/*! Maps a file.
+		 * @param F field, its cardinality must be the one of the file.
+		 * @param filename a file written by writeMappedCSR.
+		 */
+		MappedCSR(const Field & F, const std::string & filename) :
+			_field(&F), _map(NULL), _length(0)
+		{
+			int fd = ::open(filename.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw LinboxError("LinBox ERROR: cannot open binary CSR file " + filename);
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MappedCSRHeader)) {
+				::close(fd);
+				throw LinboxError("LinBox ERROR: not a binary CSR file " + filename);
+			}
+			_length = (size_t)st.st_size;
+			void * p = ::mmap(NULL, _length, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (p == MAP_FAILED)
+				throw LinboxError("LinBox ERROR: cannot map binary CSR file " + filename);
+			_map = static_cast<const char*>(p);
+
+			const MappedCSRHeader & h = header();
+			std::string msg = check(h);
+			if (! msg.empty()) {
+				::munmap(const_cast<char*>(_map), _length);
+				throw LinboxError("LinBox ERROR: " + filename + ": " + msg);
+			}
+			_rownb = (size_t)h.rowdim;
+			_colnb = (size_t)h.coldim;
+			_nbnz  = (size_t)h.nbnz;
+			_start = reinterpret_cast<const index_t*>(_map + h.startOffset);
+			_colid = reinterpret_cast<const index_t*>(_map + h.colidOffset);
+			_data  = reinterpret_cast<const Element*>(_map + h.dataOffset);
+			linbox_check(consistent());
+		}
+
+		~MappedCSR()
+		{
+			if (_map)
+				::munmap(const_cast<char*>(_map), _length);
+		}
+
+		size_t rowdim() const { return _rownb ; }
+		size_t coldim() const { return _colnb ; }
+		size_t size() const { return _nbnz ; }
+		const Field & field() const { return *_field; }
+
+		//! row i is [start()[i], start()[i+1])
+		const index_t * start() const { return _start ; }
+		const index_t * colid() const { return _colid ; }
+		const Element * data() const { return _data ; }
+
+		/** Get a read-only individual entry from the matrix.
+		 * @param x the entry, zero if not stored
+		 * @param i Row index
+		 * @param j Column index
+		 */
+		Element & getEntry(Element & x, const size_t & i, const size_t & j) const
+		{
+			const index_t * beg = _colid + _start[i];
+			const index_t * end = _colid + _start[i+1];
+			const index_t * low = std::lower_bound(beg, end, (index_t)j);
+			if (low == end || *low != (index_t)j)
+				return field().assign(x, field().zero);
+			return field().assign(x, _data[low-_colid]);
+		}
+
+		template<class OutVector, class InVector>
+		OutVector& apply(OutVector &y, const InVector& x) const
+		{
+			FieldAXPY<Field> accu(field());
+			for (size_t i = 0 ; i < _rownb ; ++i) {
+				accu.reset();
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
+					accu.mulacc(_data[k], x[(size_t)_colid[k]]);
+				accu.get(y[i]);
+			}
+			return y;
+		}
+
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose(OutVector &y, const InVector& x) const
+		{
+			FieldAXPY<Field> accu0(field());
+			std::vector<FieldAXPY<Field> > Y(_colnb, accu0);
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
+					Y[(size_t)_colid[k]].mulacc(_data[k], x[i]);
+			for (size_t j = 0 ; j < _colnb ; ++j)
+				Y[j].get(y[j]);
+			return y;
+		}
+
+		/*! Bulk copy to a CSR matrix.
+		 * @param S CSR matrix, resized
+		 */
+		template<class _CSR>
+		_CSR & exporte(_CSR & S, SparseMatrixFormat::CSR) const
+		{
+			S.resize(_rownb, _colnb, _nbnz);
+			for (size_t i = 0 ; i <= _rownb ; ++i)
+				S.setStart(i, _start[i]);
+			for (size_t k = 0 ; k < _nbnz ; ++k) {
+				S.setColid(k, (size_t)_colid[k]);
+				S.setData(k, _data[k]);
+			}
+			S.finalize();
+			return S;
+		}
+
+		/*! Bulk copy to a matrix of sparse sequence rows.
+		 * @param S SparseSeq matrix, resized
+		 */
+		template<class _Seq>
+		_Seq & exporte(_Seq & S, SparseMatrixFormat::SparseSeq) const
+		{
+			typedef typename _Seq::Row Row;
+			typedef typename Row::value_type E;
+			typedef typename E::first_type E1;
+
+			S.resize(_rownb, _colnb);
+			for (size_t i = 0 ; i < _rownb ; ++i) {
+				Row & row = S.refRep()[i];
+				row.resize((size_t)(_start[i+1]-_start[i]));
+				for (index_t k = _start[i] ; k < _start[i+1] ; ++k)
+					row[(size_t)(k-_start[i])] = E((E1)_colid[k], _data[k]);
+			}
+			return S;
+		}
+
+		template<class _Storage>
+		SparseMatrix<Field,_Storage> & exporte(SparseMatrix<Field,_Storage> & S) const
+		{
+			return exporte(S, _Storage());
+		}
+
+	private :
+		MappedCSR(const Self_t &);
+		Self_t & operator=(const Self_t &);
+
+		const MappedCSRHeader & header() const
+		{
+			return *reinterpret_cast<const MappedCSRHeader*>(_map);
+		}
+
+		std::string check(const MappedCSRHeader & h) const
+		{
+			if (! MappedCSRHeader::sameMagic(h.magic))
+				return "not a binary CSR file";
+			if (h.version != MappedCSRHeader::currentVersion)
+				return "unsupported binary CSR version";
+			if (h.endian != MappedCSRHeader::endianMark)
+				return "binary CSR file of another endianness";
+			if (h.indexSize != sizeof(index_t))
+				return "binary CSR file with another index width";
+			if (h.elementSize != sizeof(Element))
+				return "binary CSR file with another element width";
+			if (h.cardinalityOffset + h.cardinalityWords*sizeof(uint64_t) > _length)
+				return "truncated binary CSR file";
+			const uint64_t * w = reinterpret_cast<const uint64_t*>(_map + h.cardinalityOffset);
+			integer c(0), f;
+			for (size_t k = (size_t)h.cardinalityWords ; k-- > 0 ; )
+				c = (c << 64) + integer(w[k]);
+			field().cardinality(f);
+			if (c != f)
+				return "binary CSR file over another field";
+			if ((h.startOffset + (h.rowdim+1)*sizeof(index_t) > _length)
+			    || (h.colidOffset + h.nbnz*sizeof(index_t) > _length)
+			    || (h.dataOffset + h.nbnz*sizeof(Element) > _length))
+				return "truncated binary CSR file";
+			return "";
+		}
+
+		//! row starts from 0 to nnz, non decreasing, column indices below the column dimension
+		bool consistent() const
+		{
+			if (_start[0] != 0 || (size_t)_start[_rownb] != _nbnz)
+				return false;
+			for (size_t i = 0 ; i < _rownb ; ++i)
+				if (_start[i] > _start[i+1])
+					return false;
+			for (size_t k = 0 ; k < _nbnz ; ++k)
+				if ((size_t)_colid[k] >= _colnb)
+					return false;
+			return true;
+		}
+
+		const Field   * _field ;
+		const char    * _map ;
+		size_t          _length ;
+		size_t          _rownb ;
+		size_t          _colnb ;
+		size_t          _nbnz ;
+		const index_t * _start ;
+		const index_t * _colid ;
+		const Element * _data ;
+	};
+
+	/*! Writes a binary CSR file, to be mapped by MappedCSR.
+	 * @param filename output file
+	 * @param A matrix
+	 */
+	template<class _Field>
+	void writeMappedCSR(const std::string & filename,
+			    const SparseMatrix<_Field, SparseMatrixFormat::CSR> & A)
+	{
+		typedef typename _Field::Element Element;
+		static_assert(std::is_trivially_copyable<Element>::value,
+			      "binary CSR files need trivially copyable elements");
+
+		const uint64_t align = LINBOX_MAPPED_CSR_ALIGN;
+		MappedCSRHeader h;
+		std::memset(&h, 0, sizeof(h));
+		std::memcpy(h.magic, "LBXCSR\0\0", 8);
+		h.version     = MappedCSRHeader::currentVersion;
+		h.endian      = MappedCSRHeader::endianMark;
+		h.indexSize   = (uint32_t)sizeof(index_t);
+		h.elementSize = (uint32_t)sizeof(Element);
+		h.rowdim      = A.rowdim();
+		h.coldim      = A.coldim();
+		h.nbnz        = A.size();
+		integer c;
+		A.field().cardinality(c);
+		std::vector<uint64_t> w;
+		for (const integer two64 = integer(1) << 64 ; c > 0 ; c /= two64)
+			w.push_back((uint64_t)(c % two64));
+		h.cardinalityWords  = w.size();
+		h.cardinalityOffset = sizeof(h);
+		h.startOffset = (h.cardinalityOffset + w.size()*sizeof(uint64_t) + align-1)/align*align;
+		h.colidOffset = (h.startOffset + (h.rowdim+1)*sizeof(index_t) + align-1)/align*align;
+		h.dataOffset  = (h.colidOffset + h.nbnz*sizeof(index_t) + align-1)/align*align;
+
+		std::ofstream os(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (! os)
+			throw LinboxError("LinBox ERROR: cannot write binary CSR file " + filename);
+
+		const char pad[LINBOX_MAPPED_CSR_ALIGN] = { 0 };
+		uint64_t pos = 0;
+		os.write(reinterpret_cast<const char*>(&h), sizeof(h)); pos += sizeof(h);
+		os.write(reinterpret_cast<const char*>(w.data()), (std::streamsize)(w.size()*sizeof(uint64_t)));
+		pos += w.size()*sizeof(uint64_t);
+
+		os.write(pad, (std::streamsize)(h.startOffset-pos)); pos = h.startOffset;
+		for (size_t i = 0 ; i <= A.rowdim() ; ++i) {
+			const index_t s = A.getStart(i);
+			os.write(reinterpret_cast<const char*>(&s), sizeof(index_t));
+		}
+		pos += (h.rowdim+1)*sizeof(index_t);
+
+		os.write(pad, (std::streamsize)(h.colidOffset-pos)); pos = h.colidOffset;
+		for (size_t k = 0 ; k < A.size() ; ++k) {
+			const index_t j = (index_t)A.getColid(k);
+			os.write(reinterpret_cast<const char*>(&j), sizeof(index_t));
+		}
+		pos += h.nbnz*sizeof(index_t);
+
+		os.write(pad, (std::streamsize)(h.dataOffset-pos));
+		for (size_t k = 0 ; k < A.size() ; ++k)
+			os.write(reinterpret_cast<const char*>(&A.getData(k)), sizeof(Element));
+
+		if (! os)
+			throw LinboxError("LinBox ERROR: cannot write binary CSR file " + filename);
+	}
+
+} // namespace LinBox
+
+#endif // __LINBOX_sparse_matrix_sparse_mapped_csr_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -38,6 +38,11 @@
 #define LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD 10
 #endif
 
+// Number of residues reconstructed at once by the vector CRA builders.
+#if !defined(LINBOX_DEFAULT_CRA_BATCH_SIZE)
+#define LINBOX_DEFAULT_CRA_BATCH_SIZE 32u
+#endif
+
 // Used to decide which method to use when using Method::Auto on a Blackbox or Sparse matrix.
 #if !defined(LINBOX_USE_BLACKBOX_THRESHOLD)
 #define LINBOX_USE_BLACKBOX_THRESHOLD 1000u
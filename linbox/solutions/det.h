@@ -37,6 +37,8 @@
 #include "linbox/vector/blas-vector.h"
 
 #include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/matrixdomain/bit-matrix-domain.h"
+#include "linbox/matrix/sliced3/sliced-prime-domain.h"
 #include "linbox/algorithms/blackbox-container.h"
 #include "linbox/algorithms/blackbox-container-symmetric.h"
 #include "linbox/algorithms/massey-domain.h"
@@ -337,13 +339,46 @@ namespace LinBox
 		linbox_check (A.coldim () == A.rowdim ());
 
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> BMD(F);
-		d= BMD.detInPlace(B);
+		// tiny primes and large orders : bitsliced elimination
+		if (!slicedDet(d, F, B)) {
+			BlasMatrixDomain<Field> BMD(F);
+			d= BMD.detInPlace(B);
+		}
 		commentator().stop ("done", NULL, "blasdet");
 
 		return d;
 	}
 
+	// the det over GF2 on bit packed matrices, M4RI elimination.
+	inline GF2::Element &detInPlace (GF2::Element                      &d,
+					 BitMatrix                         &A,
+					 const RingCategories::ModularTag  &tag,
+					 const Method::DenseElimination    &Meth)
+	{
+		commentator().start ("Dense Elimination Determinant over GF2", "bitdet");
+		BitMatrixDomain BMD(A.field());
+		BMD.detInPlace(d, A);
+		commentator().stop ("done", NULL, "bitdet");
+		return d;
+	}
+
+	inline GF2::Element &detInPlace (GF2::Element                      &d,
+					 BitMatrix                         &A,
+					 const RingCategories::ModularTag  &tag,
+					 const Method::Elimination         &Meth)
+	{
+		return detInPlace(d, A, tag, Method::DenseElimination(Meth));
+	}
+
+	inline GF2::Element &det (GF2::Element                      &d,
+				  const BitMatrix                   &A,
+				  const RingCategories::ModularTag  &tag,
+				  const Method::DenseElimination    &Meth)
+	{
+		BitMatrix B(A);
+		return detInPlace(d, B, tag, Meth);
+	}
+
 	template <class Blackbox>
 	typename Blackbox::Field::Element &det (typename Blackbox::Field::Element	&d,
 						const Blackbox  			&A,
@@ -362,6 +397,7 @@ namespace LinBox
 			for(size_t j = 0; j < A.coldim(); ++j)
 				A1.setEntry(i,j,getEntry(tmp, A, i, j));
 		GaussDomain<Field> GD ( A1.field() );
+		GD.setDenseSwitch (Meth.denseSwitch);
 		GD.detInPlace (d, A1, Meth.pivotStrategy);
 		commentator().stop ("done", NULL, "SEDet");
 		return d;
@@ -381,6 +417,7 @@ namespace LinBox
 		// We make a copy as these data will be destroyed
 		SparseMatrix<Field, SparseMatrixFormat::SparseSeq> A1 (A);
 		GaussDomain<Field> GD ( A.field() );
+		GD.setDenseSwitch (Meth.denseSwitch);
 		GD.detInPlace (d, A1, Meth.pivotStrategy);
 		commentator().stop ("done", NULL, "SEdet");
 		return d;
@@ -396,6 +433,7 @@ namespace LinBox
 			throw LinboxError("LinBox ERROR: matrix must be square for determinant computation\n");
 		commentator().start ("Sparse Elimination Determinant in place", "SEDetin");
 		GaussDomain<Field> GD ( A.field() );
+		GD.setDenseSwitch (Meth.denseSwitch);
 		GD.detInPlace (d, A, Meth.pivotStrategy);
 		commentator().stop ("done", NULL, "SEdetin");
 		return d;
@@ -504,8 +542,10 @@ namespace LinBox
 		commentator().start ("Determinant", "detInPlace");
 		linbox_check (A.coldim () == A.rowdim ());
 
-		BlasMatrixDomain<Field> BMD(F);
-		d= BMD.detInPlace(static_cast<BlasMatrix<Field>& > (A));
+		if (!slicedDet(d, F, A)) {
+			BlasMatrixDomain<Field> BMD(F);
+			d= BMD.detInPlace(static_cast<BlasMatrix<Field>& > (A));
+		}
 		commentator().stop ("done", NULL, "detInPlace");
 
 		return d;
@@ -577,8 +617,15 @@ namespace LinBox
 
 		//  will call regular cra if C=0
 #ifdef __LINBOX_HAVE_MPI
-		ChineseRemainderDistributed< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, C);
-		cra(dd, iteration, genprime);
+		if (!C) C = Meth.pCommunicator;
+		if (Meth.dispatch == Dispatch::Combined) {
+			ChineseRemainderCombined< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, C);
+			cra(dd, iteration, genprime);
+		}
+		else {
+			ChineseRemainderDistributed< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, C);
+			cra(dd, iteration, genprime);
+		}
 		if(!C || C->rank() == 0){
 			A.field().init(d, dd); // convert the result from integer to original type
 			commentator().stop ("done", NULL, "det");
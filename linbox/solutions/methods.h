@@ -176,6 +176,9 @@ namespace LinBox {
     enum class PivotStrategy {
         None,
         Linear,
+        Parallel, //!< Sets of independent pivots, eliminated in parallel (sparse elimination).
+        Markowitz, //!< Fill reducing column pre-ordering, then Markowitz pivots (sparse elimination).
+        Structured, //!< Singleton and doubleton removal, then bit packed rows as they fill in (sparse elimination over GF2 only, LinboxError otherwise).
     };
 
     /**
@@ -215,6 +218,7 @@ namespace LinBox {
 
         // ----- For Elimination-based methods.
         PivotStrategy pivotStrategy = PivotStrategy::Linear;
+        bool denseSwitch = true; //!< Whether sparse elimination may finish dense once the active submatrix fills in (finite fields).
 
         // ----- For Dixon method.
         // @fixme SingularSolutionType::Deterministic fails with Dense Dixon
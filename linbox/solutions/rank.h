@@ -45,6 +45,8 @@
 #include "linbox/algorithms/whisart_trace.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/matrixdomain/blas-matrix-domain.h"
+#include "linbox/matrix/matrixdomain/bit-matrix-domain.h"
+#include "linbox/matrix/sliced3/sliced-prime-domain.h"
 
 #include "linbox/vector/vector-traits.h"
 #include "linbox/solutions/trace.h"
@@ -423,8 +423,11 @@ namespace LinBox
 		linbox_check( a == b );
 		linbox_check( a < LinBox::BlasBound);
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> D(F);
-		r = D.rankInPlace(B);
+		// tiny primes and large orders : bitsliced elimination
+		if (!slicedRank(r, F, B)) {
+			BlasMatrixDomain<Field> D(F);
+			r = D.rankInPlace(B);
+		}
 		commentator().stop ("done", NULL, "blasrank");
 		return r;
 	}
@@ -586,11 +589,11 @@ namespace LinBox { /*  rankInPlace */
 	/// specialization to \f$ \mathbf{F}_2 \f$
 	inline size_t &rankInPlace (size_t                       &r,
 				      GaussDomain<GF2>::Matrix            &A,
-				      const Method::SparseElimination     &)//M
+				      const Method::SparseElimination     &M)
 	{
 		commentator().start ("Sparse Elimination Rank over GF2", "serankmod2");
 		GaussDomain<GF2> GD ( A.field() );
-		GD.rankInPlace (r, A, PivotStrategy::Linear);
+		GD.rankInPlace (r, A, M.pivotStrategy);
 		commentator().stop ("done", NULL, "serankmod2");
 		return r;
 	}
@@ -604,6 +607,39 @@ namespace LinBox { /*  rankInPlace */
 		return rankInPlace(r, A, M);
 	}
 
+	/// specialization to \f$ \mathbf{F}_2 \f$, bit packed dense matrices (M4RI).
+	inline size_t &rankInPlace (size_t                       &r,
+				      BitMatrix                           &A,
+				      const RingCategories::ModularTag    &,//tag
+				      const Method::DenseElimination      &)//M
+	{
+		commentator().start ("Dense Elimination Rank over GF2", "derankmod2");
+		BitMatrixDomain BMD ( A.field() );
+		r = BMD.rankInPlace (A);
+		commentator().stop ("done", NULL, "derankmod2");
+		return r;
+	}
+
+	/// specialization to \f$ \mathbf{F}_2 \f$
+	inline size_t &rank (size_t                       &r,
+			     const BitMatrix                     &A,
+			     const RingCategories::ModularTag    &tag,
+			     const Method::DenseElimination      &M)
+	{
+		BitMatrix B(A);
+		return rankInPlace(r, B, tag, M);
+	}
+
+	/// specialization to \f$ \mathbf{F}_2 \f$, A is packed in a BitMatrix.
+	inline size_t &rank (size_t                       &r,
+			     const GaussDomain<GF2>::Matrix      &A,
+			     const RingCategories::ModularTag    &tag,
+			     const Method::DenseElimination      &M)
+	{
+		BitMatrix B(A);
+		return rankInPlace(r, B, tag, M);
+	}
+
 
 	/// A is modified.
 	template <class Field>
@@ -615,8 +651,10 @@ namespace LinBox { /*  rankInPlace */
 
 		commentator().start ("BlasBB Rank", "blasbbrank");
 		const Field F = A.field();
-		BlasMatrixDomain<Field> D(F);
-		r = D.rankInPlace(static_cast< BlasMatrix<Field>& >(A));
+		if (!slicedRank(r, F, A)) {
+			BlasMatrixDomain<Field> D(F);
+			r = D.rankInPlace(static_cast< BlasMatrix<Field>& >(A));
+		}
 		commentator().stop ("done", NULL, "blasbbrank");
 		return r;
 	}
@@ -653,6 +691,7 @@ namespace LinBox { /*  rankInPlace */
 	{
 		commentator().start ("Sparse Elimination Rank", "serank");
 		GaussDomain<typename Blackbox::Field> GD (A.field());
+		GD.setDenseSwitch (M.denseSwitch);
 		GD.rankInPlace( r, A, M.pivotStrategy);
 		commentator().stop ("done", NULL, "serank");
 		return r;
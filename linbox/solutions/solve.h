@@ -76,6 +76,7 @@ namespace LinBox {
      * - Method::CRA
      *      - IntegerTag
      *      |   - Dispatch::Distributed > `ChineseRemainderDistributed`
+     *      |   - Dispatch::Combined    > `ChineseRemainderCombined`
      *      |   - Otherwise             > `RationalChineseRemainder`
      *      - Otherwise > Error
      * - Method::Dixon
@@ -97,7 +97,10 @@ namespace LinBox {
     /**
      * \brief Solve specialization with Chinese Remainder Algorithm method for an Integer or Rational tags.
      *
-     * If a Dispatch::Distributed is used, please note that the result will only be set on the master node.
+     * If a Dispatch::Distributed or Dispatch::Combined is used,
+     * please note that the result will only be set on the master node.
+     * With Dispatch::Combined, each node computes its primes with all its threads
+     * and sends partial reconstructions to the master.
      */
     template <class IntVector, class Matrix, class Vector, class IterationMethod>
     inline void solve(IntVector& xNum, typename IntVector::Element& xDen, const Matrix& A, const Vector& b,
@@ -128,7 +131,7 @@ namespace LinBox {
         // Declare communicator if none was yet.
         //
 
-        if (m.dispatch == Dispatch::Distributed && m.pCommunicator == nullptr) {
+        if ((m.dispatch == Dispatch::Distributed || m.dispatch == Dispatch::Combined) && m.pCommunicator == nullptr) {
             Method::CRA<IterationMethod> newM(m);
             Communicator communicator(nullptr, 0);
             newM.pCommunicator = &communicator;
@@ -179,6 +182,10 @@ namespace LinBox {
             LinBox::ChineseRemainderDistributed<CRAAlgorithm> cra(hadamardLogBound, m.pCommunicator);
             cra(num, den, iteration, primeGenerator);
         }
+        else if (dispatch == Dispatch::Combined) {
+            LinBox::ChineseRemainderCombined<CRAAlgorithm> cra(hadamardLogBound, m.pCommunicator);
+            cra(num, den, iteration, primeGenerator);
+        }
 #endif
         else {
             throw LinBox::NotImplementedYet("Integer CRA Solve with specified dispatch type is not implemented yet.");
@@ -201,7 +208,7 @@ namespace LinBox {
             }
             R.init(xDen, den);
 
-            // @note During Dispatch::Distributed, we do not dispatch the result to all other nodes,
+            // @note During Dispatch::Distributed or Combined, we do not dispatch the result to all other nodes,
             // to prevent unnecessary broadcast, as the doc says.
 
             commentator().stop("solve.cra.integer");
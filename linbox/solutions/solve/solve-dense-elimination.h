@@ -24,6 +24,8 @@
 
 #include <linbox/matrix/dense-matrix.h>
 #include <linbox/matrix/sparse-matrix.h>
+#include <linbox/matrix/matrixdomain/bit-matrix-domain.h>
+#include <linbox/matrix/sliced3/sliced-prime-domain.h>
 #include <linbox/solutions/methods.h>
 
 namespace LinBox {
@@ -55,11 +57,34 @@ namespace LinBox {
 
         commentator().start("solve.dense-elimination.modular.dense");
 
-        PLUQMatrix<Field> PLUQ(A);
-        PLUQ.left_solve(x, b);
+        // Tiny primes and large orders go to bitsliced elimination,
+        // inconsistent systems fall back to PLUQ.
+        if (!slicedSolve(x, A.field(), A, b)) {
+            PLUQMatrix<Field> PLUQ(A);
+            PLUQ.left_solve(x, b);
+        }
 
         commentator().stop("solve.dense-elimination.modular.dense");
 
         return x;
     }
+
+    /**
+     * \brief Solve specialisation for DenseElimination on bit packed matrices over GF2.
+     */
+    template <class Vector>
+    Vector& solve(Vector& x, const BitMatrix& A, const Vector& b, const RingCategories::ModularTag& tag,
+                  const Method::DenseElimination& m)
+    {
+        linbox_check((A.coldim() == x.size()) && (A.rowdim() == b.size()));
+
+        commentator().start("solve.dense-elimination.modular.bit-matrix");
+
+        BitMatrixDomain BMD(A.field());
+        BMD.solve(x, A, b);
+
+        commentator().stop("solve.dense-elimination.modular.bit-matrix");
+
+        return x;
+    }
 }
@@ -74,7 +74,8 @@ namespace LinBox {
 
         using Field = typename SparseMatrix<MatrixArgs...>::Field;
         GaussDomain<Field> gaussDomain(A.field());
-        gaussDomain.solveInPlace(x, A, b);
+        gaussDomain.setDenseSwitch(m.denseSwitch);
+        gaussDomain.solveInPlace(x, A, b, m.pivotStrategy);
 
         commentator().stop("solve-in-place.sparse-elimination.any.sparse");
 
@@ -30,6 +30,7 @@
 #define __LINBOX_valence_H
 
 #include "linbox/blackbox/transpose.h"
+#include "linbox/blackbox/compose.h"
 
 #include "linbox/solutions/minpoly.h"
 
@@ -100,12 +101,29 @@ namespace LinBox
 #include "linbox/ring/modular.h"
 #include "linbox/algorithms/cra-domain.h"
 #include "linbox/algorithms/cra-builder-single.h"
+#ifdef __LINBOX_USE_OPENMP
+#include "linbox/algorithms/cra-domain-omp.h"
+#endif
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
 
 namespace LinBox
 {
 
+	namespace Protected {
+		// The integer valences are a CRA of modular ones. With OpenMP,
+		// the iterations are tasks: of the enclosing team when called
+		// from a parallel region (as in smithValence), else of a new one.
+		// The iterations report to the commentator, which is not thread
+		// safe: define DISABLE_COMMENTATOR, as the smithvalence tools do.
+		template <class Field>
+#ifdef __LINBOX_USE_OPENMP
+		using ValenceCRA = ChineseRemainderOMP< CRABuilderEarlySingle<Field> >;
+#else
+		using ValenceCRA = ChineseRemainder< CRABuilderEarlySingle<Field> >;
+#endif
+	}
+
 	template <class Blackbox, class MyMethod>
 	struct IntegerModularValence {
 		const Blackbox &A;
@@ -136,6 +154,40 @@ namespace LinBox
 		}
 	};
 
+	/* Valence of A^T A (ata) or of A A^T modulo a prime :
+	 * A is reduced once, the transpose and the product are views on it.
+	 */
+	template <class Blackbox, class MyMethod>
+	struct IntegerModularSquarizedValence {
+		const Blackbox &A;
+		const MyMethod &M;
+		const bool ata;
+
+		IntegerModularSquarizedValence(const Blackbox& b, const MyMethod& n, bool t) :
+			A(b), M(n), ata(t)
+		{}
+
+		template<typename Field>
+		IterationResult operator()(typename Field::Element& v, const Field& F) const
+		{
+			commentator().start ("Givaro::Modular squarized Valence", "Msvalence");
+			typedef typename Blackbox::template rebind<Field>::other FBlackbox;
+
+			FBlackbox Ap(A, F);
+			Transpose<FBlackbox> T(&Ap);
+			if (ata) {
+				Compose< Transpose<FBlackbox>, FBlackbox > C (&T, &Ap);
+				valence( v, C, M);
+			}
+			else {
+				Compose< FBlackbox, Transpose<FBlackbox> > C (&Ap, &T);
+				valence( v, C, M);
+			}
+			commentator().stop ("done", NULL, "Msvalence");
+			return IterationResult::CONTINUE;
+		}
+	};
+
 	template <class Blackbox, class MyMethod>
 	typename Blackbox::Field::Element &valence (typename Blackbox::Field::Element &V,
 						    const Blackbox                     &A,
@@ -149,7 +201,7 @@ namespace LinBox
 		typedef Givaro::ModularBalanced<double> Field;
 #endif
                 PrimeIterator<IteratorCategories::HeuristicTag> genprime(FieldTraits<Field>::bestBitSize(A.rowdim()));
-		ChineseRemainder< CRABuilderEarlySingle<Field> > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
+		Protected::ValenceCRA<Field> cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
 
 		IntegerModularValence<Blackbox,MyMethod> iteration(A, M);
 		cra(V, iteration, genprime);
@@ -158,6 +210,47 @@ namespace LinBox
 	}
 
 
+    // Valence of A^T A (ata) or of A A^T
+    template<class Blackbox, class DomainCategory, class MyMethod>
+    typename Blackbox::Field::Element &squarizedValence(
+        typename Blackbox::Field::Element	&val_A,
+        const Blackbox						&A,
+        bool								ata,
+        const DomainCategory				&tag,
+        const MyMethod						&M) {
+        Transpose<Blackbox> T(&A);
+        if (ata) {
+            Compose< Transpose<Blackbox>, Blackbox > C (&T, &A);
+            return valence(val_A, C, M);
+        } else {
+            Compose< Blackbox, Transpose<Blackbox> > C (&A, &T);
+            return valence(val_A, C, M);
+        }
+    }
+
+    // Over the integers, each prime of the CRA reduces A only once
+    template<class Blackbox, class MyMethod>
+    typename Blackbox::Field::Element &squarizedValence(
+        typename Blackbox::Field::Element	&V,
+        const Blackbox						&A,
+        bool								ata,
+        const RingCategories::IntegerTag	&tag,
+        const MyMethod						&M) {
+		commentator().start ("Integer squarized Valence", "Isvalence");
+#if __LINBOX_SIZEOF_LONG == 8
+		typedef Givaro::Modular<int64_t> Field;
+#else
+		typedef Givaro::ModularBalanced<double> Field;
+#endif
+                PrimeIterator<IteratorCategories::HeuristicTag> genprime(FieldTraits<Field>::bestBitSize(A.coldim()));
+		Protected::ValenceCRA<Field> cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
+
+		IntegerModularSquarizedValence<Blackbox,MyMethod> iteration(A, M, ata);
+		cra(V, iteration, genprime);
+		commentator().stop ("done", NULL, "Isvalence");
+		return V;
+    }
+
     template<class Blackbox>
     typename Blackbox::Field::Element &squarizeValence(
         typename Blackbox::Field::Element	&val_A,
@@ -176,16 +269,13 @@ namespace LinBox
                 else
                     method=1;
             }
-            Transpose<Blackbox> T(&A);
-            if (method==2) {
-                Compose< Transpose<Blackbox>, Blackbox > C (&T, &A);
-                std::clog << "A^T A is " << C.rowdim() << " by " << C.coldim() << std::endl;
-                return valence(val_A, C);
-            } else {
-                Compose< Blackbox, Transpose<Blackbox> > C (&A, &T);
-                std::clog << "A A^T is " << C.rowdim() << " by " << C.coldim() << std::endl;
-                return valence(val_A, C);
-            }
+            if (method==2)
+                std::clog << "A^T A is " << A.coldim() << " by " << A.coldim() << std::endl;
+            else
+                std::clog << "A A^T is " << A.rowdim() << " by " << A.rowdim() << std::endl;
+            return squarizedValence(val_A, A, method==2,
+                                    typename FieldTraits<typename Blackbox::Field>::categoryTag(),
+                                    Method::Auto());
         }
     }
 
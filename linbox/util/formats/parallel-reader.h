@@ -0,0 +1,649 @@
+/* linbox/util/formats/parallel-reader.h
+ * Copyright (C) 2014 the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file util/formats/parallel-reader.h
+ * @ingroup util
+ * @brief Parallel reader of SMS and MatrixMarket coordinate files.
+ *
+ * The file is mapped and cut into line aligned chunks, parsed
+ * concurrently (OpenMP) without iostreams, and the triples go
+ * straight to CSR. When an entry is given several times, the last
+ * one wins.
+ * Gzipped files (zlib) are inflated by a separate thread, block by
+ * block, while the previous block is parsed.
+ * Other formats (and MatrixMarket arrays) go through MatrixStream.
+ */
+
+#ifndef __LINBOX_util_formats_parallel_reader_H
+#define __LINBOX_util_formats_parallel_reader_H
+
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/error.h"
+#include "linbox/util/matrix-stream.h"
+#include "linbox/matrix/sparse-matrix.h"
+
+#ifdef __LINBOX_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+//! bytes under which a text is parsed by a single thread
+#ifndef LINBOX_READER_CHUNK
+#define LINBOX_READER_CHUNK (1UL<<20)
+#endif
+
+//! size of the blocks inflated from a gzipped file
+#ifndef LINBOX_READER_GZBLOCK
+#define LINBOX_READER_GZBLOCK (1UL<<24)
+#endif
+
+namespace LinBox
+{
+
+	/** Parallel reader of sparse matrix files.
+	 * SMS ("m n M" first line, "i j v" lines, "0 0 0" last line) and
+	 * MatrixMarket coordinate (general, symmetric, skew-symmetric,
+	 * pattern) files, possibly gzipped.
+	 * Values are read as 64 bits integers, other values (larger
+	 * integers, rationals, ...) are read by the field.
+	 * Entries zero in the field are dropped.
+	 */
+	template<class _Field>
+	class ParallelSparseReader {
+	public:
+		typedef _Field                     Field;
+		typedef typename Field::Element  Element;
+
+		ParallelSparseReader (const Field & F) :
+			_field(&F), _m(0), _n(0)
+		{}
+
+		const Field & field () const { return *_field; }
+
+		/*! Reads a file in a CSR matrix.
+		 * @param A matrix, resized
+		 * @param filename SMS or MatrixMarket file, possibly gzipped
+		 */
+		SparseMatrix<Field, SparseMatrixFormat::CSR> &
+		read (SparseMatrix<Field, SparseMatrixFormat::CSR> & A, const std::string & filename)
+		{
+			_chunks.clear ();
+			if (isGzip (filename))
+				readGzip (filename);
+			else
+				readMapped (filename);
+			return buildCSR (A);
+		}
+
+		/*! Reads a file in a sparse matrix, through CSR.
+		 * @param A matrix, resized
+		 * @param filename SMS or MatrixMarket file, possibly gzipped
+		 */
+		template<class _Storage>
+		SparseMatrix<Field, _Storage> &
+		read (SparseMatrix<Field, _Storage> & A, const std::string & filename)
+		{
+			SparseMatrix<Field, SparseMatrixFormat::CSR> T (field ());
+			read (T, filename);
+			A.resize (T.rowdim (), T.coldim ());
+			for (size_t i = 0 ; i < T.rowdim () ; ++i)
+				for (index_t k = T.getStart (i) ; k < T.getEnd (i) ; ++k)
+					A.setEntry (i, T.getColid ((size_t)k), T.getData ((size_t)k));
+			A.finalize ();
+			return A;
+		}
+
+	private:
+		enum Format { UNKNOWN, SMS, MM };
+
+		struct Header {
+			Format format;
+			size_t m, n;
+			bool pattern, symmetric, skew;
+			Header () : format (UNKNOWN), m (0), n (0), pattern (false), symmetric (false), skew (false) {}
+		};
+
+		//! triples of a chunk of text, in the order of the text
+		struct Chunk {
+			std::vector<index_t> row, col;
+			std::vector<Element> val;
+			bool end;   //!< SMS last line met
+			bool bad;   //!< parse error
+			std::exception_ptr error;   //!< thrown while parsing, e.g. by the field
+			Chunk () : end (false), bad (false) {}
+		};
+
+		/* ---- locale free scanning ---- */
+
+		static bool isBlank (char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+		static const char * skipBlanks (const char * p, const char * e)
+		{
+			while (p < e && isBlank (*p)) ++p;
+			return p;
+		}
+
+		static const char * endOfLine (const char * p, const char * e)
+		{
+			const char * q = static_cast<const char*> (std::memchr (p, '\n', (size_t)(e-p)));
+			return q ? q : e;
+		}
+
+		//! decimal unsigned integer, false on overflow or no digit
+		static bool parseUnsigned (const char * & p, const char * e, uint64_t & v)
+		{
+			const char * b = p;
+			v = 0;
+			while (p < e && *p >= '0' && *p <= '9') {
+				if (v > (UINT64_MAX - 9) / 10) return false;
+				v = v * 10 + (uint64_t)(*p - '0');
+				++p;
+			}
+			return p != b;
+		}
+
+		//! value token [p,q) : 64 bits integer, else read by the field
+		void parseValue (Element & x, const char * p, const char * q) const
+		{
+			const char * s = p;
+			bool neg = false;
+			if (s < q && (*s == '-' || *s == '+')) { neg = (*s == '-'); ++s; }
+			uint64_t v;
+			const char * t = s;
+			if (parseUnsigned (t, q, v) && t == q && v <= (uint64_t)INT64_MAX) {
+				field ().init (x, neg ? -(int64_t)v : (int64_t)v);
+				return;
+			}
+			std::istringstream is (std::string (p, q));
+			field ().read (is, x);
+		}
+
+		/* ---- header ---- */
+
+		static bool sameWord (const std::string & s, const char * w)
+		{
+			if (s.size () != std::strlen (w)) return false;
+			for (size_t i = 0 ; i < s.size () ; ++i)
+				if (std::tolower (s[i]) != std::tolower (w[i])) return false;
+			return true;
+		}
+
+		//! whether [b,e) holds the whole header: the first line, and for
+		//! MatrixMarket the comments and the size line
+		static bool wholeHeader (const char * b, const char * e)
+		{
+			const char * l = endOfLine (b, e);
+			if (l == e) return false;
+			if (l-b < 14 || std::strncmp (b, "%%MatrixMarket", 14) != 0)
+				return true;
+			for (const char * p = l+1 ; p < e ; p = l+1) {
+				const char * q = skipBlanks (p, e);
+				l = endOfLine (p, e);
+				if (l == e) return false;
+				if (*q != '%' && *q != '\n') return true;
+			}
+			return false;
+		}
+
+		//! parses the header, returns the position of the first triple, or b if unknown
+		const char * parseHeader (Header & h, const char * b, const char * e) const
+		{
+			const char * p = b;
+			const char * l = endOfLine (p, e);
+			std::string first (p, l);
+			if (first.compare (0, 14, "%%MatrixMarket") == 0) {
+				std::istringstream is (first.substr (14));
+				std::string obj, fmt, typ, sym;
+				is >> obj >> fmt >> typ >> sym;
+				if (! sameWord (obj, "matrix") || ! sameWord (fmt, "coordinate"))
+					return b;
+				h.pattern = sameWord (typ, "pattern");
+				h.symmetric = sameWord (sym, "symmetric") || sameWord (sym, "hermitian");
+				h.skew = sameWord (sym, "skew-symmetric");
+				// comments
+				p = (l < e) ? l+1 : e;
+				while (p < e) {
+					const char * q = skipBlanks (p, e);
+					if (q < e && *q != '%' && *q != '\n') break;
+					l = endOfLine (p, e);
+					p = (l < e) ? l+1 : e;
+				}
+				uint64_t m, n, z;
+				p = skipBlanks (p, e);
+				if (! parseUnsigned (p, e, m)) return b;
+				p = skipBlanks (p, e);
+				if (! parseUnsigned (p, e, n)) return b;
+				p = skipBlanks (p, e);
+				if (! parseUnsigned (p, e, z)) return b;
+				h.m = (size_t)m; h.n = (size_t)n;
+				h.format = MM;
+			}
+			else {
+				uint64_t m, n;
+				p = skipBlanks (p, l);
+				if (! parseUnsigned (p, l, m)) return b;
+				p = skipBlanks (p, l);
+				if (! parseUnsigned (p, l, n)) return b;
+				p = skipBlanks (p, l);
+				if (p == l || std::strchr ("MmIiRrPp", *p) == NULL) return b;
+				p = skipBlanks (p+1, l);
+				if (p != l) return b;
+				h.m = (size_t)m; h.n = (size_t)n;
+				h.format = SMS;
+			}
+			l = endOfLine (p, e);
+			return (l < e) ? l+1 : e;
+		}
+
+		/* ---- triples ---- */
+
+		void parseChunk (Chunk & c, const Header & h, const char * p, const char * e) const
+		{
+			Element x, mx;
+			while (p < e && ! c.end) {
+				const char * l = endOfLine (p, e);
+				const char * q = skipBlanks (p, l);
+				if (q == l || *q == '%') { p = (l < e) ? l+1 : e; continue; }
+
+				uint64_t i, j;
+				if (! parseUnsigned (q, l, i)) { c.bad = true; return; }
+				q = skipBlanks (q, l);
+				if (! parseUnsigned (q, l, j)) { c.bad = true; return; }
+				q = skipBlanks (q, l);
+				if ((h.format == SMS) && (i == 0) && (j == 0)) { c.end = true; return; }
+				if (h.pattern)
+					field ().assign (x, field ().one);
+				else {
+					const char * t = q;
+					while (t < l && ! isBlank (*t)) ++t;
+					if (t == q) { c.bad = true; return; }
+					parseValue (x, q, t);
+				}
+				if ((i == 0) || (j == 0) || (i > h.m) || (j > h.n)) { c.bad = true; return; }
+				--i; --j;
+				// zeros are kept: they may overwrite an earlier entry
+				c.row.push_back ((index_t)i); c.col.push_back ((index_t)j); c.val.push_back (x);
+				if ((h.symmetric || h.skew) && (i != j)) {
+					if (h.skew) field ().neg (mx, x); else field ().assign (mx, x);
+					c.row.push_back ((index_t)j); c.col.push_back ((index_t)i); c.val.push_back (mx);
+				}
+				p = (l < e) ? l+1 : e;
+			}
+		}
+
+		//! parses [b,e), made of whole lines, in parallel
+		void parseText (const Header & h, const char * b, const char * e)
+		{
+			size_t nc = 1;
+#ifdef __LINBOX_USE_OPENMP
+			nc = 4 * (size_t)omp_get_max_threads ();
+#endif
+			nc = std::max ((size_t)1, std::min (nc, (size_t)(e-b) / LINBOX_READER_CHUNK));
+
+			std::vector<const char*> cut (nc+1, e);
+			cut[0] = b;
+			for (size_t t = 1 ; t < nc ; ++t) {
+				const char * p = std::max (cut[t-1], b + (size_t)(e-b) * t / nc);
+				p = endOfLine (p, e);
+				cut[t] = (p < e) ? p+1 : e;
+			}
+
+			const size_t first = _chunks.size ();
+			_chunks.resize (first + nc);
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+			for (long t = 0 ; t < (long)nc ; ++t) {
+				// nothing may leave the parallel region
+				Chunk & c = _chunks[first+(size_t)t];
+				try { parseChunk (c, h, cut[(size_t)t], cut[(size_t)t+1]); }
+				catch (...) { c.error = std::current_exception (); }
+			}
+		}
+
+		//! whether a chunk ended the matrix, throws on parse error
+		bool checkChunks (size_t from) const
+		{
+			for (size_t t = from ; t < _chunks.size () ; ++t) {
+				if (_chunks[t].error)
+					std::rethrow_exception (_chunks[t].error);
+				if (_chunks[t].bad)
+					throw LinboxError ("LinBox ERROR: bad entry in sparse matrix file");
+				if (_chunks[t].end)
+					return true;
+			}
+			return false;
+		}
+
+		/* ---- sources ---- */
+
+		static bool isGzip (const std::string & filename)
+		{
+			std::ifstream is (filename.c_str (), std::ios::binary);
+			unsigned char magic[2] = { 0, 0 };
+			is.read (reinterpret_cast<char*> (magic), 2);
+			return is && magic[0] == 0x1f && magic[1] == 0x8b;
+		}
+
+		void readMapped (const std::string & filename)
+		{
+			int fd = ::open (filename.c_str (), O_RDONLY);
+			if (fd < 0)
+				throw LinboxError ("LinBox ERROR: cannot open sparse matrix file " + filename);
+			struct stat st;
+			if (::fstat (fd, &st) != 0) {
+				::close (fd);
+				throw LinboxError ("LinBox ERROR: cannot open sparse matrix file " + filename);
+			}
+			const size_t length = (size_t)st.st_size;
+			if (length == 0) {
+				::close (fd);
+				throw LinboxError ("LinBox ERROR: empty sparse matrix file " + filename);
+			}
+			void * map = ::mmap (NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close (fd);
+			if (map == MAP_FAILED)
+				throw LinboxError ("LinBox ERROR: cannot map sparse matrix file " + filename);
+			::madvise (map, length, MADV_SEQUENTIAL);
+
+			const char * b = static_cast<const char*> (map);
+			const char * e = b + length;
+			Header h;
+			const char * p = parseHeader (h, b, e);
+			try {
+				if (h.format == UNKNOWN)
+					readStream (std::string (b, e));
+				else {
+					_m = h.m; _n = h.n;
+					parseText (h, p, e);
+					checkChunks (0);
+				}
+			}
+			catch (...) {
+				::munmap (map, length);
+				throw;
+			}
+			::munmap (map, length);
+		}
+
+		//! other formats, sequentially
+		void readStream (const std::string & text)
+		{
+			std::istringstream is (text);
+			MatrixStream<Field> ms (field (), is);
+			ms.getDimensions (_m, _n);
+			_chunks.resize (1);
+			Chunk & c = _chunks[0];
+			size_t i, j;
+			Element x;
+			while (ms.nextTriple (i, j, x)) {
+				c.row.push_back ((index_t)i); c.col.push_back ((index_t)j); c.val.push_back (x);
+			}
+			if (ms.getError () > END_OF_MATRIX)
+				throw LinboxError ("LinBox ERROR: bad sparse matrix file");
+		}
+
+#ifdef __LINBOX_HAVE_ZLIB
+		//! inflated blocks, from the inflating thread to the parser
+		struct BlockQueue {
+			std::mutex lock;
+			std::condition_variable cond;
+			std::deque<std::string> blocks;
+			bool done;
+			bool failed;
+			bool stop;      // the parser gave up
+			BlockQueue () : done (false), failed (false), stop (false) {}
+		};
+
+		static void inflate (gzFile gz, BlockQueue * Q)
+		{
+			for (;;) {
+				std::string block (LINBOX_READER_GZBLOCK, '\0');
+				int r = gzread (gz, &block[0], (unsigned)block.size ());
+				std::unique_lock<std::mutex> guard (Q->lock);
+				// at most two blocks ahead of the parser
+				Q->cond.wait (guard, [Q]{ return Q->blocks.size () < 2 || Q->stop; });
+				if (Q->stop)
+					return;
+				if (r <= 0) {
+					Q->failed = (r < 0);
+					Q->done = true;
+					Q->cond.notify_all ();
+					return;
+				}
+				block.resize ((size_t)r);
+				Q->blocks.push_back (std::string ());
+				Q->blocks.back ().swap (block);
+				Q->cond.notify_all ();
+			}
+		}
+
+		//! runs inflate, then stops and joins it and closes the file, even if the parser throws
+		struct Inflater {
+			gzFile gz;
+			BlockQueue & Q;
+			std::thread thread;
+			Inflater (gzFile g, BlockQueue & q) : gz (g), Q (q), thread (inflate, g, &q) {}
+			~Inflater ()
+			{
+				{
+					std::lock_guard<std::mutex> guard (Q.lock);
+					Q.stop = true;
+				}
+				Q.cond.notify_all ();
+				thread.join ();
+				gzclose (gz);
+			}
+		};
+
+		void readGzip (const std::string & filename)
+		{
+			gzFile gz = gzopen (filename.c_str (), "rb");
+			if (gz == NULL)
+				throw LinboxError ("LinBox ERROR: cannot open sparse matrix file " + filename);
+			gzbuffer (gz, 1U<<20);
+
+			Header h;
+			std::string text;     // unparsed text, from the last whole line on
+			bool header = false, stream = false, ended = false, failed = false;
+			BlockQueue Q;
+			{
+				Inflater inflater (gz, Q);
+				for (;;) {
+					std::string block;
+					{
+						std::unique_lock<std::mutex> guard (Q.lock);
+						Q.cond.wait (guard, [&Q]{ return ! Q.blocks.empty () || Q.done; });
+						if (Q.blocks.empty ()) { failed = failed || Q.failed; break; }
+						block.swap (Q.blocks.front ());
+						Q.blocks.pop_front ();
+						Q.cond.notify_all ();
+					}
+					text.append (block);
+					if (stream) continue;     // whole text for MatrixStream
+
+					const char * b = text.data ();
+					const char * e = b + text.size ();
+					const char * p = b;
+					if (! header) {
+						if (! wholeHeader (b, e)) continue;     // it spans the next block
+						header = true;
+						p = parseHeader (h, b, e);
+						if (h.format == UNKNOWN) { stream = true; continue; }
+						_m = h.m; _n = h.n;
+					}
+					// whole lines only, the last one waits for the next block
+					const char * l = e;
+					while (l > p && l[-1] != '\n') --l;
+					const size_t from = _chunks.size ();
+					parseText (h, p, l);
+					text.erase (0, (size_t)(l - b));
+					try { ended = checkChunks (from); }
+					catch (...) { failed = true; ended = true; }
+					if (ended) break;         // the rest is not read
+				}
+			}
+			if (failed)
+				throw LinboxError ("LinBox ERROR: bad gzipped sparse matrix file " + filename);
+
+			if (! header || stream)
+				readStream (text);
+			else if (! ended && ! text.empty ()) {
+				const size_t from = _chunks.size ();
+				parseText (h, text.data (), text.data () + text.size ());
+				checkChunks (from);
+			}
+		}
+#else
+		void readGzip (const std::string & filename)
+		{
+			throw LinboxError ("LinBox ERROR: gzipped sparse matrix file needs zlib " + filename);
+		}
+#endif
+
+		/* ---- CSR ---- */
+
+		SparseMatrix<Field, SparseMatrixFormat::CSR> &
+		buildCSR (SparseMatrix<Field, SparseMatrixFormat::CSR> & A)
+		{
+			// chunks after the SMS last line are ignored
+			size_t nc = 0;
+			while (nc < _chunks.size () && ! _chunks[nc].end) ++nc;
+			nc = std::min (nc+1, _chunks.size ());
+
+			std::vector<index_t> start (_m+1, 0);
+			for (size_t t = 0 ; t < nc ; ++t)
+				for (size_t k = 0 ; k < _chunks[t].row.size () ; ++k)
+					++start[(size_t)_chunks[t].row[k]+1];
+			for (size_t i = 0 ; i < _m ; ++i)
+				start[i+1] += start[i];
+			const size_t nz = (size_t)start[_m];
+
+			std::vector<index_t> colid (nz), next (start.begin (), start.end ()-1);
+			std::vector<Element> data (nz);
+			for (size_t t = 0 ; t < nc ; ++t) {
+				Chunk & c = _chunks[t];
+				for (size_t k = 0 ; k < c.row.size () ; ++k) {
+					const size_t p = (size_t)next[(size_t)c.row[k]]++;
+					colid[p] = c.col[k];
+					data[p] = c.val[k];
+				}
+				std::vector<index_t> ().swap (c.row);
+				std::vector<index_t> ().swap (c.col);
+				std::vector<Element> ().swap (c.val);
+			}
+
+			// sorted columns in each row, the last write of an entry wins
+			std::vector<index_t> count (_m);
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+			for (long i = 0 ; i < (long)_m ; ++i) {
+				const size_t b = (size_t)start[(size_t)i], e = (size_t)start[(size_t)i+1];
+				bool sorted = true;
+				for (size_t k = b+1 ; k < e && sorted ; ++k)
+					sorted = (colid[k-1] <= colid[k]);
+				if (! sorted) {
+					// stable: the duplicates stay in file order
+					std::vector<std::pair<index_t, Element> > row (e-b);
+					for (size_t k = b ; k < e ; ++k)
+						row[k-b] = std::pair<index_t, Element> (colid[k], data[k]);
+					std::stable_sort (row.begin (), row.end (),
+							  [](const std::pair<index_t, Element> & u, const std::pair<index_t, Element> & v)
+							  { return u.first < v.first; });
+					for (size_t k = b ; k < e ; ++k) {
+						colid[k] = row[k-b].first;
+						data[k] = row[k-b].second;
+					}
+				}
+				size_t w = b;
+				for (size_t k = b ; k < e ; ++k) {
+					if (k+1 < e && colid[k+1] == colid[k]) continue;
+					if (field ().isZero (data[k])) continue;
+					colid[w] = colid[k];
+					data[w] = data[k];
+					++w;
+				}
+				count[(size_t)i] = (index_t)(w-b);
+			}
+			_chunks.clear ();
+
+			// closes the gaps left by duplicates and zeros
+			size_t nbnz = 0;
+			for (size_t i = 0 ; i < _m ; ++i) {
+				const size_t b = (size_t)start[i];
+				start[i] = (index_t)nbnz;
+				for (size_t k = b ; k < b + (size_t)count[i] ; ++k, ++nbnz) {
+					colid[nbnz] = colid[k];
+					data[nbnz] = data[k];
+				}
+			}
+			start[_m] = (index_t)nbnz;
+			colid.resize (nbnz);
+			data.resize (nbnz);
+
+			A.resize (_m, _n, nbnz);
+			A.setStart (start);
+			A.setColid (colid);
+			A.setData (data);
+			A.finalize ();
+			return A;
+		}
+
+		const Field * _field;
+		size_t _m, _n;
+		std::vector<Chunk> _chunks;
+	};
+
+} // namespace LinBox
+
+#endif // __LINBOX_util_formats_parallel_reader_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
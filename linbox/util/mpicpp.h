@@ -34,15 +34,16 @@ namespace LinBox {
         inline int rank() const { return 0; }
         inline bool master() const { return true; }
 
-        template <class T> inline void send(const T& value, int dest) {}
+        template <class T> inline void send(const T& value, int dest, int tag = 0) {}
         template <class T> inline void ssend(const T& value, int dest) {}
-        template <class T> inline void recv(T& value, int src) {}
+        template <class T> inline void recv(T& value, int src, int tag = 0) {}
         template <class T> inline void bcast(T& value, int src) {}
     };
 }
 #else
 
 #include <mpi.h>
+#include <vector>
 
 namespace LinBox {
     /**
@@ -57,6 +58,15 @@ namespace LinBox {
             Multiple = MPI_THREAD_MULTIPLE,     // No restriction.
         };
 
+        /**
+         * Pending non-blocking send.
+         * Owns the serialized data until the send completes.
+         */
+        struct Request {
+            MPI_Request request = MPI_REQUEST_NULL;
+            std::vector<uint8_t> bytes;
+        };
+
     public:
         /**
          * Main (boss) communicator.
@@ -84,11 +94,22 @@ namespace LinBox {
         template <class X> void recv(X* begin, X* end, int dest, int tag);
 
         // whole object communication
-        template <class T> void send(const T& value, int dest);
+        template <class T> void send(const T& value, int dest, int tag = 0);
         template <class T> void ssend(const T& value, int dest);
-        template <class T> void recv(T& value, int src);
+        template <class T> void recv(T& value, int src, int tag = 0);
         template <class T> void bcast(T& value, int src);
 
+        // non-blocking communication
+        // Previous send on the request, if any, is waited for first.
+        template <class T> void isend(const T& value, int dest, Request& request, int tag = 0);
+        void wait(Request& request);
+        bool test(Request& request);
+
+        // Waits for a message and returns its size in bytes, status() describes it.
+        uint64_t probe(int src, int tag);
+        // Whether a message is available, status() describes it if so.
+        bool iprobe(int src, int tag);
+
     protected:
         MPI_Comm _comm;       // MPI's handle for the communicator
         MPI_Status _status;   // status from most recent receive
@@ -94,11 +94,11 @@ namespace LinBox {
 
     // whole object communication
 
-    template <class T> void Communicator::send(const T& value, int dest)
+    template <class T> void Communicator::send(const T& value, int dest, int tag)
     {
         std::vector<uint8_t> bytes;
         uint64_t length = serialize(bytes, value);
-        MPI_Send(bytes.data(), length, MPI_UINT8_T, dest, 0, _comm);
+        MPI_Send(bytes.data(), length, MPI_UINT8_T, dest, tag, _comm);
     }
 
     template <class T> void Communicator::ssend(const T& value, int dest)
@@ -108,17 +108,55 @@ namespace LinBox {
         MPI_Ssend(bytes.data(), length, MPI_UINT8_T, dest, 0, _comm);
     }
 
-    template <class T> void Communicator::recv(T& value, int src)
+    template <class T> void Communicator::recv(T& value, int src, int tag)
     {
         int length = 0;
-        MPI_Probe(src, 0, _comm, &_status);
+        MPI_Probe(src, tag, _comm, &_status);
         MPI_Get_count(&_status, MPI_UINT8_T, &length);
 
+        // src and tag might be wildcards, be sure to receive the probed message
         std::vector<uint8_t> bytes(length);
-        MPI_Recv(bytes.data(), length, MPI_UINT8_T, src, 0, _comm, &_status);
+        MPI_Recv(bytes.data(), length, MPI_UINT8_T, _status.MPI_SOURCE, _status.MPI_TAG, _comm, &_status);
         unserialize(value, bytes);
     }
 
+    // non-blocking communication
+
+    template <class T> void Communicator::isend(const T& value, int dest, Request& request, int tag)
+    {
+        wait(request);
+        request.bytes.clear();
+        uint64_t length = serialize(request.bytes, value);
+        MPI_Isend(request.bytes.data(), length, MPI_UINT8_T, dest, tag, _comm, &request.request);
+    }
+
+    void Communicator::wait(Request& request)
+    {
+        MPI_Wait(&request.request, MPI_STATUS_IGNORE);
+    }
+
+    bool Communicator::test(Request& request)
+    {
+        int flag = 0;
+        MPI_Test(&request.request, &flag, MPI_STATUS_IGNORE);
+        return flag != 0;
+    }
+
+    uint64_t Communicator::probe(int src, int tag)
+    {
+        int length = 0;
+        MPI_Probe(src, tag, _comm, &_status);
+        MPI_Get_count(&_status, MPI_UINT8_T, &length);
+        return length;
+    }
+
+    bool Communicator::iprobe(int src, int tag)
+    {
+        int flag = 0;
+        MPI_Iprobe(src, tag, _comm, &flag, &_status);
+        return flag != 0;
+    }
+
     template <class T> void Communicator::bcast(T& value, int src)
     {
         uint64_t length = 0;